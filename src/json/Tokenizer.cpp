@@ -39,24 +39,54 @@ Tokenizer::Tokenizer(const char *data)
     setData(data);
 }
 
+Tokenizer::Tokenizer(const char *data, size_t size)
+{
+    setData(data, size);
+}
+
 void Tokenizer::setData(const char *data)
 {
+    _block = block_index();
+    _prevPos = 0;
+    _pin = 0;
+    _stream.set(data);
+}
+
+void Tokenizer::setData(const char *data, size_t size)
+{
+    _block = block_index();
+    _prevPos = 0;
+    _pin = 0;
+    _stream.set(data, size);
+}
+
+void Tokenizer::setData(stream_reader reader, size_t capacity)
+{
+    _block = block_index();
     _prevPos = 0;
-    _stream.set((char *)data);
+    _pin = 0;
+    _stream.set(reader, capacity);
 }
 
-std::string Tokenizer::json(int start, int end)
+void Tokenizer::pin(size_t pos)
+{
+    _pin = pos;
+}
+
+void Tokenizer::unpin()
+{
+    _pin = SIZE_MAX;
+}
+
+std::string Tokenizer::json(size_t start, size_t end)
 {
     if (end > _stream.size()){
         end = _stream.size();
     }
-    while (end < 0){
-        end += _stream.size();
-    }
     if (start > end){
         std::swap(start, end);
     }
-    return std::string(_stream.data() + start, end - start);
+    return std::string(_stream.at(start), end - start);
 }
 
 void Tokenizer::setPos(size_t pos)
@@ -82,7 +112,7 @@ size_t Tokenizer::getPos()
 
 bool Tokenizer::isWhiteSpace(const char &c)
 {
-    return (c == ' ' || c == '\n');
+    return (c == ' ' || c == '\n' || c == '\t' || c == '\r');
 }
 
 bool Tokenizer::isNumber(const char &c)
@@ -100,21 +130,28 @@ bool Tokenizer::hasTokens()
     return !_stream.eof();
 }
 
+bool Tokenizer::skipWhiteSpace()
+{
+    // jump straight to the next non-whitespace character
+    size_t pos = _stream.tellg(), offset;
+    do
+    {
+        offset = _stream.offset();
+        pos = skip_whitespace(_stream.data(), pos - offset, _stream.size() - offset) + offset;
+    } while (pos >= _stream.size() && _stream.fill());
+
+    _stream.seekg(pos);
+    return pos < _stream.size();
+}
+
 char Tokenizer::getWithoutWhiteSpace()
 {
-    char c = ' ';
-    while (isWhiteSpace(c))
+    if (isWhiteSpace(_stream.peek()) && !skipWhiteSpace())
     {
-        _stream.get(c);
-        if (!_stream.good())
-        {
-            if (isWhiteSpace(c))
-            {
-                throw std::runtime_error("Tokenizer::getWithoutWhiteSpace(): Run out of tokens");
-            }
-            return c;
-        }
+        throw std::runtime_error("Tokenizer::getWithoutWhiteSpace(): Run out of tokens");
     }
+    char c;
+    _stream.get(c);
     return c;
 }
 
@@ -127,13 +164,15 @@ void Tokenizer::rollBack()
     _stream.seekg(_prevPos);
 }
 
-Token Tokenizer::getToken()
+Token Tokenizer::getToken(size_t longest)
 {
     if (!hasTokens())
     {
         throw std::runtime_error("Tokenizer::getToken(): No more tokens");
     }
     _prevPos = _stream.tellg();
+    // the token can be rolled back, keep it in the buffer
+    _stream.mark(_pin < _prevPos ? _pin : _prevPos);
     char c = getWithoutWhiteSpace();
 
 #if DEBUG_JSON
@@ -141,19 +180,40 @@ Token Tokenizer::getToken()
 #endif
 
     Token token;
+    token.start = _stream.tellg() - 1;
+    token.length = 1;
     switch (c)
     {
     // string reading
     case '"':
+    {
         token.type = TOKEN_TYPE::STRING;
-        // token.value = "";
-        _stream.get(c);
-        while (c != '"')
+        size_t start = _stream.tellg();
+        // the closing quote is the next unescaped quote, usually in the block of the previous token
+        size_t end = _find(start - 1, start, &block_index::quote, longest);
+        if (end >= _stream.size())
         {
-            token.value += c;
-            _stream.get(c);
+            throw std::runtime_error("Tokenizer::getToken(): Unterminated string at: " + std::to_string(_prevPos));
         }
+        token.start = start;
+        token.length = end - start;
+        if (start < _stream.offset())
+        {
+            token.dropped = true;
+        }
+        else if (start >= _block.start)
+        {
+            // backslashes between the quotes
+            uint64_t inside = (~uint64_t(0) << (start - _block.start)) & ((uint64_t(1) << (end - _block.start)) - 1);
+            token.escaped = (_block.backslash & inside) != 0;
+        }
+        else
+        {
+            token.escaped = memchr(_stream.at(start), '\\', token.length) != nullptr;
+        }
+        _stream.seekg(end + 1);
         break;
+    }
     case '{':
         token.type = TOKEN_TYPE::CURLY_OPEN;
         break;
@@ -163,19 +223,22 @@ Token Tokenizer::getToken()
     // Expecting false
     case 'f':
         token.type = TOKEN_TYPE::BOOLEAN;
-        token.value = "false";
-        // std::ios_base
+        token.length = 5;
+        _stream.ensure(_stream.tellg() + 4);
         _stream.seekg(4, stream_pos::cur);
         break;
     // Expecting true
     case 't':
         token.type = TOKEN_TYPE::BOOLEAN;
-        token.value = "true";
+        token.length = 4;
+        _stream.ensure(_stream.tellg() + 3);
         _stream.seekg(3, stream_pos::cur);
         break;
     // Expecting null
     case 'n':
         token.type = TOKEN_TYPE::NULL_TYPE;
+        token.length = 4;
+        _stream.ensure(_stream.tellg() + 3);
         _stream.seekg(3, stream_pos::cur);
         break;
     case '[':
@@ -192,34 +255,17 @@ Token Tokenizer::getToken()
         break;
     // Number / Float parsing
     /*
-    Numbers contain only digits, dots, and minus sign:
-    - . 0 1 2 3 4 5 6 7 8 9
-
-    Number should not start with '.'
+    Number should start with a digit or '-' and ends at the next whitespace or structural
+    character (found in the block masks), the value is decoded by `parse_number()`
     */
     default:
         if (isPartOfNumber(c))
         {
             token.type = TOKEN_TYPE::NUMBER;
 
-            char peek;
-            while (!_stream.eof())
-            {
-                token.value += c;
-
-                peek = _stream.peek();
-
-#if DEBUG_JSON
-                Serial.printf("Curr: %c Peek: %c \n", c, peek);
-#endif
-
-                // look one ahead to see if that's a number
-                if (!(isPartOfNumber(peek) || peek == '.'))
-                {
-                    break;
-                }
-                _stream.get(c);
-            }
+            size_t pos = _find(token.start, token.start + 1, &block_index::boundary);
+            token.length = pos - token.start;
+            _stream.seekg(pos);
         }
         else
         {
@@ -238,4 +284,316 @@ Token Tokenizer::peekToken()
     return token;
 }
 
+char Tokenizer::peekChar()
+{
+    if (!hasTokens() || !skipWhiteSpace())
+    {
+        return 0;
+    }
+    return *_stream.at(_stream.tellg());
+}
+
+void Tokenizer::_index(size_t pos, uint64_t in_string, uint64_t carry)
+{
+    structural_masks masks;
+    size_t offset = _stream.offset(), end = _stream.size();
+    _block.start = pos;
+    _block.length = pos < end ? classify_at(_stream.data(), pos - offset, end - offset, masks) : 0;
+    _block.in_string = in_string;
+    _block.carry = carry;
+
+    // the bytes past the data are padding
+    uint64_t valid = _block.length < SCANNER_BLOCK_SIZE ? (uint64_t(1) << _block.length) - 1 : ~uint64_t(0);
+    uint64_t quote = masks.quote & ~escaped_mask(masks.backslash, carry) & valid;
+    uint64_t strings = prefix_xor(quote) ^ in_string;
+    _block.quote = quote;
+    _block.backslash = masks.backslash & valid;
+    _block.structural = masks.structural & ~strings & valid;
+    _block.boundary = (masks.structural | masks.whitespace) & ~strings & valid;
+    _block.next_in_string = uint64_t(int64_t(strings) >> 63);
+    _block.next_carry = carry;
+}
+
+size_t Tokenizer::_find(size_t from, size_t pos, uint64_t block_index::*mask, size_t keep)
+{
+    if (pos < _block.start || pos >= _block.start + _block.length)
+    {
+        _index(from);
+    }
+    while (true)
+    {
+        size_t shift = pos > _block.start ? pos - _block.start : 0;
+        uint64_t bits = shift < SCANNER_BLOCK_SIZE ? (_block.*mask) >> shift << shift : 0;
+        if (bits)
+        {
+            return _block.start + ctz64(bits);
+        }
+        if (_block.length == SCANNER_BLOCK_SIZE)
+        {
+            _index(_block.start + _block.length, _block.next_in_string, _block.next_carry);
+            continue;
+        }
+        // the block ended with the data when it was indexed, it's indexed again once there is more
+        if (_block.start + _block.length >= _stream.size())
+        {
+            // the scan goes on after the block, a pending escape can't be carried over
+            // so the trailing backslashes are scanned again
+            size_t resume = _block.start + _block.length;
+            while (resume > _block.start && _block.start >= _stream.offset() && *_stream.at(resume - 1) == '\\')
+            {
+                resume--;
+            }
+            if (_block.start >= _stream.offset() && resume > from && resume - from - 1 > keep)
+            {
+                // the data scanned so far is not needed, it's dropped from the streaming buffer
+                uint64_t strings = prefix_xor(_block.quote) ^ _block.in_string;
+                uint64_t in_string = resume > _block.start
+                                         ? uint64_t(int64_t(strings << (SCANNER_BLOCK_SIZE - (resume - _block.start))) >> 63)
+                                         : _block.in_string;
+                _stream.mark(_pin < resume ? _pin : resume);
+                _stream.seekg(resume);
+                if (!_stream.fill())
+                {
+                    return _stream.size();
+                }
+                _index(resume, in_string, 0);
+                continue;
+            }
+            if (!_stream.fill())
+            {
+                return _stream.size();
+            }
+        }
+        if (_block.start < _stream.offset())
+        {
+            // dropped from the streaming buffer, the data from `from` on is kept
+            _index(from);
+        }
+        else
+        {
+            _index(_block.start, _block.in_string, _block.carry);
+        }
+    }
+}
+
+void Tokenizer::skipValue()
+{
+    _prevPos = _stream.tellg();
+    _stream.mark(_pin < _prevPos ? _pin : _prevPos);
+    char c = getWithoutWhiteSpace();
+    size_t start = _stream.tellg() - 1;
+    switch (c)
+    {
+    case '{':
+    case '[':
+        skipContainer();
+        break;
+    case '}':
+    case ']':
+    case ',':
+    case ':':
+        // there is no value
+        _stream.seekg(start);
+        break;
+    default:
+        // strings, numbers and literals, the strings are masked out
+        _stream.seekg(_find(start, start + 1, &block_index::structural, 0));
+        break;
+    }
+}
+
+void Tokenizer::skipContainer()
+{
+    if (_stream.exhausted())
+    {
+        size_t offset = _stream.offset();
+        _stream.seekg(skip_container(_stream.data(), _stream.tellg() - offset, _stream.size() - offset) + offset);
+        return;
+    }
+
+    // streaming source, skip the data chunk by chunk, the skipped part is not kept
+    skip_state state;
+    size_t pos = _stream.tellg();
+    while (true)
+    {
+        size_t offset = _stream.offset(), end = _stream.size();
+        // the state can be carried only between whole blocks
+        size_t limit = _stream.exhausted() ? end : pos + (end - pos) / SCANNER_BLOCK_SIZE * SCANNER_BLOCK_SIZE;
+        size_t next = skip_container(_stream.data(), pos - offset, limit - offset, state) + offset;
+        if (state.depth == 0)
+        {
+            _stream.seekg(next);
+            return;
+        }
+        pos = limit;
+        // keep only the incomplete block for the next round
+        _stream.mark(_pin < pos ? _pin : pos);
+        _stream.seekg(pos);
+        if (!_stream.fill() && pos >= _stream.size())
+        {
+            return;
+        }
+    }
+}
+
+std::string Tokenizer::str(const Token &token)
+{
+    if (token.dropped)
+    {
+        throw std::runtime_error("Tokenizer::str(): The string at " + std::to_string(token.start) +
+                                 " was dropped from the streaming buffer");
+    }
+    if (!token.escaped)
+    {
+        return std::string(_stream.at(token.start), token.length);
+    }
+    std::string value;
+    unescape(_stream.at(token.start), token.length, value);
+    return value;
+}
+
+bool Tokenizer::equals(const Token &token, const char *key, size_t length)
+{
+    if (token.dropped)
+    {
+        return false;
+    }
+    if (token.escaped)
+    {
+        // decoded value is never longer than the raw one
+        return token.length >= length && str(token) == std::string(key, length);
+    }
+    return token.length == length && memcmp(_stream.at(token.start), key, length) == 0;
+}
+
+static int _hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static bool _read_hex4(const char *data, size_t pos, size_t length, uint32_t &code)
+{
+    if (pos + 4 > length)
+    {
+        return false;
+    }
+    code = 0;
+    for (size_t i = pos; i < pos + 4; i++)
+    {
+        int v = _hex_value(data[i]);
+        if (v < 0)
+        {
+            return false;
+        }
+        code = (code << 4) | uint32_t(v);
+    }
+    return true;
+}
+
+static void _append_utf8(uint32_t code, std::string &out)
+{
+    if (code < 0x80)
+    {
+        out += char(code);
+    }
+    else if (code < 0x800)
+    {
+        out += char(0xC0 | (code >> 6));
+        out += char(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        out += char(0xE0 | (code >> 12));
+        out += char(0x80 | ((code >> 6) & 0x3F));
+        out += char(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        out += char(0xF0 | (code >> 18));
+        out += char(0x80 | ((code >> 12) & 0x3F));
+        out += char(0x80 | ((code >> 6) & 0x3F));
+        out += char(0x80 | (code & 0x3F));
+    }
+}
+
+void unescape(const char *data, size_t length, std::string &out)
+{
+    out.reserve(out.size() + length);
+    size_t pos = 0;
+    while (pos < length)
+    {
+        // copy everything up to the next backslash at once
+        const char *backslash = static_cast<const char *>(memchr(data + pos, '\\', length - pos));
+        size_t next = backslash ? size_t(backslash - data) : length;
+        out.append(data + pos, next - pos);
+        if (next + 1 >= length)
+        {
+            if (next < length)
+            {
+                throw std::runtime_error("unescape(): Unterminated escape sequence");
+            }
+            break;
+        }
+
+        char c = data[next + 1];
+        pos = next + 2;
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            out += c;
+            break;
+        case 'b':
+            out += '\b';
+            break;
+        case 'f':
+            out += '\f';
+            break;
+        case 'n':
+            out += '\n';
+            break;
+        case 'r':
+            out += '\r';
+            break;
+        case 't':
+            out += '\t';
+            break;
+        case 'u':
+        {
+            uint32_t code;
+            if (!_read_hex4(data, pos, length, code))
+            {
+                throw std::runtime_error("unescape(): Invalid \\u escape sequence");
+            }
+            pos += 4;
+            // surrogate pair
+            uint32_t low;
+            if (code >= 0xD800 && code <= 0xDBFF && pos + 1 < length &&
+                data[pos] == '\\' && data[pos + 1] == 'u' &&
+                _read_hex4(data, pos + 2, length, low) && low >= 0xDC00 && low <= 0xDFFF)
+            {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                pos += 6;
+            }
+            _append_utf8(code, out);
+            break;
+        }
+        default:
+            throw std::runtime_error(std::string("unescape(): Invalid escape sequence: \\") + c);
+        }
+    }
+}
+
+bool Tokenizer::equals(const Token &token, const std::string &key)
+{
+    return equals(token, key.data(), key.size());
+}
+
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../stream/stream.h"
 #include <stdexcept>
 #include "../options.h"
+#include "scanner.h"
 
 BEGIN_LAZY_JSON_NAMESPACE
 
@@ -20,20 +21,59 @@ enum class TOKEN_TYPE
     NULL_TYPE
 };
 
+/// @brief A view into the tokenized json string, doesn't own any memory.
+/// Use `Tokenizer::str()` to copy the value or `Tokenizer::equals()` to compare it.
 typedef struct
 {
-    std::string value = std::string("");
     TOKEN_TYPE type = TOKEN_TYPE::NULL_TYPE;
-    std::string toString()
-    {
-        return value;
-    }
+    // position of the value in the json string (for strings, the first char after the opening quote)
+    size_t start = 0;
+    size_t length = 0;
+    // the string contains escape sequences
+    bool escaped = false;
+    // the string was longer than allowed and was dropped from the streaming buffer
+    // while being skipped, only its position is known (see `getToken(size_t)`)
+    bool dropped = false;
 } Token;
 
+/// @brief Masks of one block of the json, classified from a position outside of a string, with
+/// the strings resolved. Every token boundary inside the block is found in them with a few bit
+/// operations, so the tokens sharing a block are read without classifying it again.
+typedef struct
+{
+    // absolute position of the first byte, number of indexed bytes (0 if nothing is indexed)
+    size_t start = 0;
+    size_t length = 0;
+    // unescaped quotes
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    // { } [ ] : , outside of strings
+    uint64_t structural = 0;
+    // structural characters and whitespace outside of strings, where numbers and literals end
+    uint64_t boundary = 0;
+    // string and escape state at the start of the block, and right after it
+    uint64_t in_string = 0;
+    uint64_t carry = 0;
+    uint64_t next_in_string = 0;
+    uint64_t next_carry = 0;
+} block_index;
+
 class Tokenizer
 {
     size_t _prevPos;
-    
+    // data from this position on is needed later, see `pin()`
+    size_t _pin;
+    // the block of the last token
+    block_index _block;
+
+    /// @brief Index the block at `pos`, with the string and escape state at `pos`
+    void _index(size_t pos, uint64_t in_string = 0, uint64_t carry = 0);
+
+    /// @brief Position of the first bit of `mask` at or after `pos`, block by block. If `pos` is
+    /// not in the indexed block, the indexing starts again at `from` (outside of a string).
+    /// @param keep bytes after `from` kept in the streaming buffer, the data past them is dropped once scanned
+    /// @return `_stream.size()` if there is none
+    size_t _find(size_t from, size_t pos, uint64_t block_index::*mask, size_t keep = SIZE_MAX);
 
     bool isWhiteSpace(const char &c);
     bool isPartOfNumber(const char &c);
@@ -41,12 +81,30 @@ class Tokenizer
 
 public:
     Tokenizer(const char *data = "");
+    Tokenizer(const char *data, size_t size);
 
-    /// @brief Set the data to be tokenized
+    /// @brief Set the null-terminated data to be tokenized
     void setData(const char *data = "");
 
+    /// @brief Set the data to be tokenized, doesn't have to be null-terminated
+    void setData(const char *data, size_t size);
+
+    /// @brief Tokenize the data pulled through `reader` into a buffer of `capacity` bytes,
+    /// see `pin()` for which data is kept
+    void setData(stream_reader reader, size_t capacity);
+
+    /// @brief Keep the data from `pos` on, for streaming sources everything before the pin
+    /// (and the last token) may be dropped from the buffer. By default the whole input is pinned.
+    void pin(size_t pos);
+
+    /// @brief Nothing has to be kept except the last token, the tokenizer only moves forward
+    void unpin();
+
     /// @brief Get the next token
     char getWithoutWhiteSpace();
+    /// @brief Move past the whitespace at the current position (reading more of the streamed data)
+    /// @return false if there is nothing but whitespace left
+    bool skipWhiteSpace();
 
     /// @brief Check if there are more tokens 
     bool hasTokens();
@@ -64,19 +122,49 @@ public:
     size_t getPos();
 
     /// @brief Get the next token
-    Token getToken();
+    /// @param longest strings with more raw bytes than this can be dropped from the streaming buffer
+    /// while they are scanned (e.g. keys that can't match), their token is `dropped`
+    Token getToken(size_t longest = SIZE_MAX);
+
+    /// @brief Peek the first character of the next token, 0 if there is none
+    char peekChar();
 
     /// @brief Peek the next token
     Token peekToken();
 
-    /// @brief Get the json string from start to end, supports negative end ( = _stream.size() + end),
-    /// so -1 is the last character
-    std::string json(int start = 0, int end = -1);
+    /// @brief Skip the next value without reading it, the tokenizer is left at the structural
+    /// character after it. Objects and lists are skipped with `skipContainer()`, strings, numbers
+    /// and literals end at the next structural character outside of a string.
+    /// The skipped data is dropped from the streaming buffer, so the value doesn't have to fit in it.
+    void skipValue();
+
+    /// @brief Skip the rest of the current object or list, without tokenizing it.
+    /// The tokenizer must be positioned right after the opening bracket.
+    void skipContainer();
+
+    /// @brief Copy the value of the token, escape sequences are decoded
+    /// @throw `std::runtime_error` if the token was dropped
+    std::string str(const Token &token);
+
+    /// @brief Compare the value of the token with `key`, without copying it (unless the token is escaped),
+    /// a dropped token matches nothing
+    bool equals(const Token &token, const char *key, size_t length);
+
+    /// @brief Compare the value of the token with `key`, without copying it
+    bool equals(const Token &token, const std::string &key);
+
+    /// @brief Get the json string from start to end, an end past the available data is cut to it
+    std::string json(size_t start = 0, size_t end = SIZE_MAX);
 
     stream _stream;
 };
 
 
+/// @brief Decode the escape sequences of a json string (without the quotes),
+/// `\uXXXX` sequences (and surrogate pairs) are encoded as UTF-8
+/// @throw `std::runtime_error` on invalid escape sequence
+void unescape(const char *data, size_t length, std::string &out);
+
 #if DEBUG_LAZY_JSON
     std::string verboseTokenType(TOKEN_TYPE type);
 #endif
@@ -0,0 +1,185 @@
+#include "arena.h"
+
+#include <stdlib.h>
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+class _heap_upstream : public arena_upstream
+{
+public:
+    void *allocate(size_t size) override
+    {
+        void *data = malloc(size);
+        if (!data)
+        {
+            throw std::bad_alloc();
+        }
+        return data;
+    }
+
+    void deallocate(void *data, size_t size) override
+    {
+        static_cast<void>(size);
+        free(data);
+    }
+};
+
+class _null_upstream : public arena_upstream
+{
+public:
+    void *allocate(size_t size) override
+    {
+        static_cast<void>(size);
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void *data, size_t size) override
+    {
+        static_cast<void>(data);
+        static_cast<void>(size);
+    }
+};
+
+arena_upstream *heap_upstream()
+{
+    static _heap_upstream upstream;
+    return &upstream;
+}
+
+arena_upstream *null_upstream()
+{
+    static _null_upstream upstream;
+    return &upstream;
+}
+
+#if LAZY_JSON_PMR
+pmr_upstream::pmr_upstream(std::pmr::memory_resource *resource) : _resource(resource) {}
+
+void *pmr_upstream::allocate(size_t size)
+{
+    return _resource->allocate(size, alignof(std::max_align_t));
+}
+
+void pmr_upstream::deallocate(void *data, size_t size)
+{
+    _resource->deallocate(data, size, alignof(std::max_align_t));
+}
+#endif
+
+// the first upstream block is never smaller than this
+#define ARENA_MIN_BLOCK 64
+
+arena::arena(size_t block_size, arena_upstream *upstream)
+    : _upstream(upstream ? upstream : heap_upstream()), _blocks(nullptr), _buffer(nullptr), _buffer_size(0),
+      _next_size(block_size < ARENA_MIN_BLOCK ? ARENA_MIN_BLOCK : block_size),
+      _current(nullptr), _end(nullptr), _used(0) {}
+
+arena::arena(void *buffer, size_t size, arena_upstream *upstream)
+    : arena(size < ARENA_MIN_BLOCK ? ARENA_MIN_BLOCK : size, upstream)
+{
+    _buffer = static_cast<char *>(buffer);
+    _buffer_size = size;
+    _current = _buffer;
+    _end = _buffer + size;
+}
+
+arena::~arena()
+{
+    _free_blocks();
+}
+
+/// @brief Size of the block header, the data after it is aligned for any type
+static inline size_t _header_size()
+{
+    return (sizeof(void *) * 2 + alignof(long double) - 1) & ~(alignof(long double) - 1);
+}
+
+/// @brief Round `ptr` up to the `align` boundary (power of two)
+static inline char *_align(char *ptr, size_t align)
+{
+    return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(ptr) + align - 1) & ~uintptr_t(align - 1));
+}
+
+void *arena::allocate(size_t size, size_t align)
+{
+    char *data = _align(_current, align);
+    if (!_current || data + size > _end)
+    {
+        _grow(size, align);
+        data = _align(_current, align);
+    }
+    _current = data + size;
+    _used += size;
+    return data;
+}
+
+void arena::_grow(size_t size, size_t align)
+{
+    size_t header = _header_size();
+    size_t capacity = _next_size;
+    while (capacity < size + align)
+    {
+        capacity <<= 1;
+    }
+    block *head = static_cast<block *>(_upstream->allocate(header + capacity));
+    head->next = _blocks;
+    head->size = header + capacity;
+    _blocks = head;
+    _next_size = capacity << 1;
+    _current = reinterpret_cast<char *>(head) + header;
+    _end = _current + capacity;
+}
+
+void arena::_free_blocks()
+{
+    while (_blocks)
+    {
+        block *next = _blocks->next;
+        _upstream->deallocate(_blocks, _blocks->size);
+        _blocks = next;
+    }
+}
+
+void arena::reset()
+{
+    // the caller-supplied buffer is used first again
+    if (_buffer || !_blocks)
+    {
+        release();
+        return;
+    }
+    // the newest block is the largest one, the rest is returned
+    block *keep = _blocks;
+    _blocks = keep->next;
+    _free_blocks();
+    keep->next = nullptr;
+    _blocks = keep;
+    _used = 0;
+    _current = reinterpret_cast<char *>(keep) + _header_size();
+    _end = reinterpret_cast<char *>(keep) + keep->size;
+}
+
+void arena::release()
+{
+    _free_blocks();
+    _used = 0;
+    _current = _buffer;
+    _end = _buffer ? _buffer + _buffer_size : nullptr;
+}
+
+size_t arena::used() const
+{
+    return _used;
+}
+
+size_t arena::blocks() const
+{
+    size_t count = 0;
+    for (block *b = _blocks; b; b = b->next)
+    {
+        count++;
+    }
+    return count;
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,174 @@
+#pragma once
+
+/*
+
+## Arena
+
+Monotonic allocator of the parsed nodes (`LazyObject`, `LazyList`, their
+child records and keys) of a single document. Allocating is a pointer bump, nothing
+is freed one by one, the whole arena is dropped at once (`reset()` / `release()`).
+
+The memory comes from a pluggable upstream:
+- `heap_upstream()`, malloc / free (default)
+- a caller-supplied buffer, used before asking the upstream for more,
+  with `null_upstream()` nothing else is ever allocated
+- `pmr_upstream`, any `std::pmr::memory_resource` (C++17)
+
+```cpp
+using namespace lazyjson;
+
+static char buffer[8192];
+extractor ex(json);
+ex.useArena(std::make_shared<arena>(buffer, sizeof(buffer), null_upstream()));
+wrapper list = ex["list"].extract();
+```
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+
+#include "../options.h"
+#include "../namespaces.h"
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#   if __has_include(<memory_resource>)
+#       include <memory_resource>
+#       define LAZY_JSON_PMR 1
+#   endif
+#endif
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Source of the arena blocks
+class arena_upstream
+{
+public:
+    virtual ~arena_upstream() = default;
+
+    /// @throw `std::bad_alloc` if there is no memory left
+    virtual void *allocate(size_t size) = 0;
+    virtual void deallocate(void *data, size_t size) = 0;
+};
+
+/// @brief malloc / free
+arena_upstream *heap_upstream();
+
+/// @brief Never allocates, for arenas limited to a caller-supplied buffer
+arena_upstream *null_upstream();
+
+#if LAZY_JSON_PMR
+/// @brief Blocks allocated from a `std::pmr::memory_resource`, which must outlive the arena
+class pmr_upstream : public arena_upstream
+{
+    std::pmr::memory_resource *_resource;
+
+public:
+    pmr_upstream(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    void *allocate(size_t size) override;
+    void deallocate(void *data, size_t size) override;
+};
+#endif
+
+class arena
+{
+    // header of every upstream block, the memory follows it
+    typedef struct block
+    {
+        block *next;
+        size_t size;
+    } block;
+
+    arena_upstream *_upstream;
+    // upstream blocks, the newest first
+    block *_blocks;
+    char *_buffer;
+    size_t _buffer_size;
+    size_t _next_size;
+    char *_current;
+    char *_end;
+    size_t _used;
+
+    void _grow(size_t size, size_t align);
+    void _free_blocks();
+
+public:
+    /// @param block_size size of the first upstream block, the next ones are twice as large
+    /// @param upstream source of the blocks, `heap_upstream()` if null
+    arena(size_t block_size = LAZY_JSON_ARENA_BLOCK, arena_upstream *upstream = nullptr);
+
+    /// @brief Arena using `buffer` first, the upstream is asked only once it's full.
+    /// The buffer must outlive the arena.
+    arena(void *buffer, size_t size, arena_upstream *upstream = nullptr);
+
+    ~arena();
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    /// @brief Bump-allocate `size` bytes, never freed on its own
+    /// @throw `std::bad_alloc` if the upstream can't provide a new block
+    void *allocate(size_t size, size_t align = alignof(long double));
+
+    /// @brief Drop every allocation, the largest block is kept for reuse
+    /// (unless there is a caller-supplied buffer, which is used first again)
+    void reset();
+
+    /// @brief Drop every allocation and return all of the blocks to the upstream
+    void release();
+
+    /// @brief Number of bytes handed out since the last reset
+    size_t used() const;
+
+    /// @brief Number of upstream blocks held
+    size_t blocks() const;
+};
+
+/// @brief Standard allocator over an arena, the heap (`new` / `delete`) if the arena is null.
+/// Deallocating from the arena does nothing.
+template <class T>
+class arena_allocator
+{
+public:
+    typedef T value_type;
+
+    arena *_arena;
+
+    arena_allocator(arena *memory = nullptr) noexcept : _arena(memory) {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U> &other) noexcept : _arena(other._arena) {}
+
+    T *allocate(size_t n)
+    {
+        if (_arena)
+        {
+            return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *data, size_t n) noexcept
+    {
+        static_cast<void>(n);
+        if (!_arena)
+        {
+            ::operator delete(data);
+        }
+    }
+
+    template <class U>
+    bool operator==(const arena_allocator<U> &other) const noexcept
+    {
+        return _arena == other._arena;
+    }
+
+    template <class U>
+    bool operator!=(const arena_allocator<U> &other) const noexcept
+    {
+        return _arena != other._arena;
+    }
+};
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,154 @@
+#include "binding.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+static LazyType _value_type(const Token &token)
+{
+    switch (token.type)
+    {
+    case TOKEN_TYPE::STRING:
+        return LazyType::STRING;
+    case TOKEN_TYPE::CURLY_OPEN:
+        return LazyType::OBJECT;
+    case TOKEN_TYPE::ARRAY_OPEN:
+        return LazyType::LIST;
+    case TOKEN_TYPE::NUMBER:
+        return LazyType::NUMBER;
+    case TOKEN_TYPE::BOOLEAN:
+        return LazyType::BOOL;
+    case TOKEN_TYPE::NULL_TYPE:
+        return LazyType::NULL_TYPE;
+    default:
+        throw std::runtime_error("binding_reader: Unexpected token / invalid json");
+    }
+}
+
+binding_reader::binding_reader(Tokenizer &tokenizer) : _tokenizer(tokenizer) {}
+
+void binding_reader::_expect(const Token &token, LazyType expected)
+{
+    LazyType type = _value_type(token);
+    if (type != expected)
+    {
+        throw invalid_type(expected, type);
+    }
+}
+
+bool binding_reader::key(Token &key)
+{
+    key = _tokenizer.getToken();
+    if (key.type == TOKEN_TYPE::COMMA)
+    {
+        key = _tokenizer.getToken();
+    }
+    if (key.type == TOKEN_TYPE::CURLY_CLOSE)
+    {
+        return false;
+    }
+    if (key.type != TOKEN_TYPE::STRING)
+    {
+        throw std::runtime_error("binding_reader::key(): Expected a key at: " + std::to_string(key.start));
+    }
+    return true;
+}
+
+Token binding_reader::value()
+{
+    if (_tokenizer.getToken().type != TOKEN_TYPE::COLON)
+    {
+        throw std::runtime_error("binding_reader::value(): Expected a colon at: " + std::to_string(_tokenizer.getPos()));
+    }
+    return _tokenizer.getToken();
+}
+
+void binding_reader::skip()
+{
+    if (_tokenizer.getToken().type != TOKEN_TYPE::COLON)
+    {
+        throw std::runtime_error("binding_reader::skip(): Expected a colon at: " + std::to_string(_tokenizer.getPos()));
+    }
+    _tokenizer.skipValue();
+}
+
+bool binding_reader::element(Token &value)
+{
+    value = _tokenizer.getToken();
+    if (value.type == TOKEN_TYPE::COMMA)
+    {
+        value = _tokenizer.getToken();
+    }
+    return value.type != TOKEN_TYPE::ARRAY_CLOSE;
+}
+
+uint32_t binding_reader::hash(const Token &key)
+{
+    if (key.escaped)
+    {
+        std::string decoded = _tokenizer.str(key);
+        return path_hash(decoded.data(), decoded.size());
+    }
+    return path_hash(_tokenizer._stream.at(key.start), key.length);
+}
+
+bool binding_reader::equals(const Token &key, const char *data, size_t length)
+{
+    return _tokenizer.equals(key, data, length);
+}
+
+bool binding_reader::object(const Token &token)
+{
+    if (token.type == TOKEN_TYPE::NULL_TYPE)
+    {
+        return false;
+    }
+    _expect(token, LazyType::OBJECT);
+    return true;
+}
+
+bool binding_reader::list(const Token &token)
+{
+    if (token.type == TOKEN_TYPE::NULL_TYPE)
+    {
+        return false;
+    }
+    _expect(token, LazyType::LIST);
+    return true;
+}
+
+bool binding_reader::number(const Token &token, lazy_number &out)
+{
+    if (token.type == TOKEN_TYPE::NULL_TYPE)
+    {
+        return false;
+    }
+    _expect(token, LazyType::NUMBER);
+    if (!parse_number(_tokenizer._stream.at(token.start), token.length, out))
+    {
+        throw std::runtime_error("binding_reader::number(): Invalid number at: " + std::to_string(token.start));
+    }
+    return true;
+}
+
+bool binding_reader::boolean(const Token &token, bool &out)
+{
+    if (token.type == TOKEN_TYPE::NULL_TYPE)
+    {
+        return false;
+    }
+    _expect(token, LazyType::BOOL);
+    out = token.length == 4;
+    return true;
+}
+
+bool binding_reader::string(const Token &token, std::string &out)
+{
+    if (token.type == TOKEN_TYPE::NULL_TYPE)
+    {
+        return false;
+    }
+    _expect(token, LazyType::STRING);
+    out = _tokenizer.str(token);
+    return true;
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,323 @@
+#pragma once
+
+/*
+
+## Struct binding
+
+Declarative mapping of the members of a plain struct to the keys of a json object,
+decoded in a single forward pass with `extractor::decode()`, instead of a filter
+(a scan from the root) and an `extract()` per member.
+
+`LAZY_JSON_BIND` lists the bound members, it has to be used at the global scope,
+with the fully qualified type name. `LAZY_JSON_FIELD(member)` uses the member name
+as the key, `LAZY_JSON_FIELD_AS(member, "key")` any other key. Members can be numbers,
+`bool`, `std::string`, `String`, other bound structs and `std::vector`s of those.
+
+The keys of a struct are dispatched with a perfect hash computed at compile time:
+the key's hash picks one slot of a small table, so a member is found with one lookup,
+a hash compare and a `memcmp`. Unknown members are skipped without tokenizing them,
+missing and null members keep their values.
+
+```cpp
+struct condition { int id; std::string description; };
+struct report { float temp; int humidity; std::vector<condition> weather; };
+
+LAZY_JSON_BIND(condition, LAZY_JSON_FIELD(id), LAZY_JSON_FIELD(description))
+LAZY_JSON_BIND(report, LAZY_JSON_FIELD_AS(temp, "temperature"), LAZY_JSON_FIELD(humidity),
+               LAZY_JSON_FIELD(weather))
+
+report r;
+extractor ex(json);
+ex["current"].decode(r);
+```
+
+*/
+
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <Arduino.h>
+
+#include "Tokenizer.h"
+#include "errors.h"
+#include "numbers.h"
+#include "path.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Reads the values of a bound struct straight from the tokenizer, one token after another,
+/// the data of a token is used before the next one is read (streamed json is fine)
+class binding_reader
+{
+    Tokenizer &_tokenizer;
+
+    void _expect(const Token &token, LazyType expected);
+
+public:
+    binding_reader(Tokenizer &tokenizer);
+
+    /// @brief Read the next key of the object (the value is read by `value()`)
+    /// @return false at the end of the object
+    bool key(Token &key);
+
+    /// @brief Read the colon and the first token of the member's value
+    Token value();
+
+    /// @brief Read the first token of the next element of the list
+    /// @return false at the end of the list
+    bool element(Token &value);
+
+    /// @brief Read the colon and skip the member's value without reading it,
+    /// skipped strings don't have to fit in the streaming buffer
+    void skip();
+
+    /// @brief Hash of the decoded key, see `path_hash()`
+    uint32_t hash(const Token &key);
+
+    bool equals(const Token &key, const char *data, size_t length);
+
+    /// @return false if the value is null
+    /// @throw `lazyjson::invalid_type` if the value is not an object
+    bool object(const Token &token);
+
+    /// @return false if the value is null
+    /// @throw `lazyjson::invalid_type` if the value is not a list
+    bool list(const Token &token);
+
+    /// @return false if the value is null, `out` is not changed
+    /// @throw `lazyjson::invalid_type` on other types
+    bool number(const Token &token, lazy_number &out);
+    bool boolean(const Token &token, bool &out);
+    bool string(const Token &token, std::string &out);
+};
+
+template <class T>
+struct bound_field
+{
+    const char *key;
+    size_t length;
+    uint32_t hash;
+    void (*decode)(binding_reader &reader, const Token &token, T &out);
+};
+
+template <class T, size_t N>
+struct bound_fields
+{
+    bound_field<T> items[N];
+};
+
+template <class T, class... Fields>
+constexpr bound_fields<T, sizeof...(Fields)> bind_fields(Fields... fields)
+{
+    return bound_fields<T, sizeof...(Fields)>{{fields...}};
+}
+
+/// @brief Bound members of `T`, specialized by `LAZY_JSON_BIND`
+template <class T>
+struct binding
+{
+};
+
+/// @brief Slot of the key's hash in a table of `2^bits` entries
+constexpr uint32_t binding_slot(uint32_t hash, uint32_t multiplier, unsigned bits)
+{
+    return uint32_t(hash * multiplier) >> (32 - bits);
+}
+
+/// @brief `k`-th multiplier tried for the perfect hash (odd multiples of the golden ratio)
+constexpr uint32_t binding_multiplier(unsigned k)
+{
+    return uint32_t(2654435761u * (2u * k + 1u));
+}
+
+// C++11 constexpr functions can't loop, the searches below are recursions (at most 2 * count deep)
+
+template <class T>
+constexpr bool _slot_free(const bound_field<T> *fields, size_t i, size_t count, uint32_t slot, uint32_t multiplier, unsigned bits)
+{
+    return i >= count || (binding_slot(fields[i].hash, multiplier, bits) != slot && _slot_free(fields, i + 1, count, slot, multiplier, bits));
+}
+
+/// @brief No two keys from `i` on share a slot
+template <class T>
+constexpr bool _perfect(const bound_field<T> *fields, size_t i, size_t count, uint32_t multiplier, unsigned bits)
+{
+    return i >= count || (_slot_free(fields, i + 1, count, binding_slot(fields[i].hash, multiplier, bits), multiplier, bits) &&
+                          _perfect(fields, i + 1, count, multiplier, bits));
+}
+
+/// @brief First multiplier giving a perfect hash with `2^bits` slots, 32 if there is none
+template <class T>
+constexpr unsigned _search_multiplier(const bound_field<T> *fields, size_t count, unsigned bits, unsigned k = 0)
+{
+    return k >= 32 ? 32 : _perfect(fields, 0, count, binding_multiplier(k), bits) ? k : _search_multiplier(fields, count, bits, k + 1);
+}
+
+/// @brief Smallest table (at least twice the keys, at most 256 slots) with a perfect hash, 0 if there is none
+template <class T>
+constexpr unsigned _search_bits(const bound_field<T> *fields, size_t count, unsigned bits = 1)
+{
+    return bits > 8 ? 0 : (size_t(1) << bits) >= 2 * count && _search_multiplier(fields, count, bits) < 32 ? bits : _search_bits(fields, count, bits + 1);
+}
+
+/// @brief 1 + index of the key in the slot, 0 if it's empty
+template <class T>
+constexpr uint8_t _slot_owner(const bound_field<T> *fields, size_t i, size_t count, uint32_t slot, uint32_t multiplier, unsigned bits)
+{
+    return i >= count ? 0 : binding_slot(fields[i].hash, multiplier, bits) == slot ? uint8_t(i + 1) : _slot_owner(fields, i + 1, count, slot, multiplier, bits);
+}
+
+/// @brief Bound fields of `T` and the parameters of their perfect hash
+template <class T>
+struct binding_layout
+{
+    typedef decltype(binding<T>::fields()) field_list;
+    static constexpr field_list fields = binding<T>::fields();
+    static constexpr size_t count = sizeof(field_list::items) / sizeof(field_list::items[0]);
+    static constexpr unsigned bits = _search_bits(fields.items, count);
+    static constexpr uint32_t multiplier = binding_multiplier(_search_multiplier(fields.items, count, bits ? bits : 1));
+
+    static_assert(bits, "LAZY_JSON_BIND: no perfect hash for the keys, bind fewer members (nested structs)");
+};
+
+template <class T>
+constexpr typename binding_layout<T>::field_list binding_layout<T>::fields;
+
+template <class T, class Slots>
+struct binding_slots;
+
+template <class T, size_t... Slot>
+struct binding_slots<T, index_list<Slot...>>
+{
+    typedef binding_layout<T> layout;
+    static constexpr uint8_t slots[sizeof...(Slot)] = {_slot_owner(layout::fields.items, 0, layout::count, Slot, layout::multiplier, layout::bits)...};
+};
+
+template <class T, size_t... Slot>
+constexpr uint8_t binding_slots<T, index_list<Slot...>>::slots[sizeof...(Slot)];
+
+/// @brief Perfect hash table of the keys bound to the members of `T`
+template <class T>
+struct binding_table
+{
+    typedef binding_layout<T> layout;
+    typedef binding_slots<T, typename make_index_list<size_t(1) << layout::bits>::type> table;
+
+    /// @brief Field bound to the key, nullptr if there is none
+    static const bound_field<T> *find(binding_reader &reader, const Token &key)
+    {
+        uint32_t hash = reader.hash(key);
+        uint8_t owner = table::slots[binding_slot(hash, layout::multiplier, layout::bits)];
+        if (!owner)
+        {
+            return nullptr;
+        }
+        const bound_field<T> &field = layout::fields.items[owner - 1];
+        return field.hash == hash && reader.equals(key, field.key, field.length) ? &field : nullptr;
+    }
+};
+
+template <class T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type decode_value(binding_reader &reader, const Token &token, T &out)
+{
+    lazy_number number;
+    if (reader.number(token, number))
+    {
+        // integral literals are exact, fractions are truncated for integer types (same as `wrapper::as()`)
+        out = number.integral ? static_cast<T>(number.integer) : static_cast<T>(number.real);
+    }
+}
+
+inline void decode_value(binding_reader &reader, const Token &token, bool &out)
+{
+    reader.boolean(token, out);
+}
+
+inline void decode_value(binding_reader &reader, const Token &token, std::string &out)
+{
+    reader.string(token, out);
+}
+
+inline void decode_value(binding_reader &reader, const Token &token, String &out)
+{
+    std::string value;
+    if (reader.string(token, value))
+    {
+        out = String(value.c_str());
+    }
+}
+
+/// @brief Bound struct, the members missing in the json keep their values
+template <class T>
+auto decode_value(binding_reader &reader, const Token &token, T &out) -> decltype(binding<T>::fields(), void())
+{
+    if (!reader.object(token))
+    {
+        return;
+    }
+    Token key;
+    while (reader.key(key))
+    {
+        const bound_field<T> *field = binding_table<T>::find(reader, key);
+        if (field)
+        {
+            field->decode(reader, reader.value(), out);
+        }
+        else
+        {
+            reader.skip();
+        }
+    }
+}
+
+/// @brief The elements replace the content of the vector, null leaves it as it is
+template <class T>
+void decode_value(binding_reader &reader, const Token &token, std::vector<T> &out)
+{
+    if (!reader.list(token))
+    {
+        return;
+    }
+    out.clear();
+    Token value;
+    while (reader.element(value))
+    {
+        T item = T();
+        decode_value(reader, value, item);
+        out.push_back(std::move(item));
+    }
+}
+
+template <class S, class T, T S::*Member>
+void decode_member(binding_reader &reader, const Token &token, S &out)
+{
+    decode_value(reader, token, out.*Member);
+}
+
+END_LAZY_JSON_NAMESPACE
+
+/// @brief Member bound to the key of the same name, see `LAZY_JSON_BIND`
+#define LAZY_JSON_FIELD(member) LAZY_JSON_FIELD_AS(member, #member)
+
+/// @brief Member bound to `key` (a string literal), see `LAZY_JSON_BIND`
+#define LAZY_JSON_FIELD_AS(member, key)                                          \
+    bound_field<type>{key, sizeof(key) - 1, static_hash(key, sizeof(key) - 1), \
+                      &decode_member<type, decltype(type::member), &type::member>}
+
+/// @brief Bind the members of `Type` (fully qualified) to json keys, at the global scope
+#define LAZY_JSON_BIND(Type, ...)                                             \
+    BEGIN_LAZY_JSON_NAMESPACE                                                 \
+    template <>                                                               \
+    struct binding<Type>                                                      \
+    {                                                                         \
+        typedef Type type;                                                    \
+        static constexpr auto fields() -> decltype(bind_fields<Type>(__VA_ARGS__)) \
+        {                                                                     \
+            return bind_fields<Type>(__VA_ARGS__);                            \
+        }                                                                     \
+    };                                                                        \
+    END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,48 @@
+#include "document.h"
+
+#include <string.h>
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+document::document(const char *json) : document(json, json ? strlen(json) : 0) {}
+
+document::document(const char *json, size_t length) : _data(json), _size(length) {}
+
+#if __cplusplus >= 201703L
+document::document(std::string_view json) : document(json.data(), json.size()) {}
+#endif
+
+document::document(std::string &&json)
+{
+    auto owned = std::make_shared<const std::string>(std::move(json));
+    _data = owned->data();
+    _size = owned->size();
+    _source = owned;
+}
+
+#if LAZY_JSON_MMAP
+document document::from_file(const char *path, access_pattern pattern)
+{
+    auto file = std::make_shared<const mapped_file>(path, pattern);
+    document doc(file->data(), file->size());
+    doc._source = file;
+    return doc;
+}
+#endif
+
+const char *document::data() const
+{
+    return _data;
+}
+
+size_t document::size() const
+{
+    return _size;
+}
+
+const std::shared_ptr<const void> &document::source() const
+{
+    return _source;
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,75 @@
+#pragma once
+
+/*
+
+## Document
+
+Immutable json shared by any number of cursors. The document only holds the data
+(referenced, owned, or memory mapped), all of the navigation state (position, cached
+scopes, memo, arena) lives in the `cursor`. Nothing in a document is ever written,
+so many threads can query the same one at once, each with its own cursor, without locks.
+
+```cpp
+using namespace lazyjson;
+
+const document doc = document::from_file("forecast.json");
+
+// in every worker
+cursor cur(doc);
+float temp = cur["list"][3]["main"]["temp"].extract().asFloat();
+```
+
+*/
+
+#include <string>
+#include <memory>
+#include <stddef.h>
+#if __cplusplus >= 201703L
+#   include <string_view>
+#endif
+
+#include "../stream/mapped_file.h"
+#include "../options.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+class document
+{
+    const char *_data;
+    size_t _size;
+    // keeps the json alive (owned copy, memory mapping) as long as any cursor uses it,
+    // null if the json is only referenced
+    std::shared_ptr<const void> _source;
+
+public:
+    /// @brief References the null-terminated json, it's not copied and must outlive
+    /// the document and its cursors
+    document(const char *json = "");
+
+    /// @brief References `length` bytes of json, it doesn't have to be null-terminated
+    document(const char *json, size_t length);
+
+#if __cplusplus >= 201703L
+    /// @brief References the viewed json
+    document(std::string_view json);
+#endif
+
+    /// @brief Takes over the json string, the document owns it
+    explicit document(std::string &&json);
+
+#if LAZY_JSON_MMAP
+    /// @brief Read-only memory mapping of the file at `path`, released with the last copy
+    /// of the document and its last cursor
+    /// @throw `std::runtime_error` if the file can't be opened or mapped
+    static document from_file(const char *path, access_pattern pattern = access_pattern::random);
+#endif
+
+    const char *data() const;
+    size_t size() const;
+
+    /// @brief Owner of the json (null if it's only referenced), shared by the cursors
+    const std::shared_ptr<const void> &source() const;
+};
+
+END_LAZY_JSON_NAMESPACE
@@ -18,4 +18,12 @@ invalid_type::invalid_type(const LazyType& expected, LazyType type)
     : std::runtime_error("expected " + verboseLazyType(expected) + " but got " + verboseLazyType(type))
 {}
 
+invalid_path::invalid_path(const std::string& path, size_t pos, const char* reason)
+    : std::runtime_error("invalid path \"" + path + "\" at " + std::to_string(pos) + ": " + reason)
+{}
+
+invalid_json::invalid_json(size_t pos, const char* reason)
+    : std::runtime_error("invalid json at " + std::to_string(pos) + ": " + reason)
+{}
+
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
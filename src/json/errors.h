@@ -24,4 +24,16 @@ public:
     invalid_type(const LazyType& expected, LazyType type);
 };
 
+class invalid_path : public std::runtime_error
+{
+public:
+    invalid_path(const std::string& path, size_t pos, const char* reason);
+};
+
+class invalid_json : public std::runtime_error
+{
+public:
+    invalid_json(size_t pos, const char* reason);
+};
+
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
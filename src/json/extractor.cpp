@@ -1,28 +1,242 @@
 #include "extractor.h"
 
+#include <string.h>
+
 
 BEGIN_LAZY_JSON_NAMESPACE
 
 
-extractor::extractor(const char *json)
+extractor::extractor(const char *json) : _heap_nodes(LAZY_JSON_ARENA_BLOCK == 0), _check_touched(false)
 {
     static_cast<void>(set(json));
 }
 
+extractor::extractor(const char *json, size_t length) : _heap_nodes(LAZY_JSON_ARENA_BLOCK == 0), _check_touched(false)
+{
+    static_cast<void>(set(json, length));
+}
+
+#if __cplusplus >= 201703L
+extractor::extractor(std::string_view json) : _heap_nodes(LAZY_JSON_ARENA_BLOCK == 0), _check_touched(false)
+{
+    static_cast<void>(set(json));
+}
+#endif
+
+extractor::extractor(stream_reader reader, size_t buffer_size) : _heap_nodes(LAZY_JSON_ARENA_BLOCK == 0), _check_touched(false)
+{
+    static_cast<void>(set(reader, buffer_size));
+}
+
+extractor::extractor(const document &doc) : _heap_nodes(LAZY_JSON_ARENA_BLOCK == 0), _check_touched(false)
+{
+    static_cast<void>(set(doc.data(), doc.size()));
+    _source = doc.source();
+}
+
 extractor::~extractor() {}
 
+#if LAZY_JSON_MMAP
+extractor extractor::from_file(const char *path, access_pattern pattern)
+{
+    auto file = std::make_shared<const mapped_file>(path, pattern);
+    extractor ex(file->data(), file->size());
+    ex._source = file;
+    return ex;
+}
+#endif
+
+cursor::cursor(const document &doc) : extractor(doc) {}
+
 void extractor::reset()
 {
+    if (_streaming){
+        throw std::runtime_error("extractor::reset(): Streamed json can't be read again");
+    }
+    // the size is already known, no need to scan the data again,
+    // the memoized offsets stay valid since it's the same document
+    _depth = 0;
+    _tokenizer.setData(_data, _size);
     _start = 0;
-    _reset_cache();
-    const char *data = _data;
-    static_cast<void>(set(data));
+    _end = SIZE_MAX;
+    _cache_start = 0;
+    _is_null = false;
+}
+
+void extractor::memoize(size_t capacity)
+{
+    _memo.reserve(capacity);
+}
+
+const memo_stats &extractor::memoStats() const
+{
+    return _memo.stats();
+}
+
+/// @brief `validate()` of the whole json, the member function hides it
+static validation _validate_json(const char *data, size_t size)
+{
+    return validate(data, size);
+}
+
+void extractor::validate(validation_mode mode)
+{
+    if (_streaming && mode != validation_mode::none){
+        throw std::runtime_error("extractor::validate(): Streamed json can't be validated");
+    }
+    _check_touched = mode == validation_mode::touched;
+    if (mode == validation_mode::full){
+        validation result = _validate_json(_data, _size);
+        if (!result.valid){
+            throw invalid_json(result.position, result.reason);
+        }
+    }
+}
+
+void extractor::_check(size_t start, size_t stop)
+{
+    if (!_check_touched || _streaming){
+        return;
+    }
+    checked_value *checked = nullptr;
+    for (size_t i = 0; i < LAZY_JSON_CHECKED_VALUES; i++){
+        if (_checked[i].start == start){
+            checked = &_checked[i];
+            break;
+        }
+    }
+    if (checked && checked->end >= stop){
+        return;
+    }
+    // the json is limited by `select()`, an object / list is checked on from where
+    // its previous check stopped, not from its start again
+    validation_frontier frontier;
+    validation result = checked && checked->frontier.pos
+                            ? validate_rest(_data, _tokenizer._stream.size(), checked->frontier, stop, &frontier)
+                            : validate_value(_data, _tokenizer._stream.size(), start, stop, &frontier);
+    if (!result.valid){
+        // the next filter starts from the cached value again
+        _reset_cache();
+        throw invalid_json(result.position, result.reason);
+    }
+    if (!checked){
+        // the oldest one is forgotten
+        checked = &_checked[_checked_next];
+        _checked_next = (_checked_next + 1) % LAZY_JSON_CHECKED_VALUES;
+        checked->start = start;
+    }
+    // the value ended before `stop`, all of it is checked
+    checked->end = result.end < stop ? SIZE_MAX : stop;
+    checked->frontier = frontier;
+}
+
+void extractor::_forget_checked()
+{
+    for (size_t i = 0; i < LAZY_JSON_CHECKED_VALUES; i++){
+        _checked[i].start = SIZE_MAX;
+    }
+    _checked_next = 0;
+}
+
+void extractor::useArena(std::shared_ptr<arena> memory)
+{
+    _heap_nodes = !memory;
+    if (!memory){
+        _arena.reset();
+        return;
+    }
+    // the extractor and its wrappers share their own owner of the arena, so the caller
+    // holding `memory` too doesn't count as a wrapper still using it (see `_parse_arena()`)
+    auto owner = std::make_shared<std::shared_ptr<arena>>(memory);
+    _arena = std::shared_ptr<arena>(owner, memory.get());
+}
+
+arena *extractor::_parse_arena()
+{
+    if (!_arena){
+        // useArena(nullptr) keeps the nodes on the heap, except for streamed json,
+        // its strings are copied out of the buffer into the arena
+        if (_heap_nodes && !_streaming){
+            return nullptr;
+        }
+        _arena = std::make_shared<arena>(LAZY_JSON_ARENA_BLOCK);
+        return _arena.get();
+    }
+    // no wrapper holds the values of the previous extractions, their memory is reused
+    if (_arena.use_count() == 1){
+        _arena->reset();
+    }
+    return _arena.get();
+}
+
+bool extractor::_is_container(size_t pos)
+{
+    // right after the first character of the value
+    _tokenizer.validatePos(pos);
+    if (pos == 0 || pos > _tokenizer._stream.size()){
+        return false;
+    }
+    char c = *_tokenizer._stream.at(pos - 1);
+    return c == '{' || c == '[';
+}
+
+wrapper extractor::_wrap(const LazyTypedValues &value)
+{
+    // only the nodes (and streamed strings) live in the arena, numbers, booleans, nulls
+    // and strings of the json in memory are stored in place
+    bool container = value.type == LazyType::OBJECT || value.type == LazyType::LIST;
+    bool node = container || (value.type == LazyType::STRING && _streaming);
+    // the strings of an owned json or a mapped file point into it, so the wrapper
+    // keeps it alive too, the extractor (or the document) may be gone before it's read
+    if (_source && (container || value.type == LazyType::STRING)){
+        if (!container){
+            return wrapper(value, std::const_pointer_cast<void>(_source));
+        }
+        std::shared_ptr<void> nodes;
+        if (_arena){
+            nodes = _arena;
+        } else if (value.type == LazyType::OBJECT){
+            nodes = std::shared_ptr<LazyObject>(value.values.object);
+        } else{
+            nodes = std::shared_ptr<LazyList>(value.values.list);
+        }
+        typedef std::pair<std::shared_ptr<const void>, std::shared_ptr<void>> owners;
+        return wrapper(value, std::shared_ptr<void>(std::make_shared<owners>(_source, std::move(nodes))));
+    }
+    if (node && _arena){
+        return wrapper(value, _arena);
+    }
+    return wrapper(value);
+}
+
+bool extractor::_memo_enabled()
+{
+    // streamed data can't be revisited
+    return !_streaming && _memo.enabled();
 }
 
 void extractor::_reset_cache()
 {
     _cache_start = _start;
-    _end = -1;
+}
+
+void extractor::_unpin()
+{
+    // streamed data of the cached scopes must stay in the buffer
+    if (!_depth){
+        _tokenizer.unpin();
+    } else{
+        _tokenizer.pin(_start);
+    }
+}
+
+void extractor::_hold(size_t keep)
+{
+    // streamed data from `keep` on is read again (see `_resolve()`), the cached scopes start before it
+    _unpin();
+    if (!_depth && keep != SIZE_MAX){
+        _tokenizer.pin(keep);
+    }
 }
 
 void extractor::cache()
@@ -37,238 +251,608 @@ void extractor::cache()
 
     Token token = _tokenizer.getToken();
 
-    if (token.type == TOKEN_TYPE::CURLY_OPEN){
-        fast_forward(_tokenizer.getPos(), TOKEN_TYPE::CURLY_OPEN,
-            TOKEN_TYPE::CURLY_CLOSE, &_tokenizer);
-    }
-    else if(token.type == TOKEN_TYPE::ARRAY_OPEN){
-        fast_forward(_tokenizer.getPos(), TOKEN_TYPE::ARRAY_OPEN,
-            TOKEN_TYPE::ARRAY_CLOSE, &_tokenizer);
+    if (token.type == TOKEN_TYPE::CURLY_OPEN || token.type == TOKEN_TYPE::ARRAY_OPEN){
+        _tokenizer.skipContainer();
     }
     // else the values are parsed as a whole (strings, numbers, booleans, nulls)
-    _end = (int)_tokenizer.getPos();
-    _json = _tokenizer.json(_cache_start, _end);
+    _push_scope(_cache_start, _tokenizer.getPos());
 
 #if DEBUG_LAZY_JSON
-    Serial.printf("Extractor: Caching %s\n", _json.c_str());
+    Serial.printf("Extractor: Caching %s\n", json().c_str());
 #endif
-    _set_cache();
+    _set_scope();
+}
+
+void extractor::pop()
+{
+    if (!_depth){
+        return;
+    }
+    _depth--;
+    _set_scope();
+}
+
+size_t extractor::depth() const
+{
+    return _depth;
+}
+
+void extractor::_push_scope(size_t start, size_t end)
+{
+    if (_depth == LAZY_JSON_MAX_SCOPES){
+        throw std::runtime_error("extractor::cache(): More than " + std::to_string(LAZY_JSON_MAX_SCOPES) +
+                                 " nested scopes (LAZY_JSON_MAX_SCOPES)");
+    }
+    _scopes[_depth].start = start;
+    _scopes[_depth].end = end;
+    _depth++;
+}
+
+void extractor::_set_scope()
+{
+    _is_null = false;
+    if (!_depth){
+        _start = 0;
+        _end = SIZE_MAX;
+    } else{
+        _start = _scopes[_depth - 1].start;
+        _end = _scopes[_depth - 1].end;
+    }
+    _cache_start = _start;
+    _unpin();
+    // the enclosing scope may be already dropped from the streaming buffer
+    if (_start >= _tokenizer._stream.offset()){
+        _tokenizer.setPos(_start);
+    }
 }
 
 extractor &extractor::set(const char *json)
+{
+    return set(json, json ? strlen(json) : 0);
+}
+
+#if __cplusplus >= 201703L
+extractor &extractor::set(std::string_view json)
+{
+    return set(json.data(), json.size());
+}
+#endif
+
+extractor &extractor::set(const char *json, size_t length)
 {
     _data = const_cast<char *>(json);
-    _tokenizer.setData(json);
+    _size = length;
+    if (_heap_nodes){
+        // only the strings of streamed json were in the arena
+        _arena.reset();
+    }
+    _streaming = false;
+    _source.reset();
+    _depth = 0;
+    _memo.clear();
+    _forget_checked();
+    _tokenizer.setData(json, length);
     _start = 0;
-    _end = -1;
+    _end = SIZE_MAX;
     _cache_start = 0;
     _is_null = false;
     return *this;
 }
 
-void extractor::_set_cache()
+extractor &extractor::set(stream_reader reader, size_t buffer_size)
 {
-    _is_null = false;
+    _data = nullptr;
+    _size = 0;
+    _streaming = true;
+    _source.reset();
+    _depth = 0;
+    _memo.clear();
+    _forget_checked();
+    _tokenizer.setData(reader, buffer_size);
     _start = 0;
-    _end = -1;
+    _end = SIZE_MAX;
     _cache_start = 0;
-    _tokenizer.setData(_json.c_str());
+    _is_null = false;
+    return *this;
+}
+
+extractor &extractor::select(size_t start, size_t end)
+{
+    if (_streaming){
+        throw std::runtime_error("extractor::select(): Streamed json can't be selected");
+    }
+    end = end < _size ? end : _size;
+    // the data pointer stays the same, so the positions are still absolute
+    _depth = 0;
+    _tokenizer.setData(_data, end);
+    _push_scope(start, end);
+    _set_scope();
+    return *this;
 }
 
-const std::string &extractor::json()
+element_range extractor::elements()
 {
-    return _json;
+    return element_range(this);
 }
 
-LazyType extractor::_instance_type()
+item_range extractor::items()
+{
+    return item_range(this);
+}
+
+document_range extractor::documents()
+{
+    return document_range(this);
+}
+
+std::string extractor::json()
 {
-    Token token = _tokenizer.peekToken();
-    LazyType valueType;
+    if (!_depth){
+        return std::string();
+    }
+    return _tokenizer.json(_start, _end);
+}
 
+/// @brief Type of the value starting with `token`
+static LazyType _token_type(const Token &token)
+{
     switch (token.type)
     {
     case TOKEN_TYPE::STRING:
-        valueType = LazyType::STRING;
-        break;
+        return LazyType::STRING;
     case TOKEN_TYPE::CURLY_OPEN:
-        valueType = LazyType::OBJECT;
-        break;
+        return LazyType::OBJECT;
     case TOKEN_TYPE::ARRAY_OPEN:
-        valueType = LazyType::LIST;
-        break;
+        return LazyType::LIST;
     case TOKEN_TYPE::NUMBER:
-        valueType = LazyType::NUMBER;
-        break;
+        return LazyType::NUMBER;
     case TOKEN_TYPE::BOOLEAN:
-        valueType = LazyType::BOOL;
-        break;
+        return LazyType::BOOL;
     case TOKEN_TYPE::NULL_TYPE:
-        valueType = LazyType::NULL_TYPE;
-        break;
+        return LazyType::NULL_TYPE;
     default:
         throw std::runtime_error("extractor::_instance_type(): Unknown type / invalid json");
-        break;
     }
-    return valueType;
+}
+
+LazyType extractor::_instance_type()
+{
+    return _token_type(_tokenizer.peekToken());
 }
 
 void extractor::_validate(const LazyType &expected)
 {
     LazyType valueType = _instance_type();
     if (expected != valueType){
+        // go back to the cached value, so the next filter starts from there
+        _reset_cache();
         throw invalid_type(expected, valueType);
     }
 }
 
+bool extractor::_enter(LazyType expected)
+{
+    _tokenizer.setPos(_cache_start);
+    // if the value was not found, no need to parse
+    if (_is_null){
+        return false;
+    }
+
+    // the opening bracket is read only once, instead of peeking the type and validating it
+    LazyType valueType = _token_type(_tokenizer.getToken());
+    if (valueType == expected){
+        return true;
+    }
+    _tokenizer.rollBack();
+    // null propagates through the filters
+    if (valueType == LazyType::NULL_TYPE){
+        return false;
+    }
+    // go back to the cached value, so the next filter starts from there
+    _reset_cache();
+    throw invalid_type(expected, valueType);
+}
+
 wrapper extractor::extract()
 {
     LazyTypedValues value;
     if (_is_null){
         value.type = LazyType::NULL_TYPE;
     } else{
-        value = lazy_parse(_cache_start, false, &_tokenizer);
+        _check(_cache_start);
+        try{
+            // scalars and strings are stored in place, the arena is not even created for them
+            // (streamed strings are copied into it)
+            arena *memory = _is_container(_cache_start) || _streaming ? _parse_arena() : nullptr;
+            value = lazy_parse(_cache_start, false, &_tokenizer, memory);
+        } catch (...){
+            // e.g. invalid json or a full arena, the next filter starts from the root again
+            _reset_cache();
+            throw;
+        }
     }
     // reset the null flag
     _is_null = false;
-    wrapper w(value);
+    wrapper w = _wrap(value);
     _reset_cache();
-    // reset the tokenizer to the start of the value
-    _tokenizer.setPos(_cache_start);
+    // reset the tokenizer to the start of the value, unless it was already
+    // dropped from the streaming buffer (the next filter will report that)
+    if (_cache_start >= _tokenizer._stream.offset()){
+        _tokenizer.setPos(_cache_start);
+    }
     return w;
 }
 
-extractor &extractor::filter(const std::string &find)
+std::vector<wrapper> extractor::extract(const path_set &paths, bool deep)
 {
-    _tokenizer.setPos(_cache_start);
-    // if the value was not found or has null type, no need to parse
-    if (_is_null || _instance_type() == LazyType::NULL_TYPE){
-        return *this;
+    std::vector<wrapper> results(paths.size());
+    if (!_is_null && paths.size()){
+        _check(_cache_start);
+        static_cast<void>(_parse_arena());
+        _tokenizer.setPos(_cache_start);
+        size_t remaining = paths.size();
+        std::vector<bool> resolved(paths.nodes());
+        _resolve(paths, 0, results, resolved, remaining, false, deep, SIZE_MAX);
     }
+    _is_null = false;
+    _reset_cache();
+    if (_cache_start >= _tokenizer._stream.offset()){
+        _tokenizer.setPos(_cache_start);
+    }
+    return results;
+}
 
-    _validate(LazyType::OBJECT);
-    // curly open token
-    _tokenizer.getToken();
-    
-    Token token;
-
-#if DEBUG_LAZY_JSON
-    Serial.printf("Extractor: Filtering %s, json = %s\n", find.c_str(), _tokenizer._stream.data());
-#endif
-
-    while (_tokenizer.hasTokens()){
-        // key of the object
+bool extractor::_decode_begin(Token &token)
+{
+    if (!_is_null){
+        _check(_cache_start);
+        _tokenizer.setPos(_cache_start);
+        // the values are copied as soon as they are read, streamed data can be dropped
+        _unpin();
         token = _tokenizer.getToken();
+        if (token.type != TOKEN_TYPE::NULL_TYPE){
+            return true;
+        }
+    }
+    _decode_end();
+    return false;
+}
 
-    #if DEBUG_LAZY_JSON
-        Serial.printf("Extractor: Parsing object token %s = %s\n",
-            verboseTokenType(token.type).c_str(), token.value.c_str());
-    #endif
+void extractor::_decode_end()
+{
+    _is_null = false;
+    _reset_cache();
+    if (_cache_start >= _tokenizer._stream.offset()){
+        _tokenizer.setPos(_cache_start);
+    }
+}
 
-        if (token.type == TOKEN_TYPE::COMMA){
-            continue;
+void extractor::_resolve(const path_set &paths, size_t index, std::vector<wrapper> &results, std::vector<bool> &resolved,
+                         size_t &remaining, bool consume, bool deep, size_t keep)
+{
+    const path_node &node = paths.node(index);
+    // every path of this subtree is resolved (or null) once `remaining` drops to `done`
+    size_t done = remaining - node.total;
+    size_t value_pos = _tokenizer.getPos();
+
+    if (!node.ids.empty()){
+        _tokenizer.pin(value_pos < keep ? value_pos : keep);
+        results[node.ids[0]] = _wrap(lazy_parse(value_pos, deep, &_tokenizer, _arena.get()));
+        for (size_t i = 1; i < node.ids.size(); i++){
+            results[node.ids[i]] = results[node.ids[0]];
         }
-        if (token.type == TOKEN_TYPE::CURLY_CLOSE){
-            break; 
-        }        
+        remaining -= node.ids.size();
+        _tokenizer.setPos(value_pos);
+    }
+    _hold(keep);
 
-        // key must be a string    
-        if (token.type != TOKEN_TYPE::STRING){   
-            break;
+    Token token = _tokenizer.getToken();
+    bool is_object = token.type == TOKEN_TYPE::CURLY_OPEN;
+    bool is_list = token.type == TOKEN_TYPE::ARRAY_OPEN;
+    if (node.children.empty() || (!is_object && !is_list)){
+        // leaf, or a value that can't have the requested children (they stay null)
+        remaining = done;
+        if ((is_object || is_list) && remaining){
+            _tokenizer.skipContainer();
         }
-        auto key = token.value;
+        return;
+    }
+
+    // longer raw keys can't match any child (see `_filter_key`)
+    size_t longest = 0;
+    for (size_t c : node.children){
+        const path_segment &segment = paths.node(c).segment;
+        if (segment.is_key && segment.key.size() > longest){
+            longest = segment.key.size();
+        }
+    }
+    longest *= 6;
 
-    #if DEBUG_LAZY_JSON
-        Serial.printf("Extractor: Parsing object key %s \n", key.c_str());
-    #endif
-        // colon must be next
-        if (_tokenizer.getToken().type != TOKEN_TYPE::COLON){
+    int i = 0;
+    while (_tokenizer.hasTokens()){
+        if (remaining == done){
+            // the rest of the container is not needed, nothing has to be read
+            // till the end if it's the root, or if every path is already resolved
+            if (consume && remaining){
+                _tokenizer.skipContainer();
+            }
             break;
         }
 
-        // if the key is found, store the position of the value
-        if (find == key){
-            // store the position of the value, prepare for the next parsing
-            _cache_start = static_cast<int>(_tokenizer.getPos());
-#if DEBUG_LAZY_JSON
-    Serial.printf("Extractor: Found %s at %i\n", find.c_str(), _cache_start);
-#endif
-    
-            return *this;
+        // the same segment written as a key or an index (`a.0`, `a[0]`) and as a JSON Pointer
+        // segment (`/a/0`) are separate children, so a member matches at most two of them,
+        // a duplicate key is skipped, the first one wins (like `filter()`)
+        size_t matched[2];
+        size_t count = 0;
+        if (is_object){
+            token = _tokenizer.getToken(longest);
+            if (token.type == TOKEN_TYPE::COMMA){
+                continue;
+            }
+            if (token.type == TOKEN_TYPE::CURLY_CLOSE){
+                break;
+            }
+            // key must be a string
+            if (token.type != TOKEN_TYPE::STRING){
+                break;
+            }
+            uint32_t token_hash = 0;
+            for (size_t c : node.children){
+                const path_segment &segment = paths.node(c).segment;
+                if (count < 2 && !resolved[c] && segment.is_key &&
+                    _key_equals(token, segment.key.data(), segment.key.size(), segment.hash, token_hash)){
+                    matched[count++] = c;
+                }
+            }
+            // colon must be next
+            if (_tokenizer.getToken().type != TOKEN_TYPE::COLON){
+                break;
+            }
+        } else{
+            // only the first character of the value is read
+            char next = _tokenizer.peekChar();
+            if (next == ','){
+                static_cast<void>(_tokenizer.getToken());
+                continue;
+            }
+            if (next == ']' || next == 0){
+                static_cast<void>(_tokenizer.getToken());
+                break;
+            }
+            for (size_t c : node.children){
+                if (count < 2 && !resolved[c] && paths.node(c).segment.index == i){
+                    matched[count++] = c;
+                }
+            }
+            i++;
         }
-        // value of the key is not parsed yet, so we need to skip it
-        token = _tokenizer.getToken();
 
-    #if DEBUG_LAZY_JSON
-        Serial.printf("Extractor: Parsing object value %s = %s \n",
-            verboseTokenType(token.type).c_str(), token.value.c_str());
-    #endif
-        // nested objects are not evaluated, so we need to skip them
-        if (token.type == TOKEN_TYPE::CURLY_OPEN){
-            fast_forward(_tokenizer.getPos(), TOKEN_TYPE::CURLY_OPEN, TOKEN_TYPE::CURLY_CLOSE, &_tokenizer);
+        if (!count){
+            _tokenizer.skipValue();
+            continue;
         }
-        // lists are not evaluated, so we need to skip them
-        else if (token.type == TOKEN_TYPE::ARRAY_OPEN){
-            fast_forward(_tokenizer.getPos(), TOKEN_TYPE::ARRAY_OPEN, TOKEN_TYPE::ARRAY_CLOSE, &_tokenizer);
+        // every matching child resolves the same value, it's read again from its start,
+        // streamed data is kept in the buffer until the last one
+        size_t member_pos = _tokenizer.getPos();
+        size_t hold = count > 1 && member_pos < keep ? member_pos : keep;
+        for (size_t m = 0; m < count; m++){
+            if (m){
+                _tokenizer.setPos(member_pos);
+            }
+            resolved[matched[m]] = true;
+            _resolve(paths, matched[m], results, resolved, remaining, true, deep, hold);
         }
+        _hold(keep);
     }
+    remaining = done;
+}
 
-    // if the key is not found, set the value as null
-    _is_null = true;
+extractor &extractor::filter(const std::string &find)
+{
+    return _filter_key(find.data(), find.size(), path_hash(find.data(), find.size()));
+}
 
-    return *this;
+bool extractor::_key_equals(const Token &token, const char *key, size_t length, uint32_t hash, uint32_t &token_hash)
+{
+    if (token.escaped || token.dropped){
+        return _tokenizer.equals(token, key, length);
+    }
+    if (token.length != length){
+        return false;
+    }
+    // the length and the hash are compared before the bytes, the key is hashed
+    // once (0 until then) and only if a key of the same length is looked for
+    const char *data = _tokenizer._stream.at(token.start);
+    if (!token_hash){
+        token_hash = path_hash(data, length);
+    }
+    return token_hash == hash && memcmp(data, key, length) == 0;
 }
 
-extractor &extractor::filter(int index)
+extractor &extractor::_filter_key(const char *find, size_t length, uint32_t hash)
 {
-    _tokenizer.setPos(_cache_start);
-    // if the value was not found or has null type, no need to parse
-    if (_is_null || _instance_type() == LazyType::NULL_TYPE){
+    if (!_enter(LazyType::OBJECT)){
         return *this;
     }
 
-    _validate(LazyType::LIST);
-    // array open token
-    _tokenizer.getToken();
-    int i = 0, value_pos = 0;
+    size_t object = _cache_start;
+    bool memo = _memo_enabled();
+    if (memo){
+        size_t value = _memo.findKey(object, find, length, hash, _tokenizer._stream.data());
+        if (value != MEMO_NONE){
+            _check(object, value);
+            _cache_start = value;
+            return *this;
+        }
+    }
+    // only the keys are compared, streamed data can be dropped as soon as it's read
+    _unpin();
+    
     Token token;
 
-    while (_tokenizer.hasTokens()){
+#if DEBUG_LAZY_JSON
+    Serial.printf("Extractor: Filtering %.*s, json = %s\n", int(length), find, _tokenizer._stream.data());
+#endif
 
-        // value of the list
-        value_pos = static_cast<int>(_tokenizer.getPos());
-        token = _tokenizer.getToken();
+    // a malformed container can break the scan itself (e.g. an unterminated string),
+    // in touched mode it's reported as malformed
+    try{
+        while (_tokenizer.hasTokens()){
+            // key of the object, a raw key has at most 6 bytes (`\uXXXX`) per byte of `find`,
+            // longer ones can't match and don't have to fit in the streaming buffer
+            token = _tokenizer.getToken(6 * length);
+
+        #if DEBUG_LAZY_JSON
+            Serial.printf("Extractor: Parsing object token %s = %s\n",
+                verboseTokenType(token.type).c_str(), _tokenizer.str(token).c_str());
+        #endif
+
+            if (token.type == TOKEN_TYPE::COMMA){
+                continue;
+            }
+            if (token.type == TOKEN_TYPE::CURLY_CLOSE){
+                break; 
+            }        
+
+            // key must be a string    
+            if (token.type != TOKEN_TYPE::STRING){   
+                break;
+            }
+        #if DEBUG_LAZY_JSON
+            Serial.printf("Extractor: Parsing object key %s \n", _tokenizer.str(token).c_str());
+        #endif
+            // compare before reading further, the key may be dropped from the streaming buffer
+            uint32_t token_hash = 0;
+            bool found = _key_equals(token, find, length, hash, token_hash);
+
+            // colon must be next
+            if (_tokenizer.getToken().type != TOKEN_TYPE::COLON){
+                break;
+            }
+
+            // if the key is found, store the position of the value
+            if (found){
+                // the object is checked up to the value
+                _check(object, _tokenizer.getPos());
+                // store the position of the value, prepare for the next parsing
+                _cache_start = _tokenizer.getPos();
+                _tokenizer.pin(_cache_start);
+                // escaped keys can't be verified against the raw json
+                if (memo && !token.escaped){
+                    _memo.addKey(object, token.start, length, hash, _cache_start, _tokenizer._stream.data());
+                }
+#if DEBUG_LAZY_JSON
+        Serial.printf("Extractor: Found %.*s at %lu\n", int(length), find, (unsigned long)_cache_start);
+#endif
+    
+                return *this;
+            }
+            // value of the key is not parsed, it ends at the next structural character
+            // (nested objects and lists at their closing bracket)
+            _tokenizer.skipValue();
+        }
+    } catch (const invalid_json &){
+        throw;
+    } catch (const std::runtime_error &){
+        _check(object);
+        throw;
+    }
+    _check(object);
 
-    #if DEBUG_LAZY_JSON
-        Serial.printf("Extractor: Parsing list token %s \n",
-            verboseTokenType(token.type).c_str());
-    #endif
+    // if the key is not found, set the value as null
+    _is_null = true;
 
-        if (token.type == TOKEN_TYPE::COMMA){
-            continue;
+    return *this;
+}
+
+extractor &extractor::filter(int index)
+{
+    if (!_enter(LazyType::LIST)){
+        return *this;
+    }
+    size_t list = _cache_start, value_pos = 0;
+    int i = 0;
+    // the furthest element known before and after this walk
+    int known = -1, walked = -1;
+    size_t known_pos = 0;
+    bool memo = _memo_enabled();
+    if (memo){
+        size_t value = _memo.findIndex(list, index);
+        if (value != MEMO_NONE){
+            _check(list, value);
+            _cache_start = value;
+            return *this;
         }
-        if (token.type == TOKEN_TYPE::ARRAY_CLOSE){
-            break; 
-        }     
-
-        // if the index is found, store the position of the value
-        if (i == index){
-            // store the position of the value, prepare for the next parsing
-            _cache_start = value_pos;
+        if (_memo.frontier(list, known, known_pos) && known < index){
+            // continue the walk right after the furthest known element,
+            // the list is checked up to it before it's skipped
+            _check(list, known_pos);
+            _tokenizer.setPos(known_pos);
+            _tokenizer.skipValue();
+            i = known + 1;
+        }
+    }
+    _unpin();
+
+    // a malformed container can break the scan itself (e.g. an unterminated string),
+    // in touched mode it's reported as malformed
+    try{
+        while (_tokenizer.hasTokens()){
+
+            // value of the list, only its first character is read
+            value_pos = _tokenizer.getPos();
+            char next = _tokenizer.peekChar();
+
+        #if DEBUG_LAZY_JSON
+            Serial.printf("Extractor: Parsing list value %c \n", next);
+        #endif
+
+            if (next == ','){
+                static_cast<void>(_tokenizer.getToken());
+                continue;
+            }
+            if (next == ']' || next == 0){
+                static_cast<void>(_tokenizer.getToken());
+                break; 
+            }     
+
+            if (memo){
+                _memo.addIndex(list, i, value_pos);
+                walked = i;
+                known_pos = value_pos;
+            }
+
+            // if the index is found, store the position of the value
+            if (i == index){
+                // the list is checked up to the element
+                _check(list, value_pos);
+                // store the position of the value, prepare for the next parsing
+                _cache_start = value_pos;
+                _tokenizer.pin(_cache_start);
+                if (walked > known){
+                    _memo.setFrontier(list, walked, known_pos);
+                }
 #if DEBUG_LAZY_JSON
-    Serial.printf("Found %i at %i\n", index, _cache_start);
+        Serial.printf("Found %i at %lu\n", index, (unsigned long)_cache_start);
 #endif
-            return *this;
-        }   
+                return *this;
+            }   
 
-        // value of the key is not parsed yet, so we need to skip it
-        if (token.type == TOKEN_TYPE::CURLY_OPEN){
-            fast_forward(_tokenizer.getPos(), TOKEN_TYPE::CURLY_OPEN, TOKEN_TYPE::CURLY_CLOSE, &_tokenizer);
-        }
-        else if (token.type == TOKEN_TYPE::ARRAY_OPEN){
-            fast_forward(_tokenizer.getPos(), TOKEN_TYPE::ARRAY_OPEN, TOKEN_TYPE::ARRAY_CLOSE, &_tokenizer);
+            // value is not parsed, it ends at the next structural character
+            // (nested objects and lists at their closing bracket)
+            _tokenizer.skipValue();
+            i++;
         }
-        i++;
+    } catch (const invalid_json &){
+        throw;
+    } catch (const std::runtime_error &){
+        _check(list);
+        throw;
     }
+    if (walked > known){
+        _memo.setFrontier(list, walked, known_pos);
+    }
+    _check(list);
 
     // if the index is not found, set the value as null
     _is_null = true;
@@ -276,6 +860,47 @@ extractor &extractor::filter(int index)
     return *this;
 }
 
+void extractor::_filter_segment(const char *key, size_t length, uint32_t hash, int index, bool is_key)
+{
+    if (index < 0){
+        static_cast<void>(_filter_key(key, length, hash));
+    }
+    else if (!is_key){
+        static_cast<void>(filter(index));
+    }
+    else{
+        // numeric JSON Pointer segment, index for lists, key for objects
+        _tokenizer.setPos(_cache_start);
+        if (_instance_type() == LazyType::LIST){
+            static_cast<void>(filter(index));
+        } else{
+            static_cast<void>(_filter_key(key, length, hash));
+        }
+    }
+}
+
+extractor &extractor::filter(const path &query)
+{
+    for (const path_segment &segment : query){
+        if (_is_null){
+            break;
+        }
+        _filter_segment(segment.key.data(), segment.key.size(), segment.hash, segment.index, segment.is_key);
+    }
+    return *this;
+}
+
+extractor &extractor::filter(const static_path &query)
+{
+    for (const static_segment &segment : query){
+        if (_is_null){
+            break;
+        }
+        _filter_segment(segment.key, segment.length, segment.hash, segment.index, segment.is_key);
+    }
+    return *this;
+}
+
 extractor& extractor::operator[](const std::string& key){
     return filter(key);
 }
@@ -284,10 +909,28 @@ extractor& extractor::operator[](int index){
     return filter(index);
 }
 
+extractor& extractor::operator[](const path& query){
+    return filter(query);
+}
+
+extractor& extractor::operator[](const static_path& query){
+    return filter(query);
+}
+
 bool extractor::isNull(){
+    // like `extract()`, the next filter starts from the root again
+    bool is_null = _is_null;
+    _is_null = false;
+    if (!is_null && _check_touched && !_streaming){
+        // only the type is read, the value is checked up to its first token (a literal as a whole)
+        _tokenizer.setPos(_cache_start);
+        static_cast<void>(_tokenizer.peekChar());
+        size_t start = _tokenizer.getPos();
+        _check(start, start + 1);
+    }
     _tokenizer.setPos(_cache_start);
     _reset_cache();
-    return _is_null || _instance_type() == LazyType::NULL_TYPE;
+    return is_null || _instance_type() == LazyType::NULL_TYPE;
 }
 
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
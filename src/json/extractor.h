@@ -11,8 +11,20 @@ elements are going to be used.
 
 
 #include <string>
+#if __cplusplus >= 201703L
+#   include <string_view>
+#endif
 
 #include "wrappers.h"
+#include "path.h"
+#include "memo.h"
+#include "iterators.h"
+#include "binding.h"
+#include "document.h"
+#include "validator.h"
+#include "../stream/mapped_file.h"
+
+#include <memory>
 
 
 BEGIN_LAZY_JSON_NAMESPACE
@@ -81,36 +93,210 @@ e.reset(); // reset the parsing json string to initial state (the whole json obj
 e["key2"].extract().asString(); // "value"
 ```
 
-The memory footprint of the `extractor` class is very low,
-it doesn't allocate any memory on the heap, and doesn't copy the json string
-(except for the `cache()` method, which stores the cached json string).
+The memory footprint of the `extractor` class is very low, creating or copying it
+doesn't allocate any memory on the heap (the filters allocate only the offset memo table,
+once, see `memoize()`), and doesn't copy the json string
+(`cache()` only stores the start and the end of the cached value).
 
 */
+/// @brief Window of a cached value in the json, `end` is exclusive
+typedef struct
+{
+    size_t start;
+    size_t end;
+} cache_scope;
+
+/// @brief Part of a value checked in `validation_mode::touched`
+typedef struct
+{
+    // start of the value, `SIZE_MAX` for an empty slot
+    size_t start;
+    // end of the checked part, `SIZE_MAX` if the whole value was checked
+    size_t end;
+    // where the check of an object / list continues from
+    validation_frontier frontier;
+} checked_value;
+
 class extractor
 {
     char* _data;
-    std::string _json;
-    int _start;
-    int _end;
-    int _cache_start;
+    size_t _size;
+    // cached values, from the outermost to the innermost (current) one
+    cache_scope _scopes[LAZY_JSON_MAX_SCOPES];
+    size_t _depth;
+    size_t _start;
+    size_t _end;
+    size_t _cache_start;
     Tokenizer _tokenizer;
+    offset_memo _memo;
+    // parsed values of the document, shared with the wrappers holding them,
+    // the default one is created by the first parsed object / list
+    std::shared_ptr<arena> _arena;
+    // `useArena(nullptr)` was called (or `LAZY_JSON_ARENA_BLOCK` is 0), the nodes are allocated on the heap
+    bool _heap_nodes;
     bool _is_null;
+    bool _streaming;
+    // keeps the json alive (document, memory mapping) as long as any copy of the extractor uses it
+    std::shared_ptr<const void> _source;
+    // `validation_mode::touched`
+    bool _check_touched;
+    // the last touched values, `_checked_next` is the oldest one
+    checked_value _checked[LAZY_JSON_CHECKED_VALUES];
+    size_t _checked_next;
 
     LazyType _instance_type();
     void _validate(const LazyType &expected);
+    bool _enter(LazyType expected);
+    extractor &_filter_key(const char *key, size_t length, uint32_t hash);
+    bool _key_equals(const Token &token, const char *key, size_t length, uint32_t hash, uint32_t &token_hash);
+    void _filter_segment(const char *key, size_t length, uint32_t hash, int index, bool is_key);
+    bool _memo_enabled();
+    arena *_parse_arena();
+    bool _is_container(size_t pos);
+    wrapper _wrap(const LazyTypedValues &value);
+    void _resolve(const path_set &paths, size_t node, std::vector<wrapper> &results, std::vector<bool> &resolved,
+                  size_t &remaining, bool consume, bool deep, size_t keep);
     void _reset_cache();
-    void _set_cache();
+    void _push_scope(size_t start, size_t end);
+    void _set_scope();
+    void _unpin();
+    void _hold(size_t keep);
+    bool _decode_begin(Token &token);
+    void _decode_end();
+    void _check(size_t start, size_t stop = size_t(-1));
+    void _forget_checked();
+
+    friend class container_range;
 public:
+    /// @brief Creates extractor over null-terminated json string, the string is not copied
     extractor(const char *json);
+
+    /// @brief Creates extractor over `length` bytes of json, the data doesn't have to be
+    /// null-terminated (network buffers, memory mapped files) and is not copied
+    extractor(const char *json, size_t length);
+
+#if __cplusplus >= 201703L
+    /// @brief Creates extractor over the viewed json, the data is not copied
+    extractor(std::string_view json);
+#endif
+
+    /*
+    Creates forward-only extractor over json pulled through `reader` into a buffer of
+    `buffer_size` bytes, the consumed data is dropped, so the whole json is never held in memory.
+    Reading stops as soon as the filtered value is found, the peak memory is the buffer.
+
+    - the filtered value (object, list or string) must fit in the buffer, skipped values
+      and keys longer than the filtered one don't have to
+    - the filters can only move forward, after `extract()` the next filter starts again
+      from the root, which works only if it's still in the buffer
+    - `reset()` throws, `cache()` the value to read it multiple times (it has to fit in the buffer)
+
+    ```
+    WiFiClient client;
+    ...
+    extractor ex([&](char *buffer, size_t size) { return client.readBytes(buffer, size); }, 512);
+    ex["list"][3]["main"].cache();
+    ex["temp"].extract().as<float>();
+    ex["humidity"].extract().asInt();
+    ```
+    */
+    extractor(stream_reader reader, size_t buffer_size = 512);
+
+    /// @brief Creates extractor over the document, see `cursor`
+    explicit extractor(const document &doc);
+
     ~extractor();
 
+#if LAZY_JSON_MMAP
+    /// @brief Creates extractor over a read-only memory mapping of the file at `path`,
+    /// the file is not read into memory. Only the pages touched by the extraction are loaded,
+    /// the mapping is released when the extractor (and all of its copies) is destroyed.
+    /// @param pattern access-pattern hint for the kernel
+    /// @throw `std::runtime_error` if the file can't be opened or mapped
+    static extractor from_file(const char *path, access_pattern pattern = access_pattern::sequential);
+#endif
+
     /// @brief Resets the start and end positions of the parsing.
-    /// Resets the json string to the initial state.
+    /// Resets the json string to the initial state, all cached scopes are dropped.
+    /// @throw `std::runtime_error` for streamed json
     void reset();
 
-    /// @brief Sets the initial json string.
+    /// @brief Sets the capacity of the offset memo (entries, rounded up to a power of two),
+    /// 0 disables it. Default is `LAZY_JSON_MEMO_SIZE`. The memoized offsets are dropped,
+    /// the table is allocated by the next filter.
+    ///
+    /// The memo remembers where the values of already filtered keys and list elements start,
+    /// so repeated lookups, or lookups sharing a prefix, jump straight to the value instead of
+    /// scanning from the root. It's kept until the json changes (`set()`), `reset()` doesn't clear it.
+    /// Streamed json is never memoized.
+    void memoize(size_t capacity);
+
+    /// @brief Hit / miss counters and the size of the offset memo
+    const memo_stats &memoStats() const;
+
+    /*
+    Check that the json is well-formed (grammar, strings, UTF-8, nesting), see `validate()`.
+    The extraction itself trusts the json, malformed input may be misread instead of rejected.
+
+    - `validation_mode::full` - the whole json (passed to `set()`), right away
+    - `validation_mode::touched` - from now on, only what the extraction reads, right before it's read:
+      the part of every object / list a filter scans (up to the value found, all of it if the value
+      is not there), the whole extracted, decoded or iterated value and the first token of a value
+      tested by `isNull()`. The part a list walk continues from (see `memoize()`) is checked before
+      it's skipped, and a scan broken by malformed json reports it as `invalid_json`. The checked
+      parts of the last `LAZY_JSON_CHECKED_VALUES` values are remembered until the json changes,
+      so repeated lookups are not checked again, and a lookup further into an object / list
+      continues its check from where the previous one stopped.
+    - `validation_mode::none` - stop checking (default)
+
+    ```
+    ex.validate(validation_mode::touched);
+    ex["list"][3]["main"]["temp"].extract(); // checks "list" up to [3], [3] up to "main", ...
+    ```
+
+    @throw `lazyjson::invalid_json` if the json is malformed (touched: thrown by the filter or
+    the extraction reading the malformed part)
+    @throw `std::runtime_error` for streamed json
+    */
+    void validate(validation_mode mode = validation_mode::full);
+
+    /*
+    Allocate the parsed values (objects, lists, their keys and children) from `memory`,
+    instead of one heap allocation per node. The arena is shared by the extractor and the wrappers
+    holding its values, and is dropped at once when the last of them goes away. Once no wrapper
+    holds any value, the next `extract()` reuses the arena from the start.
+    By default every extractor has its own arena (`LAZY_JSON_ARENA_BLOCK`), nullptr allocates
+    every node on the heap. Streamed json always uses an arena: its buffer is reused,
+    so the extracted strings are copied into the arena and the wrappers holding them keep it alive.
+
+    ```
+    static char buffer[4096];
+    ex.useArena(std::make_shared<arena>(buffer, sizeof(buffer), null_upstream()));
+    ```
+    */
+    void useArena(std::shared_ptr<arena> memory);
+
+    /// @brief Sets the initial null-terminated json string.
     extractor &set(const char *json);
 
+    /// @brief Sets the initial json, `length` bytes long, doesn't have to be null-terminated.
+    extractor &set(const char *json, size_t length);
+
+#if __cplusplus >= 201703L
+    /// @brief Sets the initial json.
+    extractor &set(std::string_view json);
+#endif
+
+    /// @brief Sets the streamed json, see `extractor(stream_reader, size_t)`.
+    extractor &set(stream_reader reader, size_t buffer_size = 512);
+
+    /// @brief Limits the extraction to the json in `[start, end)`, e.g. one record of a
+    /// newline-delimited document. Nothing past `end` is read, the positions (and `json()`
+    /// of the parsed values) stay those of the whole json, `reset()` goes back to all of it.
+    /// The cached scopes are dropped.
+    /// @throw `std::runtime_error` for streamed json
+    extractor &select(size_t start, size_t end);
+
     /*
     The `cache()` method is used to store the current parsing value.
     This is useful when the value is going to be accessed multiple times,
@@ -119,7 +305,9 @@ public:
     slower parsing, can be avoided by caching the value. This way, the parsing
     is done minimum times.
 
-    Overrides the previous cached value and sets the cached json string as the current json string.
+    Narrows the extractor to the filtered value, the next filters start from it
+    instead of the root. Nothing is copied, only the window of the value in the json
+    is pushed onto a stack of scopes, `pop()` goes back to the enclosing one.
     Caching can be done on any value, including objects, lists, numbers, strings, etc.
     
 
@@ -149,16 +337,76 @@ public:
     e[1].extract().as<float>(); // 1.5
     e[2].extract().as<bool>(); // true
 
+    e.pop(); // back to the object at "key"
+    e["subkey3"].extract().asInt(); // 3
+
     e.reset(); // reset the parsing json string to initial state (the whole json object)
 
     e["key2"].extract().asString(); // "value"
     ```
 
+    The scopes are kept in the extractor itself, up to `LAZY_JSON_MAX_SCOPES` of them,
+    caching one more throws `std::runtime_error`.
+
     */ 
     void cache();
 
-    /// @brief Returns the `cached` json string.
-    const std::string& json();
+    /// @brief Goes back to the scope enclosing the current `cache()`d value
+    /// (the root after the first one), nothing happens at the root.
+    void pop();
+
+    /// @brief Number of `cache()`d scopes, 0 at the root
+    size_t depth() const;
+
+    /// @brief Returns a copy of the `cached` json string, empty at the root.
+    /// Returned by value, the cached value is not copied by `cache()` anymore.
+    std::string json();
+
+    /*
+    Iterate over the elements of the filtered list in a single forward pass, each element is
+    visited once, instead of walking the list from its head for every `filter(int)`.
+    The current element is a `cache()`d scope, the filters inside the loop start from it.
+    A missing value is an empty list. Works on streamed json too, if an element fits in the buffer.
+
+    ```
+    for (auto day : ex["list"].elements()){
+        day["main"]["temp"].extract().asFloat();
+    }
+    ```
+
+    @throw `json::lazy::invalid_type` if the value is not a list.
+    */
+    element_range elements();
+
+    /*
+    Iterate over the members of the filtered object in a single forward pass,
+    see `elements()`. The keys are decoded.
+
+    ```
+    for (auto [key, value] : ex["main"].items()){
+        value.extract().asFloat();
+    }
+    ```
+
+    @throw `json::lazy::invalid_type` if the value is not an object.
+    */
+    item_range items();
+
+    /*
+    Iterate over the json documents stored back to back in the buffer or stream (e.g. several
+    messages in one WebSocket / TCP frame), with no delimiter or only whitespace between them.
+    Each document is a `cache()`d scope while it's visited, like an element of `elements()`,
+    its end is found by the same structural scan that skips values during the extraction,
+    so the data is read once. Streamed documents must fit in the buffer.
+
+    ```
+    extractor ex("{\"id\": 1}{\"id\": 2}\n{\"id\": 3}");
+    for (auto doc : ex.documents()){
+        doc["id"].extract().asInt();
+    }
+    ```
+    */
+    document_range documents();
 
     /// @brief Filters the JSON string by a key, the result is not extracted (parsed), 
     /// to get the value use the `extract()` method. If the key is not found, nothing happens and
@@ -176,12 +424,30 @@ public:
     /// @return *this
     extractor &filter(int index);
 
+    /// @brief Filters the JSON string by every segment of the compiled path,
+    /// same as chaining `filter()` calls, without building the keys again. See `path`.
+    /// @throw `json::lazy::invalid_type` if a segment doesn't match the value type.
+    /// @return *this
+    extractor &filter(const path &query);
+
+    /// @brief Filters the JSON string by every segment of the path literal (`"main.temp"_jp`),
+    /// nothing is allocated, the keys are hashed at compile time. See `static_path`.
+    /// @throw `json::lazy::invalid_type` if a segment doesn't match the value type.
+    /// @return *this
+    extractor &filter(const static_path &query);
+
     /// @brief Filters the JSON string by a key, same as `filter(const std::string &key)`
     extractor &operator[](const std::string &key);
 
     /// @brief Filters the JSON string by an index, same as `filter(int index)`
     extractor &operator[](int index);
 
+    /// @brief Filters the JSON string by a compiled path, same as `filter(const path &query)`
+    extractor &operator[](const path &query);
+
+    /// @brief Filters the JSON string by a path literal, same as `filter(const static_path &query)`
+    extractor &operator[](const static_path &query);
+
     /*
     Extract the current filtered value. The value is parsed and returned as a wrapper.
     See also `cache()` method for caching the value and optimizing the parsing.
@@ -207,6 +473,46 @@ public:
     */
     wrapper extract();
 
+    /*
+    Extract every path of the set in a single forward pass over the filtered value
+    (the paths are relative to it). Subtrees no path goes into are skipped, and the
+    scanning stops as soon as all of the paths are resolved.
+
+    Returns the values indexed by the path id, paths that are not found,
+    or don't match the value types (e.g. a key of a list) are null.
+
+    ```
+    const path_set fields({path("city.name"), path("list[0].main.temp"), path("list[1].main.temp")});
+    auto values = e.extract(fields);
+    values[1].asFloat();
+
+    e["list"][0].extract(path_set({path("main.temp"), path("wind.speed")}));
+    ```
+
+    With `deep`, the objects and lists found are parsed as a whole, so reading them never
+    goes back to the json through the extractor (e.g. when they are handed to another thread).
+    */
+    std::vector<wrapper> extract(const path_set &paths, bool deep = false);
+
+    /*
+    Decode the filtered object into a struct bound with `LAZY_JSON_BIND`, in a single forward
+    pass: the keys are dispatched to the members with a compile-time perfect hash, nested bound
+    structs and `std::vector`s are decoded in the same pass, unbound members are skipped.
+    Members missing in the json keep their values. Works on streamed json too, nothing has to
+    fit in the buffer except a single string.
+
+    ```
+    weather_report report;
+    ex.decode(report);
+    ex["list"][0].decode(forecast);
+    ```
+
+    @return false if the value was not found (or null), `out` is not changed
+    @throw `json::lazy::invalid_type` if a value doesn't match the type of its member
+    */
+    template <class T>
+    bool decode(T &out);
+
     /*
     Checks wheter the value was not found.
 
@@ -238,4 +544,49 @@ public:
 };
 
 
+/*
+Navigation state over a shared, immutable `document`: the position, the cached scopes,
+the memo and the arena of the parsed values. Cheap to create (nothing is allocated, the memo
+table is allocated by the first filter and the arena by the first parsed object / list), one per thread, a cursor itself
+must not be used by two threads at once. The document must outlive the cursor only if
+it references the json, owned and mapped json is kept alive by the cursor and by the
+extracted strings, objects and lists.
+
+```
+const document doc(std::move(payload));
+// in every worker
+cursor cur(doc);
+cur["list"][3]["main"]["temp"].extract().asFloat();
+```
+*/
+class cursor : public extractor
+{
+public:
+    cursor(const document &doc);
+};
+
+template <class T>
+bool extractor::decode(T &out)
+{
+    try{
+        Token token;
+        if (!_decode_begin(token)){
+            return false;
+        }
+        binding_reader reader(_tokenizer);
+        decode_value(reader, token, out);
+    } catch (...){
+        _decode_end();
+        throw;
+    }
+    _decode_end();
+    return true;
+}
+
+template <class T>
+bool element_view::decode(T &out)
+{
+    return _ex->decode(out);
+}
+
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,312 @@
+#include "extractor.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+element_view::element_view(extractor *ex) : _ex(ex) {}
+
+extractor &element_view::filter(const std::string &key)
+{
+    return _ex->filter(key);
+}
+
+extractor &element_view::filter(int index)
+{
+    return _ex->filter(index);
+}
+
+extractor &element_view::filter(const path &query)
+{
+    return _ex->filter(query);
+}
+
+extractor &element_view::filter(const static_path &query)
+{
+    return _ex->filter(query);
+}
+
+extractor &element_view::operator[](const std::string &key)
+{
+    return _ex->filter(key);
+}
+
+extractor &element_view::operator[](int index)
+{
+    return _ex->filter(index);
+}
+
+extractor &element_view::operator[](const path &query)
+{
+    return _ex->filter(query);
+}
+
+extractor &element_view::operator[](const static_path &query)
+{
+    return _ex->filter(query);
+}
+
+wrapper element_view::extract()
+{
+    return _ex->extract();
+}
+
+std::vector<wrapper> element_view::extract(const path_set &paths)
+{
+    return _ex->extract(paths);
+}
+
+bool element_view::isNull()
+{
+    return _ex->isNull();
+}
+
+std::string element_view::json()
+{
+    return _ex->json();
+}
+
+container_range::container_range(extractor *ex, bool object)
+    : _ex(ex), _depth(ex->_depth), _next(0), _index(0), _object(object), _sequence(false), _done(false)
+{
+    if (!_ex->_is_null)
+    {
+        _ex->_check(_ex->_cache_start);
+    }
+    if (!_ex->_enter(object ? LazyType::OBJECT : LazyType::LIST))
+    {
+        // the value was not found, nothing to iterate
+        _finish();
+        return;
+    }
+    _next = _ex->_tokenizer.getPos();
+    _advance();
+}
+
+container_range::container_range(extractor *ex)
+    : _ex(ex), _depth(ex->_depth), _next(ex->_cache_start), _index(0),
+      _object(false), _sequence(true), _done(false)
+{
+    // the documents are read like the elements of a list without brackets and commas
+    _advance();
+}
+
+container_range::container_range(container_range &&other)
+    : _ex(other._ex), _depth(other._depth), _next(other._next), _index(other._index),
+      _object(other._object), _sequence(other._sequence), _done(other._done), _key(std::move(other._key))
+{
+    other._ex = nullptr;
+}
+
+container_range::~container_range()
+{
+    // left early (break, exception), drop the scope of the current element
+    if (_ex && !_done)
+    {
+        _finish();
+    }
+}
+
+void container_range::_advance()
+{
+    Tokenizer &tokenizer = _ex->_tokenizer;
+    // the scope of the previous element (and whatever was cached inside the loop)
+    _ex->_depth = _depth;
+    tokenizer.setPos(_next);
+    tokenizer.pin(_next);
+
+    while (tokenizer.hasTokens())
+    {
+        if (_sequence)
+        {
+            // the documents may be followed by whitespace only
+            if (!tokenizer.skipWhiteSpace())
+            {
+                break;
+            }
+            _ex->_check(tokenizer.getPos());
+        }
+        Token token = tokenizer.getToken();
+        if (token.type == TOKEN_TYPE::COMMA)
+        {
+            continue;
+        }
+        if (token.type == TOKEN_TYPE::CURLY_CLOSE || token.type == TOKEN_TYPE::ARRAY_CLOSE)
+        {
+            break;
+        }
+
+        if (_object)
+        {
+            // key must be a string followed by a colon
+            if (token.type != TOKEN_TYPE::STRING)
+            {
+                break;
+            }
+            // copied right away, streamed data before the value may be dropped
+            _key.clear();
+            if (token.escaped)
+            {
+                unescape(tokenizer._stream.at(token.start), token.length, _key);
+            }
+            else
+            {
+                _key.append(tokenizer._stream.at(token.start), token.length);
+            }
+            if (tokenizer.getToken().type != TOKEN_TYPE::COLON)
+            {
+                break;
+            }
+            token = tokenizer.getToken();
+        }
+
+        // the scope starts right at the value, without the whitespace before it
+        size_t value_pos = token.type == TOKEN_TYPE::STRING ? token.start - 1 : token.start;
+
+        // the element becomes the current scope, like `cache()`
+        if (token.type == TOKEN_TYPE::CURLY_OPEN || token.type == TOKEN_TYPE::ARRAY_OPEN)
+        {
+            tokenizer.skipContainer();
+        }
+        _next = tokenizer.getPos();
+        _ex->_push_scope(value_pos, _next);
+        _ex->_set_scope();
+        return;
+    }
+    _finish();
+}
+
+void container_range::_finish()
+{
+    _done = true;
+    _ex->_depth = _depth;
+    _ex->_set_scope();
+}
+
+bool container_range::done() const
+{
+    return _done;
+}
+
+size_t container_range::index() const
+{
+    return _index;
+}
+
+void container_range::next()
+{
+    if (!_done)
+    {
+        _index++;
+        _advance();
+    }
+}
+
+element_range::element_range(extractor *ex) : container_range(ex, false) {}
+
+element_range::iterator element_range::begin()
+{
+    return iterator(this);
+}
+
+element_range::iterator element_range::end()
+{
+    return iterator();
+}
+
+element_range::iterator::iterator(element_range *range) : _range(range) {}
+
+element_view element_range::iterator::operator*() const
+{
+    return element_view(_range->_ex);
+}
+
+element_range::iterator &element_range::iterator::operator++()
+{
+    _range->next();
+    return *this;
+}
+
+bool element_range::iterator::operator==(const iterator &other) const
+{
+    // every iterator of a finished range is the end
+    bool finished = !_range || _range->done();
+    return finished == (!other._range || other._range->done());
+}
+
+bool element_range::iterator::operator!=(const iterator &other) const
+{
+    return !(*this == other);
+}
+
+item_range::item_range(extractor *ex) : container_range(ex, true) {}
+
+item_range::iterator item_range::begin()
+{
+    return iterator(this);
+}
+
+item_range::iterator item_range::end()
+{
+    return iterator();
+}
+
+item_range::iterator::iterator(item_range *range) : _range(range) {}
+
+object_item item_range::iterator::operator*() const
+{
+    return object_item{_range->_key, element_view(_range->_ex)};
+}
+
+item_range::iterator &item_range::iterator::operator++()
+{
+    _range->next();
+    return *this;
+}
+
+bool item_range::iterator::operator==(const iterator &other) const
+{
+    bool finished = !_range || _range->done();
+    return finished == (!other._range || other._range->done());
+}
+
+bool item_range::iterator::operator!=(const iterator &other) const
+{
+    return !(*this == other);
+}
+
+document_range::document_range(extractor *ex) : container_range(ex) {}
+
+document_range::iterator document_range::begin()
+{
+    return iterator(this);
+}
+
+document_range::iterator document_range::end()
+{
+    return iterator();
+}
+
+document_range::iterator::iterator(document_range *range) : _range(range) {}
+
+element_view document_range::iterator::operator*() const
+{
+    return element_view(_range->_ex);
+}
+
+document_range::iterator &document_range::iterator::operator++()
+{
+    _range->next();
+    return *this;
+}
+
+bool document_range::iterator::operator==(const iterator &other) const
+{
+    bool finished = !_range || _range->done();
+    return finished == (!other._range || other._range->done());
+}
+
+bool document_range::iterator::operator!=(const iterator &other) const
+{
+    return !(*this == other);
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,195 @@
+#pragma once
+
+/*
+
+## Iterators
+
+Single pass over the members of an object or the elements of a list, see
+`extractor::items()` and `extractor::elements()`, or over the json documents stored back
+to back in one buffer or stream, see `extractor::documents()`. Every element is visited once,
+in the json order, the iteration never goes back to the head of the container.
+
+The current element is pushed as a `cache()`d scope of the extractor, so the
+filters inside the loop are relative to it, and `extract()` goes back to it.
+The scope is popped when the iteration moves on, the loop ends or is left early.
+
+```cpp
+using namespace lazyjson;
+
+extractor ex(json);
+for (auto day : ex["list"].elements()){
+    day["main"]["temp"].extract().asFloat();
+    day["dt"].extract().as<int64_t>();
+}
+
+for (auto [key, value] : ex["main"].items()){
+    Serial.printf("%s: %f\n", key.c_str(), value.extract().asFloat());
+}
+```
+
+*/
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+#include "wrappers.h"
+#include "path.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+class extractor;
+
+/// @brief Lightweight handle of the element visited by the iteration, the filters
+/// start from the element itself. Valid only until the iteration moves on.
+class element_view
+{
+    extractor *_ex;
+
+public:
+    element_view(extractor *ex);
+
+    /// @brief Same as `extractor::filter()`, relative to the element
+    extractor &filter(const std::string &key);
+    extractor &filter(int index);
+    extractor &filter(const path &query);
+    extractor &filter(const static_path &query);
+
+    extractor &operator[](const std::string &key);
+    extractor &operator[](int index);
+    extractor &operator[](const path &query);
+    extractor &operator[](const static_path &query);
+
+    /// @brief Parse the element
+    wrapper extract();
+
+    /// @brief Same as `extractor::extract(const path_set &)`, relative to the element
+    std::vector<wrapper> extract(const path_set &paths);
+
+    /// @brief Same as `extractor::decode()`, the element is decoded into the bound struct
+    template <class T>
+    bool decode(T &out);
+
+    bool isNull();
+
+    /// @brief Copy of the raw json of the element
+    std::string json();
+};
+
+/// @brief Member of the iterated object, the key is decoded (escape sequences)
+/// and owned by the iteration, valid only until it moves on
+typedef struct
+{
+    const std::string &key;
+    element_view value;
+} object_item;
+
+/// @brief State of a single pass over an object or a list. The range can't be copied,
+/// only one iteration is active at a time, its iterators are input iterators.
+class container_range
+{
+protected:
+    extractor *_ex;
+    // number of the extractor's scopes before the iteration
+    size_t _depth;
+    // position right after the current element
+    size_t _next;
+    size_t _index;
+    bool _object;
+    // top-level values, not a container
+    bool _sequence;
+    bool _done;
+    std::string _key;
+
+    void _advance();
+    void _finish();
+
+    /// @brief Sequence of the top-level values from the start of the current scope
+    container_range(extractor *ex);
+
+public:
+    /// @throw `json::lazy::invalid_type` if the filtered value is not an object / a list
+    container_range(extractor *ex, bool object);
+    container_range(container_range &&other);
+    container_range(const container_range &) = delete;
+    container_range &operator=(const container_range &) = delete;
+    ~container_range();
+
+    /// @brief All elements were visited
+    bool done() const;
+
+    /// @brief Position of the current element in the container, starting at 0
+    size_t index() const;
+
+    /// @brief Move on to the next element
+    void next();
+};
+
+/// @brief Elements of a list, see `extractor::elements()`
+class element_range : public container_range
+{
+public:
+    class iterator
+    {
+        element_range *_range;
+
+    public:
+        iterator(element_range *range = nullptr);
+        element_view operator*() const;
+        iterator &operator++();
+        bool operator==(const iterator &other) const;
+        bool operator!=(const iterator &other) const;
+    };
+
+    element_range(extractor *ex);
+
+    iterator begin();
+    iterator end();
+};
+
+/// @brief Members (key, value) of an object, see `extractor::items()`
+class item_range : public container_range
+{
+public:
+    class iterator
+    {
+        item_range *_range;
+
+    public:
+        iterator(item_range *range = nullptr);
+        object_item operator*() const;
+        iterator &operator++();
+        bool operator==(const iterator &other) const;
+        bool operator!=(const iterator &other) const;
+    };
+
+    item_range(extractor *ex);
+
+    iterator begin();
+    iterator end();
+};
+
+/// @brief Json documents stored back to back (no delimiter, or just whitespace),
+/// see `extractor::documents()`
+class document_range : public container_range
+{
+public:
+    class iterator
+    {
+        document_range *_range;
+
+    public:
+        iterator(document_range *range = nullptr);
+        element_view operator*() const;
+        iterator &operator++();
+        bool operator==(const iterator &other) const;
+        bool operator!=(const iterator &other) const;
+    };
+
+    document_range(extractor *ex);
+
+    iterator begin();
+    iterator end();
+};
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,205 @@
+#include "memo.h"
+
+#include <string.h>
+#include <algorithm>
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+// linear probing is cut after this many slots, the home slot is overwritten then
+#define MEMO_MAX_PROBES 8
+
+static inline uint32_t _mix(uint32_t hash, size_t parent, int length)
+{
+    hash ^= uint32_t(uint64_t(parent) ^ (uint64_t(parent) >> 32)) * 0x9E3779B1u;
+    hash ^= uint32_t(length) * 0x85EBCA77u;
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+offset_memo::offset_memo(size_t capacity) : _mask(0)
+{
+    reserve(capacity);
+}
+
+void offset_memo::reserve(size_t capacity)
+{
+    size_t size = 0;
+    if (capacity)
+    {
+        size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+    }
+    // allocated by the first insert
+    std::vector<memo_entry>().swap(_table);
+    _mask = size ? size - 1 : 0;
+    _stats.entries = 0;
+    _stats.capacity = size;
+}
+
+void offset_memo::clear()
+{
+    if (_stats.entries)
+    {
+        std::fill(_table.begin(), _table.end(), memo_entry());
+        _stats.entries = 0;
+    }
+}
+
+bool offset_memo::enabled() const
+{
+    return _stats.capacity != 0;
+}
+
+/// @brief Keys are compared with the json, indices directly, the frontier is unique per list
+static inline bool _matches(const memo_entry &entry, size_t parent, size_t key, int length, const char *json, const char *find)
+{
+    if (entry.parent != parent || entry.length != length)
+    {
+        return false;
+    }
+    if (length >= 0)
+    {
+        return memcmp(json + entry.key, find, size_t(length)) == 0;
+    }
+    return length == MEMO_FRONTIER || entry.key == key;
+}
+
+memo_entry *offset_memo::_probe(uint32_t hash, size_t parent, size_t key, int length, const char *json, const char *find)
+{
+    if (_table.empty())
+    {
+        return nullptr;
+    }
+    size_t slot = hash & _mask;
+    for (int i = 0; i < MEMO_MAX_PROBES; i++, slot = (slot + 1) & _mask)
+    {
+        memo_entry &entry = _table[slot];
+        if (entry.parent == MEMO_NONE)
+        {
+            return nullptr;
+        }
+        if (_matches(entry, parent, key, length, json, find))
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void offset_memo::_insert(uint32_t hash, size_t parent, size_t key, int length, size_t value, const char *json)
+{
+    if (_table.empty())
+    {
+        _table.assign(_stats.capacity, memo_entry());
+    }
+    size_t slot = hash & _mask;
+    const char *find = length >= 0 ? json + key : nullptr;
+    for (int i = 0; i < MEMO_MAX_PROBES; i++, slot = (slot + 1) & _mask)
+    {
+        memo_entry &entry = _table[slot];
+        if (entry.parent == MEMO_NONE)
+        {
+            _stats.entries++;
+            break;
+        }
+        if (_matches(entry, parent, key, length, json, find))
+        {
+            break;
+        }
+        if (i == MEMO_MAX_PROBES - 1)
+        {
+            // every probed slot is taken, overwrite the home slot
+            slot = hash & _mask;
+            break;
+        }
+    }
+    memo_entry &entry = _table[slot];
+    entry.parent = parent;
+    entry.key = key;
+    entry.length = length;
+    entry.value = value;
+}
+
+size_t offset_memo::findKey(size_t parent, const char *find, size_t length, uint32_t hash, const char *json)
+{
+    if (!enabled())
+    {
+        return MEMO_NONE;
+    }
+    memo_entry *entry = _probe(_mix(hash, parent, int(length)), parent, 0, int(length), json, find);
+    if (!entry)
+    {
+        _stats.misses++;
+        return MEMO_NONE;
+    }
+    _stats.hits++;
+    return entry->value;
+}
+
+void offset_memo::addKey(size_t parent, size_t key, size_t length, uint32_t hash, size_t value, const char *json)
+{
+    if (enabled())
+    {
+        _insert(_mix(hash, parent, int(length)), parent, key, int(length), value, json);
+    }
+}
+
+size_t offset_memo::findIndex(size_t parent, int index)
+{
+    if (!enabled())
+    {
+        return MEMO_NONE;
+    }
+    memo_entry *entry = _probe(_mix(uint32_t(index), parent, MEMO_INDEX), parent, size_t(index), MEMO_INDEX, nullptr, nullptr);
+    if (!entry)
+    {
+        _stats.misses++;
+        return MEMO_NONE;
+    }
+    _stats.hits++;
+    return entry->value;
+}
+
+void offset_memo::addIndex(size_t parent, int index, size_t value)
+{
+    if (enabled())
+    {
+        _insert(_mix(uint32_t(index), parent, MEMO_INDEX), parent, size_t(index), MEMO_INDEX, value, nullptr);
+    }
+}
+
+bool offset_memo::frontier(size_t parent, int &index, size_t &value)
+{
+    if (!enabled())
+    {
+        return false;
+    }
+    memo_entry *entry = _probe(_mix(0, parent, MEMO_FRONTIER), parent, 0, MEMO_FRONTIER, nullptr, nullptr);
+    if (!entry)
+    {
+        return false;
+    }
+    index = int(entry->key);
+    value = entry->value;
+    return true;
+}
+
+void offset_memo::setFrontier(size_t parent, int index, size_t value)
+{
+    if (enabled())
+    {
+        _insert(_mix(0, parent, MEMO_FRONTIER), parent, size_t(index), MEMO_FRONTIER, value, nullptr);
+    }
+}
+
+const memo_stats &offset_memo::stats() const
+{
+    return _stats;
+}
+
+END_LAZY_JSON_NAMESPACE
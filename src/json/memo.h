@@ -0,0 +1,100 @@
+#pragma once
+
+/*
+
+Offset memo of the extractor. Remembers, per document, where the values of already
+filtered keys and list elements start, keyed by the position of the enclosing object / list.
+A repeated lookup (or one sharing a prefix, e.g. `ex["main"]["temp"]` and `ex["main"]["humidity"]`)
+jumps straight to the value instead of scanning the parent again.
+
+For every list walked, the furthest element reached is remembered as well, so asking
+for a later element continues the walk from there instead of the head of the list.
+
+The table has a fixed capacity (rounded up to a power of two) and is allocated by the first
+insert, so extractors (and their copies) that never filter twice cost nothing. When the probed
+slots are taken, the oldest entry in the home slot is overwritten. Keys are verified against the json
+itself, so a hash collision never returns a wrong value.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "../options.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+// empty slot, unknown position
+#define MEMO_NONE SIZE_MAX
+
+typedef struct
+{
+    // position of the enclosing object / list, `MEMO_NONE` for an empty slot
+    size_t parent = MEMO_NONE;
+    // position of the key in the json (objects), or the element index (lists and the frontier)
+    size_t key = 0;
+    // position of the value
+    size_t value = 0;
+    // length of the key, `MEMO_INDEX` for list elements, `MEMO_FRONTIER` for the furthest element
+    int length = 0;
+} memo_entry;
+
+typedef struct
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    // number of used slots
+    size_t entries = 0;
+    size_t capacity = 0;
+} memo_stats;
+
+#define MEMO_INDEX -1
+#define MEMO_FRONTIER -2
+
+class offset_memo
+{
+    std::vector<memo_entry> _table;
+    size_t _mask;
+    memo_stats _stats;
+
+    memo_entry *_probe(uint32_t hash, size_t parent, size_t key, int length, const char *json, const char *find);
+    void _insert(uint32_t hash, size_t parent, size_t key, int length, size_t value, const char *json);
+
+public:
+    offset_memo(size_t capacity = LAZY_JSON_MEMO_SIZE);
+
+    /// @brief Change the capacity (0 disables the memo), drops all entries,
+    /// the table is allocated by the next insert
+    void reserve(size_t capacity);
+
+    /// @brief Drop all entries (e.g. the document changed), the counters are kept
+    void clear();
+
+    bool enabled() const;
+
+    /// @brief Position of the value of `find` in the object at `parent`, `MEMO_NONE` if it's not known
+    /// @param json the document, used to verify the stored key
+    size_t findKey(size_t parent, const char *find, size_t length, uint32_t hash, const char *json);
+
+    /// @brief Remember the value of the key (at `key`, `length` bytes long) of the object at `parent`
+    void addKey(size_t parent, size_t key, size_t length, uint32_t hash, size_t value, const char *json);
+
+    /// @brief Position of the element `index` of the list at `parent`, `MEMO_NONE` if it's not known
+    size_t findIndex(size_t parent, int index);
+
+    /// @brief Remember the position of the element `index` of the list at `parent`
+    void addIndex(size_t parent, int index, size_t value);
+
+    /// @brief The furthest known element of the list at `parent`
+    /// @return false if the list was not walked yet
+    bool frontier(size_t parent, int &index, size_t &value);
+
+    /// @brief Update the furthest known element of the list at `parent`
+    void setFrontier(size_t parent, int index, size_t value);
+
+    const memo_stats &stats() const;
+};
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,222 @@
+#include "ndjson.h"
+
+#if LAZY_JSON_THREADS
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <string.h>
+
+#include "extractor.h"
+#include "scanner.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+// records cut at line breaks, the first one is the line `first_id`
+typedef struct
+{
+    size_t begin;
+    size_t end;
+    size_t first_id;
+} _batch;
+
+/// @brief Position right after the line break at or after `pos`, `size` if there is none
+static size_t _next_line(const char *data, size_t pos, size_t size)
+{
+    const void *found = pos < size ? memchr(data + pos, '\n', size - pos) : nullptr;
+    return found ? static_cast<const char *>(found) - data + 1 : size;
+}
+
+/// @brief Number of lines starting in `[begin, end)`
+static size_t _count_lines(const char *data, size_t begin, size_t end)
+{
+    size_t lines = 0;
+    while (begin < end)
+    {
+        begin = _next_line(data, begin, end);
+        lines++;
+    }
+    return lines;
+}
+
+/// @brief Point the parsed nodes to `tokenizer`, nothing is left to parse, it's used only by `json()`
+static void _retarget(LazyTypedValues &value, Tokenizer *tokenizer)
+{
+    if (value.type == LazyType::OBJECT)
+    {
+        value.values.object->_tokenizer = tokenizer;
+        for (auto &data : value.values.object->_list)
+        {
+            _retarget(data.value, tokenizer);
+        }
+    }
+    else if (value.type == LazyType::LIST)
+    {
+        value.values.list->_tokenizer = tokenizer;
+        for (auto &data : value.values.list->_list)
+        {
+            _retarget(data, tokenizer);
+        }
+    }
+}
+
+/// @brief Extract the paths from every non-blank line of the batch
+/// @param whole tokenizer over the whole document for the parsed nodes, the cursor's one
+/// keeps moving while the records wait for the sink
+static void _extract_batch(const char *data, const _batch &batch, const path_set &paths,
+                           extractor &cur, Tokenizer *whole, std::vector<ndjson_record> &records)
+{
+    size_t id = batch.first_id;
+    for (size_t pos = batch.begin; pos < batch.end; id++)
+    {
+        size_t next = _next_line(data, pos, batch.end);
+        size_t end = next;
+        while (end > pos && (data[end - 1] == '\n' || data[end - 1] == '\r'))
+        {
+            end--;
+        }
+        if (skip_whitespace(data, pos, end) < end)
+        {
+            records.push_back(ndjson_record());
+            ndjson_record &record = records.back();
+            record.id = id;
+            record.data = data + pos;
+            record.size = end - pos;
+            try
+            {
+                record.values = cur.select(pos, end).extract(paths, true);
+                for (auto &value : record.values)
+                {
+                    _retarget(value.raw(), whole);
+                }
+            }
+            catch (const std::runtime_error &e)
+            {
+                record.values.assign(paths.size(), wrapper());
+                record.error = true;
+            }
+        }
+        pos = next;
+    }
+}
+
+ndjson_pipeline::ndjson_pipeline(const path_set &paths, unsigned threads, record_order order)
+    : _paths(paths), _threads(threads), _order(order) {}
+
+ndjson_stats ndjson_pipeline::run(const document &doc, const record_sink &sink)
+{
+    auto start = std::chrono::steady_clock::now();
+    const char *data = doc.data();
+    size_t size = doc.size();
+
+    std::vector<_batch> batches;
+    for (size_t pos = 0; pos < size;)
+    {
+        size_t end = pos + LAZY_JSON_NDJSON_BATCH < size ? _next_line(data, pos + LAZY_JSON_NDJSON_BATCH - 1, size) : size;
+        _batch batch = {pos, end, 0};
+        batches.push_back(batch);
+        pos = end;
+    }
+    unsigned count = thread_count(_threads, size);
+    count = count < batches.size() ? count : unsigned(batches.size() ? batches.size() : 1);
+
+    // ids of the first records, the lines of the batches are counted in bulk
+    std::vector<size_t> lines(batches.size());
+    run_parallel(count, [&](unsigned w)
+                 {
+        for (size_t b = w; b < batches.size(); b += count)
+        {
+            lines[b] = _count_lines(data, batches[b].begin, batches[b].end);
+        } });
+    size_t id = 0;
+    for (size_t b = 0; b < batches.size(); b++)
+    {
+        batches[b].first_id = id;
+        id += lines[b];
+    }
+
+    ndjson_stats stats;
+    std::mutex delivery;
+    // finished batches waiting for the ones before them (input order only)
+    std::vector<std::vector<ndjson_record>> pending(_order == record_order::input ? batches.size() : 0);
+    std::vector<char> done(pending.size(), 0);
+    size_t delivered = 0;
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::exception_ptr> errors(count);
+    // only read (by `json()` of the parsed objects and lists), shared by the workers
+    Tokenizer whole(data, size);
+
+    auto deliver = [&](std::vector<ndjson_record> &records)
+    {
+        for (auto &record : records)
+        {
+            sink(record);
+            stats.records++;
+            stats.errors += record.error ? 1 : 0;
+        }
+    };
+
+    run_parallel(count, [&](unsigned w)
+                 {
+        try
+        {
+            cursor cur(doc);
+            // every record is visited once, there is nothing to remember
+            cur.memoize(0);
+            std::vector<ndjson_record> records;
+            size_t b;
+            while (!failed.load(std::memory_order_relaxed) && (b = next.fetch_add(1)) < batches.size())
+            {
+                // the values of a batch share an arena, dropped once the sink is done with them
+                if (LAZY_JSON_ARENA_BLOCK)
+                {
+                    cur.useArena(std::make_shared<arena>());
+                }
+                records.clear();
+                _extract_batch(data, batches[b], _paths, cur, &whole, records);
+
+                std::lock_guard<std::mutex> lock(delivery);
+                if (_order == record_order::unordered)
+                {
+                    deliver(records);
+                    continue;
+                }
+                pending[b].swap(records);
+                done[b] = 1;
+                while (delivered < batches.size() && done[delivered])
+                {
+                    deliver(pending[delivered]);
+                    std::vector<ndjson_record>().swap(pending[delivered]);
+                    delivered++;
+                }
+            }
+        }
+        catch (...)
+        {
+            errors[w] = std::current_exception();
+            failed = true;
+        } });
+
+    for (auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    stats.bytes = size;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats.seconds > 0)
+    {
+        stats.records_per_second = double(stats.records) / stats.seconds;
+        stats.bytes_per_second = double(stats.bytes) / stats.seconds;
+    }
+    return stats;
+}
+
+END_LAZY_JSON_NAMESPACE
+
+#endif
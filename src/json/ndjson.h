@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+
+## NDJSON
+
+Extraction of a fixed set of paths from every record of a newline-delimited json
+(NDJSON / JSON Lines) document, on a pool of threads.
+
+The document is cut into batches of about `LAZY_JSON_NDJSON_BATCH` bytes at line breaks,
+the records of each batch are counted (for their ids) in bulk, then the workers take the
+batches one by one. Every worker has its own cursor over the document and extracts the
+whole path set from each record in a single pass (`extractor::select()` + `extract(path_set)`),
+no extractor is created per record.
+
+The sink is called once per record (blank lines are skipped), one call at a time:
+- `record_order::input` - in the order of the document, batches finished early wait for the ones before
+- `record_order::unordered` - as soon as the batch is done, `ndjson_record::id` tells where it was
+
+```cpp
+using namespace lazyjson;
+
+const document doc = document::from_file("events.ndjson");
+ndjson_pipeline pipeline(path_set({path("user.id"), path("latency")}));
+ndjson_stats stats = pipeline.run(doc, [&](ndjson_record &record) {
+    if (!record.error)
+        total += record.values[1].asFloat();
+});
+Serial.printf("%.0f records/s, %.1f MB/s\n", stats.records_per_second, stats.bytes_per_second / 1e6);
+```
+
+*/
+
+#include <vector>
+#include <functional>
+#include <stddef.h>
+
+#include "parallel.h"
+#include "path.h"
+#include "../options.h"
+#include "../namespaces.h"
+
+#if LAZY_JSON_THREADS
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Order in which the records are passed to the sink
+enum class record_order
+{
+    input,
+    unordered
+};
+
+typedef struct
+{
+    // line number of the record (0-based, blank lines count too)
+    size_t id = 0;
+    // the line, without the line break
+    const char *data = nullptr;
+    size_t size = 0;
+    // one value per path of the set (null if not found), objects and lists are parsed
+    // as a whole, their `json()` is valid only until `run()` returns
+    std::vector<wrapper> values;
+    // the record isn't valid json, `values` are null
+    bool error = false;
+} ndjson_record;
+
+typedef struct
+{
+    // non-blank lines passed to the sink
+    size_t records = 0;
+    // records that failed to parse
+    size_t errors = 0;
+    size_t bytes = 0;
+    double seconds = 0;
+    double records_per_second = 0;
+    double bytes_per_second = 0;
+} ndjson_stats;
+
+/// @brief Receives the records of `ndjson_pipeline::run()`, never called concurrently
+typedef std::function<void(ndjson_record &record)> record_sink;
+
+class ndjson_pipeline
+{
+    path_set _paths;
+    unsigned _threads;
+    record_order _order;
+
+public:
+    /// @param paths extracted from every record (relative to it)
+    /// @param threads number of workers, 0 to use every core, but not less than
+    /// `LAZY_JSON_PARALLEL_CHUNK` bytes per thread
+    ndjson_pipeline(const path_set &paths, unsigned threads = 0, record_order order = record_order::input);
+
+    /// @brief Extract the paths from every record of the document and pass them to `sink`
+    /// @throw whatever the sink throws, the remaining records are dropped
+    ndjson_stats run(const document &doc, const record_sink &sink);
+};
+
+END_LAZY_JSON_NAMESPACE
+
+#endif
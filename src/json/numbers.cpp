@@ -0,0 +1,174 @@
+#include "numbers.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#   if __has_include(<charconv>)
+#       include <charconv>
+#   endif
+#endif
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+// every power of ten up to 1e22 is exactly representable as a double
+static const double _powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static inline bool _is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static double _strtod(const char *data, size_t length)
+{
+    // strtod needs a null-terminated string, json numbers are short enough for the stack
+    char buffer[64];
+    if (length < sizeof(buffer))
+    {
+        memcpy(buffer, data, length);
+        buffer[length] = '\0';
+        return strtod(buffer, nullptr);
+    }
+    std::string copy(data, length);
+    return strtod(copy.c_str(), nullptr);
+}
+
+/// @brief Correctly rounded conversion for the numbers the fast path can't handle,
+/// out of range values are infinity or zero (like `strtod`)
+static bool _parse_real_slow(const char *data, size_t length, double &value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::from_chars_result result = std::from_chars(data, data + length, value);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        value = _strtod(data, length);
+        return true;
+    }
+    return result.ec == std::errc();
+#else
+    value = _strtod(data, length);
+    return true;
+#endif
+}
+
+bool parse_number(const char *data, size_t length, lazy_number &number)
+{
+    const char *p = data, *end = data + length;
+    bool negative = p < end && *p == '-';
+    if (negative)
+    {
+        p++;
+    }
+    if (p == end || !_is_digit(*p))
+    {
+        return false;
+    }
+    // no leading zeros, like the validator
+    if (*p == '0' && p + 1 < end && _is_digit(p[1]))
+    {
+        return false;
+    }
+
+    // first 19 significant digits always fit in uint64_t
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool truncated = false, integral = true;
+
+    for (; p < end && _is_digit(*p); p++)
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + uint64_t(*p - '0');
+            digits += mantissa != 0;
+        }
+        else
+        {
+            exponent++;
+            truncated = true;
+        }
+    }
+
+    if (p < end && *p == '.')
+    {
+        integral = false;
+        if (++p == end || !_is_digit(*p))
+        {
+            return false;
+        }
+        for (; p < end && _is_digit(*p); p++)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + uint64_t(*p - '0');
+                digits += mantissa != 0;
+                exponent--;
+            }
+            else
+            {
+                truncated = true;
+            }
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        integral = false;
+        bool negative_exponent = false;
+        if (++p < end && (*p == '+' || *p == '-'))
+        {
+            negative_exponent = *p == '-';
+            p++;
+        }
+        if (p == end || !_is_digit(*p))
+        {
+            return false;
+        }
+        int value = 0;
+        for (; p < end && _is_digit(*p); p++)
+        {
+            // anything past this over/underflows anyway
+            if (value < 100000)
+            {
+                value = value * 10 + (*p - '0');
+            }
+        }
+        exponent += negative_exponent ? -value : value;
+    }
+
+    if (p != end)
+    {
+        return false;
+    }
+
+    if (integral && !truncated)
+    {
+        if (mantissa <= uint64_t(INT64_MAX))
+        {
+            number.integral = true;
+            number.integer = negative ? -int64_t(mantissa) : int64_t(mantissa);
+            return true;
+        }
+        if (negative && mantissa == uint64_t(INT64_MAX) + 1)
+        {
+            number.integral = true;
+            number.integer = INT64_MIN;
+            return true;
+        }
+    }
+
+    number.integral = false;
+    // both the mantissa and the power of ten are exact, so is the single rounding
+    if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double value = double(mantissa);
+        value = exponent < 0 ? value / _powers_of_ten[-exponent] : value * _powers_of_ten[exponent];
+        number.real = negative ? -value : value;
+        return true;
+    }
+    return _parse_real_slow(data, length, number.real);
+}
+
+END_LAZY_JSON_NAMESPACE
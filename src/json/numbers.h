@@ -0,0 +1,43 @@
+#pragma once
+
+/*
+
+Single-pass json number decoder. Integral literals that fit are kept as an exact
+`int64_t` (Unix timestamps, ids), everything else is decoded into a `double`.
+
+Most numbers found in json (up to 15 significant digits, small exponents) are
+converted exactly with a multiplication or division by a power of ten (Clinger's
+fast path). The rare rest falls back to the standard library.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Decoded json number, `integer` is set if `integral`, `real` otherwise
+typedef struct
+{
+    union
+    {
+        int64_t integer;
+        double real;
+    };
+    bool integral;
+} lazy_number;
+
+/// @brief Decode `length` bytes of a json number (`-`, digits, fraction, exponent), without allocating.
+/// Numbers out of the range of a double are infinity, or zero if they are too small.
+/// @return false if the literal is not a valid json number (leading zeros included)
+bool parse_number(const char *data, size_t length, lazy_number &number);
+
+/// @brief Value of the number as a double
+inline double number_real(const lazy_number &number)
+{
+    return number.integral ? static_cast<double>(number.integer) : number.real;
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -1,23 +1,32 @@
 #include "objects.h"
 
+#include <string.h>
+#include <utility>
+
 
 BEGIN_LAZY_JSON_NAMESPACE
 
-    // This function is used to skip the tokens that are not needed
+// objects with fewer keys are scanned, comparing the hashes first
+#define LAZY_OBJECT_INDEX_MIN 8
+
+    /// @brief Create the node in the arena, on the heap if there is none
+    template <class T, class... Args>
+    static T *_make_node(arena *memory, Args&&... args)
+    {
+        if (!memory){
+            return new T(std::forward<Args>(args)...);
+        }
+        return new (memory->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // This function is used to skip the tokens that are not needed,
+    // the nested values are not tokenized, only the brackets are counted
     void fast_forward(size_t pos, TOKEN_TYPE begin, TOKEN_TYPE end, Tokenizer* _tokenizer)
     {
+        static_cast<void>(begin);
+        static_cast<void>(end);
         _tokenizer->setPos(pos);
-        Token token;
-        int count = 1;
-        while (_tokenizer->hasTokens() && count > 0){
-            token = _tokenizer->getToken();
-            if (token.type == begin){
-                count++;
-            }
-            if (token.type == end){
-                count--;
-            }
-        }
+        _tokenizer->skipContainer();
     }
 
 
@@ -41,7 +50,7 @@ BEGIN_LAZY_JSON_NAMESPACE
         }
     }
 
-    LazyObject *object_parse(size_t pos, bool deep, Tokenizer *_tokenizer)
+    LazyObject *object_parse(size_t pos, bool deep, Tokenizer *_tokenizer, arena *memory)
     {
         /*
         
@@ -86,19 +95,14 @@ BEGIN_LAZY_JSON_NAMESPACE
             But obj["key1"] will first lazily parse the value, and when called again
             it will return the cached value.
 
-        Also accessing the keys in object is done in linear time, so it is recomended
-        to store the results in a variable, and not access the same key multiple times.
-
-        Calling:
-            obj["key1"]["key2"]["key3"]
+        The keys are hashed while parsing, objects with `LAZY_OBJECT_INDEX_MIN` or more keys
+        get a hash table, so accessing a key doesn't depend on the number of keys.
 
-            Multiple times will result in searching the key1, key2 and key3 multiple times.
-            
         */
 
         _tokenizer->setPos(pos);
         Token token;
-        auto object = new LazyObject(_tokenizer);
+        auto object = _make_node<LazyObject>(memory, _tokenizer, memory);
 
         while (_tokenizer->hasTokens()){
             token = _tokenizer->getToken();
@@ -117,43 +121,43 @@ BEGIN_LAZY_JSON_NAMESPACE
             if (token.type != TOKEN_TYPE::STRING){   
                 break;
             }
-            auto key = token.value;
+            // keys without escape sequences are copied straight from the json
+            std::string decoded;
+            const char *key = _tokenizer->_stream.at(token.start);
+            size_t length = token.length;
+            if (token.escaped){
+                decoded = _tokenizer->str(token);
+                key = decoded.data();
+                length = decoded.size();
+            }
         #if DEBUG_LAZY_JSON
-            Serial.printf("Parsing object key %s \n", key.c_str());
+            Serial.printf("Parsing object key %.*s \n", int(length), key);
         #endif
             if (_tokenizer->getToken().type != TOKEN_TYPE::COLON){
                 break;
             }
             
             if(deep){
-                auto parsed = lazy_parse(_tokenizer->getPos(), true, _tokenizer);
-                object->add(key, parsed.values, parsed.type);
+                // the key may be dropped from the streaming buffer while parsing the value
+                std::string copy(key, length);
+                auto parsed = lazy_parse(_tokenizer->getPos(), true, _tokenizer, memory);
+                object->add(copy.data(), copy.size(), parsed);
                 continue;
             } 
 
             // storing the key and the position of the value
-            object->add(key, _tokenizer->getPos());
-            // value of the key is not parsed yet, so we need to skip it
-            token = _tokenizer->getToken();
-
-        #if DEBUG_LAZY_JSON
-            Serial.printf("Parsing object value %s = %s \n",
-             verboseTokenType(token.type).c_str(), token.value.c_str());
-        #endif
-            // nested objects are not evaluated, so we need to skip them
-            if (token.type == TOKEN_TYPE::CURLY_OPEN){
-                fast_forward(_tokenizer->getPos(), TOKEN_TYPE::CURLY_OPEN, TOKEN_TYPE::CURLY_CLOSE, _tokenizer);
-            }
-            // lists are not evaluated, so we need to skip them
-            if (token.type == TOKEN_TYPE::ARRAY_OPEN){
-                fast_forward(_tokenizer->getPos(), TOKEN_TYPE::ARRAY_OPEN, TOKEN_TYPE::ARRAY_CLOSE, _tokenizer);
-            }
+            LazyTypedValues value;
+            value.values.parse_idx = _tokenizer->getPos();
+            value.type = LazyType::PARSE_IDX;
+            object->add(key, length, value);
+            // value of the key is not parsed yet, it's skipped to the next structural character
+            _tokenizer->skipValue();
         }
         object->push(pos, _tokenizer->getPos());
         return object;
     }
 
-    LazyList *list_parse(size_t pos, bool deep, Tokenizer *_tokenizer)
+    LazyList *list_parse(size_t pos, bool deep, Tokenizer *_tokenizer, arena *memory)
     {
         /*
         
@@ -187,7 +191,7 @@ BEGIN_LAZY_JSON_NAMESPACE
 
         _tokenizer->setPos(pos);
         Token token;
-        auto list = new LazyList(_tokenizer);
+        auto list = _make_node<LazyList>(memory, _tokenizer, memory);
         int index = 0;
         size_t prev_pos;
 
@@ -198,7 +202,7 @@ BEGIN_LAZY_JSON_NAMESPACE
 
         #if DEBUG_LAZY_JSON
             Serial.printf("Parsing list token %s = %s\n",
-             verboseTokenType(token.type).c_str(), token.value.c_str());
+             verboseTokenType(token.type).c_str(), _tokenizer->str(token).c_str());
         #endif
 
             if (token.type == TOKEN_TYPE::ARRAY_CLOSE){
@@ -209,21 +213,18 @@ BEGIN_LAZY_JSON_NAMESPACE
             }
 
             if(deep){
-                auto parsed = lazy_parse(_tokenizer->getPos(), true, _tokenizer);
-                list->add(index, parsed.values, parsed.type);
+                // the value starts with the token that was just read
+                auto parsed = lazy_parse(prev_pos, true, _tokenizer, memory);
+                list->add(index++, parsed);
                 continue;
             } 
 
             list->add(index, prev_pos);
             index++;
 
-            // nested objects are not evaluated, so we need to skip them
-            if (token.type == TOKEN_TYPE::CURLY_OPEN){
-                fast_forward(_tokenizer->getPos(), TOKEN_TYPE::CURLY_OPEN, TOKEN_TYPE::CURLY_CLOSE, _tokenizer);
-            }
-            // lists are not evaluated, so we need to skip them
-            if (token.type == TOKEN_TYPE::ARRAY_OPEN){
-                fast_forward(_tokenizer->getPos(), TOKEN_TYPE::ARRAY_OPEN, TOKEN_TYPE::ARRAY_CLOSE, _tokenizer);
+            // nested objects and lists are not evaluated, so we need to skip them
+            if (token.type == TOKEN_TYPE::CURLY_OPEN || token.type == TOKEN_TYPE::ARRAY_OPEN){
+                _tokenizer->skipContainer();
             }
         }
         list->push(pos, _tokenizer->getPos());
@@ -231,28 +232,7 @@ BEGIN_LAZY_JSON_NAMESPACE
     }
 
 
-    LazyString *string_parse(size_t pos, Tokenizer *_tokenizer)
-    {
-        /*
-        
-        "value1"
-
-        The LazyString stores only the position of the value in the json string.
-        When the value is needed, it is copied from json and returned, but the
-        copied string itself is not stored in LazyString.
-
-        So for example:
-            LazyString *s = string_parse(pos);
-            // the string is parsed, the beginning and the end of the string is stored
-
-            std::string str = s->str();
-            // will result in copying the substring of the json
-
-        */
-        return new LazyString(pos, _tokenizer->getPos(), _tokenizer);
-    }
-
-    LazyTypedValues lazy_parse(size_t pos, bool deep, Tokenizer *_tokenizer)
+    LazyTypedValues lazy_parse(size_t pos, bool deep, Tokenizer *_tokenizer, arena *memory)
     {
         _tokenizer->setPos(pos);
         auto token = _tokenizer->getToken();
@@ -261,24 +241,43 @@ BEGIN_LAZY_JSON_NAMESPACE
         switch (token.type)
         {
         case TOKEN_TYPE::CURLY_OPEN:
-            result.values.object = object_parse(_tokenizer->getPos(), deep, _tokenizer);
+            result.values.object = object_parse(_tokenizer->getPos(), deep, _tokenizer, memory);
             result.type = LazyType::OBJECT;
             break;
         case TOKEN_TYPE::ARRAY_OPEN:
-            result.values.list = list_parse(_tokenizer->getPos(), deep, _tokenizer);
+            result.values.list = list_parse(_tokenizer->getPos(), deep, _tokenizer, memory);
             result.type = LazyType::LIST;
             break;
         case TOKEN_TYPE::STRING:
-            result.values.string = string_parse(pos, _tokenizer);
+            // only the span of the raw bytes, nothing is allocated
+            result.values.string = _tokenizer->_stream.at(token.start);
+            if (memory && _tokenizer->_stream.streaming()){
+                // the streaming buffer is compacted by the next read, the span is copied into the arena
+                char *copy = static_cast<char *>(memory->allocate(token.length ? token.length : 1, 1));
+                memcpy(copy, result.values.string, token.length);
+                result.values.string = copy;
+            }
+            result.length = static_cast<uint32_t>(token.length);
+            result.flags = token.escaped ? LAZY_VALUE_ESCAPED : 0;
             result.type = LazyType::STRING;
             break;
         case TOKEN_TYPE::NUMBER:
-            result.values.number = std::stof(token.value);
-            result.repr = token.value;
+        {
+            lazy_number number;
+            if (!parse_number(_tokenizer->_stream.at(token.start), token.length, number)){
+                throw std::runtime_error("lazy_parse(): Invalid number at: " + std::to_string(token.start));
+            }
+            if (number.integral){
+                result.values.integer = number.integer;
+                result.flags = LAZY_VALUE_INTEGRAL;
+            } else {
+                result.values.real = number.real;
+            }
             result.type = LazyType::NUMBER;
             break;
+        }
         case TOKEN_TYPE::BOOLEAN:
-            result.values.boolean = token.value == "true";
+            result.values.boolean = token.length == 4;
             result.type = LazyType::BOOL;
             break;
         case TOKEN_TYPE::NULL_TYPE:
@@ -300,23 +299,20 @@ BEGIN_LAZY_JSON_NAMESPACE
             Serial.printf("Destroying lazy object at %p \n", value.object);
         #endif
             
-            delete value.object;
+            if (value.object && !value.object->_arena){
+                delete value.object;
+            }
             value.object = nullptr;
             break;
         case LazyType::LIST:
         #if DEBUG_LAZY_JSON
             Serial.printf("Destroying lazy list at %p \n", value.list);
         #endif
-            delete value.list;
+            if (value.list && !value.list->_arena){
+                delete value.list;
+            }
             value.list = nullptr;
             break;
-        case LazyType::STRING:
-        #if DEBUG_LAZY_JSON
-            Serial.printf("Destroying lazy string at %p \n", value.string);
-        #endif
-            delete value.string;
-            value.string = nullptr;
-            break;        
         default:
         #if DEBUG_LAZY_JSON
             Serial.printf("Destroying: Unknown lazy type %d \n", type);
@@ -335,16 +331,9 @@ BEGIN_LAZY_JSON_NAMESPACE
         case LazyType::LIST:
             dest.list = new LazyList(*value.list);
             break;
-        case LazyType::STRING:
-            dest.string = new LazyString(*value.string);
-            break;        
-        case LazyType::NUMBER:
-            dest.number = value.number;
-            break;
-        case LazyType::BOOL:
-            dest.boolean = value.boolean;
-            break;
         default:
+            // strings, numbers, booleans and parsing positions are stored in place
+            dest = value;
             break;
         }
     }
@@ -355,14 +344,14 @@ BEGIN_LAZY_JSON_NAMESPACE
         return _tokenizer->json(_start, _end);
     }
 
-    void LazyLike::push(int start, int end){
+    void LazyLike::push(size_t start, size_t end){
         _start = start;
         _end = end;
     }
 
     // LazyObject
 
-    LazyObject::LazyObject(Tokenizer *t): LazyLike(t) {}
+    LazyObject::LazyObject(Tokenizer *t, arena *memory): LazyLike(t, memory), _list(memory), _table(memory) {}
 
     LazyObject::LazyObject(const LazyObject& other){
         static_cast<void>(this->operator=(other));
@@ -370,18 +359,56 @@ BEGIN_LAZY_JSON_NAMESPACE
 
     LazyObject& LazyObject::operator=(const LazyObject& other)
     {
+        if (this == &other){
+            return *this;
+        }
+        for (auto it = _list.begin(); it != _list.end(); it++){
+            destroyLazyValue(it->value.values, it->value.type);
+        }
         _start = other._start;
         _end = other._end;
         _tokenizer = other._tokenizer;
+        _list.clear();
+        _list.reserve(other._list.size());
         for(auto it = other._list.begin(); it != other._list.end(); it++){
-            ObjectData data;
-            auto values = it->values;
-            auto type = it->type;
-            data.key = it->key;
-            data.type = type;            
-            deepCopyLazyValue(values, type, data.values);
-            _list.push_back(data);
+            auto value = it->value;
+            ObjectData data{arena_string(it->key.data(), it->key.size(), arena_allocator<char>(_arena)),
+                            it->hash, value};
+            deepCopyLazyValue(value.values, value.type, data.value.values);
+            _list.push_back(std::move(data));
         }
+        // the slots are the same
+        _table = other._table;
+        return *this;
+    }
+
+    LazyObject::LazyObject(LazyObject&& other) noexcept
+        : LazyLike(other._start, other._end, other._tokenizer, other._arena),
+          _list(std::move(other._list)), _table(std::move(other._table))
+    {
+        other._list.clear();
+        other._table.clear();
+    }
+
+    LazyObject& LazyObject::operator=(LazyObject&& other)
+    {
+        if (this == &other){
+            return *this;
+        }
+        // records allocated elsewhere can't be adopted, they are copied
+        if (_arena != other._arena){
+            return operator=(static_cast<const LazyObject&>(other));
+        }
+        for (auto it = _list.begin(); it != _list.end(); it++){
+            destroyLazyValue(it->value.values, it->value.type);
+        }
+        _start = other._start;
+        _end = other._end;
+        _tokenizer = other._tokenizer;
+        _list = std::move(other._list);
+        _table = std::move(other._table);
+        other._list.clear();
+        other._table.clear();
         return *this;
     }
 
@@ -390,30 +417,104 @@ BEGIN_LAZY_JSON_NAMESPACE
         Serial.println("Destroying LazyObject \n");
     #endif
         for (auto it = _list.begin(); it != _list.end(); it++){
-            destroyLazyValue(it->values, it->type);
+            destroyLazyValue(it->value.values, it->value.type);
         }
     }
 
-    void LazyObject::add(const std::string& key, int parse_idx)
+    void LazyObject::add(const std::string& key, size_t parse_idx)
     {
-        ObjectData data;
-        data.key = key;
-        data.values.parse_idx = parse_idx;
-        data.type = LazyType::PARSE_IDX;
-        _list.push_back(data);
+        LazyTypedValues value;
+        value.values.parse_idx = parse_idx;
+        value.type = LazyType::PARSE_IDX;
+        add(key.data(), key.size(), value);
         
     #if DEBUG_LAZY_JSON
-        Serial.printf("Added %s at %d \n", key.c_str(), parse_idx);
+        Serial.printf("Added %s at %lu \n", key.c_str(), (unsigned long)parse_idx);
     #endif
     }
 
-    void LazyObject::add(const std::string& key, LazyValues value, LazyType type)
+    void LazyObject::add(const std::string& key, const LazyTypedValues& value)
+    {
+        add(key.data(), key.size(), value);
+    }
+
+    void LazyObject::add(const char *key, size_t length, const LazyTypedValues& value)
+    {
+        // the key is allocated from the same arena as the object
+        ObjectData data{arena_string(key, length, arena_allocator<char>(_arena)),
+                        path_hash(key, length), value};
+        _list.push_back(std::move(data));
+
+        size_t size = _list.size();
+        if (size < LAZY_OBJECT_INDEX_MIN){
+            return;
+        }
+        // keep the table at most half full, so the probing stays short
+        if (_table.size() < 2 * size){
+            size_t capacity = _table.empty() ? 2 * LAZY_OBJECT_INDEX_MIN : _table.size();
+            while (capacity < 2 * size){
+                capacity <<= 1;
+            }
+            _table.assign(capacity, -1);
+            for (size_t i = 0; i < size; i++){
+                _index(static_cast<int>(i));
+            }
+            return;
+        }
+        _index(static_cast<int>(size - 1));
+    }
+
+    /// @brief Spread the hash bits over the table mask
+    static inline size_t _home_slot(uint32_t hash, size_t mask)
     {
-        ObjectData data;
-        data.key = key;
-        data.values = value;
-        data.type = type;
-        _list.push_back(data);
+        return (hash ^ (hash >> 16)) & mask;
+    }
+
+    void LazyObject::_index(int slot)
+    {
+        const ObjectData &data = _list[slot];
+        size_t mask = _table.size() - 1;
+        for (size_t i = _home_slot(data.hash, mask);; i = (i + 1) & mask){
+            int &entry = _table[i];
+            if (entry < 0){
+                entry = slot;
+                return;
+            }
+            // duplicated key, the first one is returned (like the linear search)
+            const ObjectData &other = _list[entry];
+            if (other.hash == data.hash && other.key == data.key){
+                return;
+            }
+        }
+    }
+
+    static inline bool _same_key(const ObjectData &data, uint32_t hash, const std::string& key)
+    {
+        return data.hash == hash && data.key.size() == key.size() &&
+               memcmp(data.key.data(), key.data(), key.size()) == 0;
+    }
+
+    int LazyObject::_find(const std::string& key)
+    {
+        uint32_t hash = path_hash(key.data(), key.size());
+        if (_table.empty()){
+            for (size_t i = 0; i < _list.size(); i++){
+                if (_same_key(_list[i], hash, key)){
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+        size_t mask = _table.size() - 1;
+        for (size_t i = _home_slot(hash, mask);; i = (i + 1) & mask){
+            int entry = _table[i];
+            if (entry < 0){
+                return -1;
+            }
+            if (_same_key(_list[entry], hash, key)){
+                return entry;
+            }
+        }
     }
 
     LazyTypedValues LazyObject::operator[](const std::string& key)
@@ -427,35 +528,32 @@ BEGIN_LAZY_JSON_NAMESPACE
         Serial.printf("Getting %s \n", key.c_str());
     #endif
         LazyTypedValues result;
-        for (auto it = _list.begin(); it != _list.end(); it++){
-    #if DEBUG_LAZY_JSON
-            Serial.printf("Comparing %s with %s \n", key.c_str(), it->key.c_str());
-    #endif
-            if (it->key == key){
-                // If the value is not parsed, we need to parse it
-                if (it->type == LazyType::PARSE_IDX){
+        int slot = _find(key);
+        if (slot < 0){
+            return result;
+        }
+        LazyTypedValues &data = _list[slot].value;
+        // If the value is not parsed, we need to parse it
+        if (data.type == LazyType::PARSE_IDX){
 
     #if DEBUG_LAZY_JSON
-                    Serial.printf("Parsing %s at %d \n", key.c_str(), it->values.parse_idx);
+            Serial.printf("Parsing %s at %lu \n", key.c_str(), (unsigned long)data.values.parse_idx);
     #endif
-                    result = lazy_parse(it->values.parse_idx, cache, _tokenizer);
-                    it->values = result.values;
-                    it->type = result.type;
-                } else {
-                    // Already parsed, we can return the value
-                    result.values = it->values;
-                    result.type = it->type;
-                }
-                break;
-            }
+            data = lazy_parse(data.values.parse_idx, cache, _tokenizer, _arena);
         }
-        return result;
+        // Already parsed, we can return the value
+        return data;
+    }
+
+    size_t LazyObject::size() const
+    {
+        return _list.size();
     }
 
 
     // LazyList
 
-    LazyList::LazyList(Tokenizer *t): LazyLike(t) {}
+    LazyList::LazyList(Tokenizer *t, arena *memory): LazyLike(t, memory), _list(memory) {}
 
     LazyList::LazyList(const LazyList& other){
         static_cast<void>(this->operator=(other));
@@ -463,21 +561,52 @@ BEGIN_LAZY_JSON_NAMESPACE
 
     LazyList& LazyList::operator=(const LazyList& other)
     {
+        if (this == &other){
+            return *this;
+        }
+        for (auto it = _list.begin(); it != _list.end(); it++){
+            destroyLazyValue(it->values, it->type);
+        }
         _start = other._start;
         _end = other._end;
         _tokenizer = other._tokenizer;
-        for(auto it = other._list.begin(); it != other._list.end(); it++){
-            ListData data;
-            auto values = it->values;
-            auto type = it->type;
-            data.index = it->index;
-            data.type = type;            
-            deepCopyLazyValue(values, type, data.values);
-            _list.push_back(data);
+        _list.clear();
+        _list.resize(other._list.size());
+        for(size_t i = 0; i < other._list.size(); i++){
+            auto value = other._list[i];
+            _list[i] = value;
+            deepCopyLazyValue(value.values, value.type, _list[i].values);
         }
         return *this;
     }
 
+    LazyList::LazyList(LazyList&& other) noexcept
+        : LazyLike(other._start, other._end, other._tokenizer, other._arena),
+          _list(std::move(other._list))
+    {
+        other._list.clear();
+    }
+
+    LazyList& LazyList::operator=(LazyList&& other)
+    {
+        if (this == &other){
+            return *this;
+        }
+        // records allocated elsewhere can't be adopted, they are copied
+        if (_arena != other._arena){
+            return operator=(static_cast<const LazyList&>(other));
+        }
+        for (auto it = _list.begin(); it != _list.end(); it++){
+            destroyLazyValue(it->values, it->type);
+        }
+        _start = other._start;
+        _end = other._end;
+        _tokenizer = other._tokenizer;
+        _list = std::move(other._list);
+        other._list.clear();
+        return *this;
+    }
+
     LazyList::~LazyList(){
     #if DEBUG_LAZY_JSON
         Serial.println("Destroying LazyList \n");
@@ -487,22 +616,26 @@ BEGIN_LAZY_JSON_NAMESPACE
         }
     }
 
-    void LazyList::add(int index, int parse_idx)
+    void LazyList::add(int index, size_t parse_idx)
     {
-        ListData data;
-        data.index = index;
-        data.values.parse_idx = parse_idx;
-        data.type = LazyType::PARSE_IDX;
-        _list.push_back(data);
+        LazyTypedValues value;
+        value.values.parse_idx = parse_idx;
+        value.type = LazyType::PARSE_IDX;
+        add(index, value);
     }
 
-    void LazyList::add(int index, LazyValues value, LazyType type)
+    void LazyList::add(int index, const LazyTypedValues& value)
     {
-        ListData data;
-        data.index = index;
-        data.values = value;
-        data.type = type;
-        _list.push_back(data);
+        if (index < 0){
+            return;
+        }
+        // indices are dense, the list parser adds them in order
+        if (static_cast<size_t>(index) >= _list.size()){
+            _list.resize(index + 1);
+        }
+        ListData &data = _list[index];
+        destroyLazyValue(data.values, data.type);
+        data = value;
     }
 
     LazyTypedValues LazyList::operator[](const int& index)
@@ -516,27 +649,19 @@ BEGIN_LAZY_JSON_NAMESPACE
         Serial.printf("Getting %i \n", index);
     #endif
         LazyTypedValues result;
-        for (auto it = _list.begin(); it != _list.end(); it++){
-    #if DEBUG_LAZY_JSON
-            Serial.printf("Comparing %i with %i \n", index, it->index);
-    #endif
-            if (it->index == index){
-                // If the value is not parsed, we need to parse it
-                if (it->type == LazyType::PARSE_IDX){
+        if (index < 0 || static_cast<size_t>(index) >= _list.size()){
+            return result;
+        }
+        ListData &data = _list[index];
+        // If the value is not parsed, we need to parse it
+        if (data.type == LazyType::PARSE_IDX){
     #if DEBUG_LAZY_JSON
-                    Serial.printf("Parsing %i at %d \n", index, it->values.parse_idx);
+            Serial.printf("Parsing %i at %lu \n", index, (unsigned long)data.values.parse_idx);
     #endif
-                    result = lazy_parse(it->values.parse_idx, cache, _tokenizer);
-                    it->values = result.values;
-                    it->type = result.type;
-                } else {
-                    // Already parsed, we can return the value
-                    result.values = it->values;
-                    result.type = it->type;
-                }
-                break;
-            }
+            data = lazy_parse(data.values.parse_idx, cache, _tokenizer, _arena);
         }
+        // Already parsed, we can return the value
+        result = data;
 
     #if DEBUG_LAZY_JSON
         Serial.printf("Returning %s", verboseLazyType(result.type).c_str());
@@ -545,28 +670,34 @@ BEGIN_LAZY_JSON_NAMESPACE
         return result;
     }
 
-
-    // LazyString
-    LazyString::LazyString(const LazyString& other){
-        static_cast<void>(this->operator=(other));
+    size_t LazyList::size() const
+    {
+        return _list.size();
     }
 
-    LazyString& LazyString::operator=(const LazyString& other)
+
+    // Strings
+
+    std::string decodeLazyString(const LazyTypedValues& value)
     {
-        _start = other._start;
-        _end = other._end;
-        _tokenizer = other._tokenizer;
-        return *this;
-    }
+        /*
+        
+        "value1"
 
-    std::string LazyString::str(){
-        size_t start = _start;
-        _tokenizer->validatePos(start);
-        _start = start;
+        The string value is only the span of its raw bytes in the json (without quotes),
+        the value is copied out of it when needed, decoding the escape sequences.
+        Strings without escape sequences can be read in place (`values.string`, `length`).
+
+        */
     #if DEBUG_LAZY_JSON
-        Serial.printf("Representing string: %s \n", _tokenizer->json(_start, _end-1).c_str());
+        Serial.printf("Representing string: %.*s \n", int(value.length), value.values.string);
     #endif
-        return _tokenizer->json(_start, _end - 1);
+        if (!(value.flags & LAZY_VALUE_ESCAPED)){
+            return std::string(value.values.string, value.length);
+        }
+        std::string decoded;
+        unescape(value.values.string, value.length, decoded);
+        return decoded;
     }
 
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
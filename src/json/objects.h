@@ -2,21 +2,23 @@
 
 
 #include "Tokenizer.h"
+#include "numbers.h"
+#include "path.h"
+#include "arena.h"
 #include "../options.h"
 #include "../namespaces.h"
 
-#include <list>
+#include <vector>
 
 BEGIN_LAZY_JSON_NAMESPACE
 
 class LazyObject;
 class LazyList;
-class LazyString;
 
 /// @brief Enum class for all possible lazy types. PARSE_IDX is used to store
 /// the parsing position of the value, so it can be parsed when needed. The
 /// rest of the types are used to store parsed values.
-enum class LazyType{
+enum class LazyType : uint8_t {
     OBJECT,
     LIST,
     STRING,
@@ -27,70 +29,97 @@ enum class LazyType{
 };
 
 /// @brief Union of all possible json values, used to store parsed values, 
-/// creating lazy objects, lists and strings. Numbers and booleans are loaded
-/// immediately into memory, while objects, lists and strings are loaded lazily.
+/// creating lazy objects and lists. Numbers, booleans and strings are stored
+/// in place, while objects and lists are loaded lazily.
 typedef union {
     LazyObject *object = 0;
     LazyList *list;
-    LazyString *string;
-    float number;
+    // raw bytes of the string (without quotes), pointing into the json
+    const char *string;
+    int64_t integer;
+    double real;
     bool boolean;
-    int parse_idx;
+    size_t parse_idx;
 } LazyValues;
 
+// `LazyTypedValues::flags`
+// number is exact, stored in `values.integer` (`values.real` otherwise)
+#define LAZY_VALUE_INTEGRAL 0x01
+// string contains escape sequences, `values.string` is not its value as is
+#define LAZY_VALUE_ESCAPED 0x02
+
+/// @brief Parsed json value, 16 bytes. Strings are spans of the json (pointer and length),
+/// only objects and lists are allocated (from the arena, or on the heap).
 typedef struct {
     LazyValues values;
-    LazyType type;
-    std::string repr;
+    // number of raw bytes of a string
+    uint32_t length = 0;
+    LazyType type = LazyType::NULL_TYPE;
+    uint8_t flags = 0;
 } LazyTypedValues;
 
+static_assert(sizeof(LazyTypedValues) <= 16, "LazyTypedValues must stay compact");
+
+/// @brief String allocated from the arena of the node it belongs to
+typedef std::basic_string<char, std::char_traits<char>, arena_allocator<char>> arena_string;
+
 typedef struct {
-    std::string key;
-    LazyValues values;
-    LazyType type;
+    arena_string key;
+    // `path_hash()` of the key
+    uint32_t hash;
+    LazyTypedValues value;
 } ObjectData;
 
-typedef struct {
-    int index;
-    LazyValues values;
-    LazyType type;
-} ListData;
+/// @brief Element of a list, its index is the position in `LazyList::_list`
+typedef LazyTypedValues ListData;
 
-/// @brief Base class for all lazy objects, lists and strings. Has start and end
+/// @brief Base of the lazy objects and lists (not polymorphic). Has start and end
 /// position in the json string, used to parse the value when needed.
 class LazyLike
 {
 public:
-    virtual std::string json();
-    virtual ~LazyLike() = default;
-    LazyLike(Tokenizer *t = nullptr): 
-        _start(0), _end(0), _tokenizer(t) {}
-    LazyLike(int start, int end, Tokenizer *t) {
+    std::string json();
+    LazyLike(Tokenizer *t = nullptr, arena *memory = nullptr): 
+        _start(0), _end(0), _tokenizer(t), _arena(memory) {}
+    LazyLike(size_t start, size_t end, Tokenizer *t, arena *memory = nullptr) {
         push(start, end);
         _tokenizer = t;
+        _arena = memory;
     }
-    void push(int start, int end);
+    void push(size_t start, size_t end);
 
-    int _start;
-    int _end;
+    size_t _start;
+    size_t _end;
     Tokenizer *_tokenizer;
+    // the node, its children and records live in this arena (heap if null),
+    // they are never freed one by one, see `destroyLazyValue()`
+    arena *_arena;
 };
 
 /// @brief LazyObject is a lazy representation of a json object. When a key is
-/// accessed, the value is parsed and stored in the object. Keeps a list of
-/// keys and their parsing positions.
+/// accessed, the value is parsed and stored in the object. Keeps the keys and
+/// their parsing positions in the json order, objects with more than a few keys
+/// are indexed by an open-addressing table of key hashes, so a lookup is O(1).
 class LazyObject: public LazyLike
 {
+    void _index(int slot);
+    int _find(const std::string& key);
 public:
-    LazyObject(int start, int end, Tokenizer *t) : LazyLike(start, end, t) {};
-    LazyObject(Tokenizer *t);
+    LazyObject(size_t start, size_t end, Tokenizer *t, arena *memory = nullptr) : 
+        LazyLike(start, end, t, memory), _list(memory), _table(memory) {};
+    LazyObject(Tokenizer *t, arena *memory = nullptr);
     LazyObject(const LazyObject& other);
+    /// @brief Takes over the keys and values of `other`, which is left empty.
+    /// The records stay in the arena of `other`.
+    LazyObject(LazyObject&& other) noexcept;
     ~LazyObject();
 
     /// @brief Adds a key to the object, with the parsing position.
-    void add(const std::string& key, int parse_idx);
+    void add(const std::string& key, size_t parse_idx);
     /// @brief Adds a key to the object, with the parsed value.
-    void add(const std::string& key, LazyValues value, LazyType type);
+    void add(const std::string& key, const LazyTypedValues& value);
+    /// @brief Adds a key (`length` bytes, decoded) to the object, with the parsed value.
+    void add(const char *key, size_t length, const LazyTypedValues& value);
 
     /// @brief Searches for the value at the given key and lazily parses it.
     /// @deprecated Use `extractor::filter(const std::string& key)` instead.
@@ -102,26 +131,38 @@ public:
 
     /// @brief Deep copy of the `other` object.
     LazyObject& operator=(const LazyObject& other);
+    /// @brief Takes over the keys and values of `other` if both use the same arena, copies them otherwise.
+    LazyObject& operator=(LazyObject&& other);
 
-    std::list<ObjectData> _list;
+    /// @brief Number of keys
+    size_t size() const;
+
+    std::vector<ObjectData, arena_allocator<ObjectData>> _list;
+    // slots of `_list` by key hash (linear probing), -1 for empty, built once the object
+    // has `LAZY_OBJECT_INDEX_MIN` keys, smaller objects are scanned
+    std::vector<int, arena_allocator<int>> _table;
 };
 
 /// @brief LazyList is a lazy representation of a json list. When an index is
-/// accessed, the value is parsed and stored in the list. Keeps a list of
-/// indexes and their parsing positions.
+/// accessed, the value is parsed and stored in the list. Keeps a dense array
+/// of the parsing positions, so a lookup is O(1).
 
 class LazyList : public LazyLike
 {
 public:
-    LazyList(int start, int end, Tokenizer *t) : LazyLike(start, end, t) {};
-    LazyList(Tokenizer *t);
+    LazyList(size_t start, size_t end, Tokenizer *t, arena *memory = nullptr) : 
+        LazyLike(start, end, t, memory), _list(memory) {};
+    LazyList(Tokenizer *t, arena *memory = nullptr);
     LazyList(const LazyList& other);
+    /// @brief Takes over the elements of `other`, which is left empty.
+    /// The records stay in the arena of `other`.
+    LazyList(LazyList&& other) noexcept;
     ~LazyList();
 
     /// @brief Adds an index to the list, with the parsing position.
-    void add(int index, int parse_idx);
+    void add(int index, size_t parse_idx);
     /// @brief Adds an index to the list, with the parsed value.
-    void add(int index, LazyValues value, LazyType type);
+    void add(int index, const LazyTypedValues& value);
 
     /// @brief Searches for the value at the given index and lazily parses it.
     /// @return Parsed value at the given index.
@@ -134,55 +175,49 @@ public:
 
     /// @brief Deep copy of the `other` list.
     LazyList& operator=(const LazyList& other);
+    /// @brief Takes over the elements of `other` if both use the same arena, copies them otherwise.
+    LazyList& operator=(LazyList&& other);
 
-    std::list<ListData> _list;
-};
-
-/// @brief LazyString is a lazy representation of a json string. When the string
-/// is accessed, the value is parsed. Doesn't store the value, only the parsing
-/// position.
-class LazyString : public LazyLike
-{
-public:
-    LazyString(int start, int end, Tokenizer *t) : LazyLike(start, end, t) {};
-    LazyString(Tokenizer *t): LazyLike(t) {};
-    LazyString(const LazyString& other);
-    LazyString& operator=(const LazyString& other);
+    /// @brief Number of elements
+    size_t size() const;
 
-    std::string str();
+    std::vector<ListData, arena_allocator<ListData>> _list;
 };
 
 /// @brief Uses global Tokenizer to parse json string. Uses lazy parsing,
 /// so it doesn't parse the whole string at once. Objects and lists 
 /// are also parsed lazily, their values are not parsed (skipped).
+/// @param memory arena of the created nodes, heap if null
 /// @return parsed json object
-LazyTypedValues lazy_parse(size_t pos, bool deep, Tokenizer *_tokenizer);
+LazyTypedValues lazy_parse(size_t pos, bool deep, Tokenizer *_tokenizer, arena *memory = nullptr);
 
 /// @brief Parses json object from the global Tokenizer. Only keys are evalueated,
 /// values are skipped.
 /// @param pos position in the json string
 /// @param deep if true, values are also parsed
-LazyObject *object_parse(size_t pos, bool deep, Tokenizer *_tokenizer);
+LazyObject *object_parse(size_t pos, bool deep, Tokenizer *_tokenizer, arena *memory = nullptr);
 
 /// @brief Parses json list from the global Tokenizer. Only indexes are evalueated,
 /// values are skipped.
 /// @param pos position in the json string
 /// @param deep if true, values are also parsed
-LazyList *list_parse(size_t pos, bool deep, Tokenizer *_tokenizer);
+LazyList *list_parse(size_t pos, bool deep, Tokenizer *_tokenizer, arena *memory = nullptr);
 
-/// @brief Parses json string from the global Tokenizer. Onyl the parsing position
-/// is stored.
-/// @param pos 
-/// @return LazyString*
-LazyString *string_parse(size_t pos, Tokenizer *_tokenizer);
+/// @brief Copy of the string value (type `STRING`), with decoded escape sequences
+std::string decodeLazyString(const LazyTypedValues& value);
 
 std::string verboseLazyType(LazyType type);
 
+/// @brief Skips the object / list starting right after its opening bracket at `pos`.
+/// @deprecated Use `Tokenizer::skipContainer()` instead, `begin` and `end` are ignored.
 void fast_forward(size_t pos, TOKEN_TYPE begin,
                   TOKEN_TYPE end, Tokenizer *_tokenizer);
 
+/// @brief Deep copy of the value, the copied nodes are allocated on the heap
 void deepCopyLazyValue(LazyValues& value, LazyType& type, LazyValues& dest);
 
+/// @brief Frees the value and its children, nodes allocated from an arena are left
+/// to it (the arena is dropped as a whole)
 void destroyLazyValue(LazyValues& value, LazyType& type);
 
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,477 @@
+#include "parallel.h"
+
+#if LAZY_JSON_THREADS
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "objects.h"
+#include "scanner.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+unsigned thread_count(unsigned threads, size_t size)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+        size_t limit = size / LAZY_JSON_PARALLEL_CHUNK;
+        if (threads > limit)
+        {
+            threads = unsigned(limit);
+        }
+    }
+    return threads ? threads : 1;
+}
+
+/// @brief 1 if the character at `pos` is escaped by the backslash run right before it
+static uint64_t _escape_carry(const char *data, size_t begin, size_t pos)
+{
+    size_t run = 0;
+    while (pos - run > begin && data[pos - run - 1] == '\\')
+    {
+        run++;
+    }
+    return run & 1;
+}
+
+/// @brief Mask of the characters of the block outside of strings, carries the string and escape state
+static inline uint64_t _outside_strings(const structural_masks &masks, uint64_t &in_string, uint64_t &carry)
+{
+    uint64_t quotes = masks.quote & ~escaped_mask(masks.backslash, carry);
+    uint64_t strings = prefix_xor(quotes) ^ in_string;
+    in_string = uint64_t(int64_t(strings) >> 63);
+    return ~strings;
+}
+
+// part of the buffer scanned by one thread, always whole scanner blocks (except for the last one)
+typedef struct
+{
+    size_t begin;
+    size_t end;
+    // state at `begin`, resolved from the chunks before this one
+    uint64_t carry;
+    uint64_t in_string;
+    int depth;
+    // found by the chunk itself
+    int quotes;
+    int balance;
+    // right after the closing bracket of the root, 0 if it's not in this chunk
+    size_t root_end;
+    std::vector<size_t> separators;
+} _chunk;
+
+structural_index index_structure(const char *data, size_t size, unsigned threads)
+{
+    structural_index index;
+    size_t open = skip_whitespace(data, 0, size);
+    if (open >= size || (data[open] != '{' && data[open] != '['))
+    {
+        return index;
+    }
+    index.begin = open;
+
+    size_t start = open + 1;
+    size_t blocks = (size - start + SCANNER_BLOCK_SIZE - 1) / SCANNER_BLOCK_SIZE;
+    unsigned count = thread_count(threads, size - start);
+    if (count > blocks)
+    {
+        count = blocks ? unsigned(blocks) : 1;
+    }
+    std::vector<_chunk> chunks(count);
+    for (unsigned c = 0; c < count; c++)
+    {
+        _chunk &chunk = chunks[c];
+        chunk.begin = start + blocks * c / count * SCANNER_BLOCK_SIZE;
+        chunk.end = start + blocks * (c + 1) / count * SCANNER_BLOCK_SIZE;
+        chunk.end = chunk.end < size ? chunk.end : size;
+        chunk.carry = _escape_carry(data, start, chunk.begin);
+        chunk.root_end = 0;
+    }
+
+    // 1. unescaped quotes of every chunk, whether a chunk starts inside a string depends
+    // only on the parity of the quotes before it
+    run_parallel(count, [&](unsigned c)
+                  {
+        _chunk &chunk = chunks[c];
+        structural_masks masks;
+        uint64_t carry = chunk.carry;
+        int quotes = 0;
+        for (size_t pos = chunk.begin; pos < chunk.end; pos += SCANNER_BLOCK_SIZE)
+        {
+            static_cast<void>(classify_at(data, pos, chunk.end, masks));
+            quotes += popcount64(masks.quote & ~escaped_mask(masks.backslash, carry));
+        }
+        chunk.quotes = quotes; });
+
+    uint64_t in_string = 0;
+    for (auto &chunk : chunks)
+    {
+        chunk.in_string = in_string;
+        in_string ^= (chunk.quotes & 1) ? ~uint64_t(0) : 0;
+    }
+
+    // 2. bracket balance of every chunk outside of strings, gives the depth at its start
+    run_parallel(count, [&](unsigned c)
+                  {
+        _chunk &chunk = chunks[c];
+        structural_masks masks;
+        uint64_t carry = chunk.carry, strings = chunk.in_string;
+        int balance = 0;
+        for (size_t pos = chunk.begin; pos < chunk.end; pos += SCANNER_BLOCK_SIZE)
+        {
+            static_cast<void>(classify_at(data, pos, chunk.end, masks));
+            uint64_t outside = _outside_strings(masks, strings, carry);
+            balance += popcount64(masks.open & outside) - popcount64(masks.close & outside);
+        }
+        chunk.balance = balance; });
+
+    int level = 1;
+    for (auto &chunk : chunks)
+    {
+        chunk.depth = level;
+        level += chunk.balance;
+    }
+
+    // 3. commas at depth 1 (the root's own) and the closing bracket of the root
+    run_parallel(count, [&](unsigned c)
+                  {
+        _chunk &chunk = chunks[c];
+        structural_masks masks;
+        uint64_t carry = chunk.carry, strings = chunk.in_string;
+        int depth = chunk.depth;
+        for (size_t pos = chunk.begin; pos < chunk.end; pos += SCANNER_BLOCK_SIZE)
+        {
+            static_cast<void>(classify_at(data, pos, chunk.end, masks));
+            uint64_t outside = _outside_strings(masks, strings, carry);
+            uint64_t open = masks.open & outside;
+            uint64_t close = masks.close & outside;
+
+            // the depth can't get back to the root in this block, skip it as a whole
+            if (depth - 1 > popcount64(close))
+            {
+                depth += popcount64(open) - popcount64(close);
+                continue;
+            }
+
+            uint64_t structural = masks.structural & outside;
+            while (structural)
+            {
+                uint64_t bit = structural & (~structural + 1);
+                size_t at = pos + ctz64(bit);
+                if (open & bit)
+                {
+                    depth++;
+                }
+                else if (close & bit)
+                {
+                    if (--depth == 0)
+                    {
+                        chunk.root_end = at + 1;
+                        return;
+                    }
+                }
+                else if (depth == 1 && data[at] == ',')
+                {
+                    chunk.separators.push_back(at);
+                }
+                structural ^= bit;
+            }
+        } });
+
+    for (auto &chunk : chunks)
+    {
+        index.separators.insert(index.separators.end(), chunk.separators.begin(), chunk.separators.end());
+        if (chunk.root_end)
+        {
+            index.end = chunk.root_end;
+            index.complete = true;
+            break;
+        }
+    }
+    return index;
+}
+
+/// @brief Element indices `[first, last)` left to a worker, packed in one word, so the owner
+/// (taking from the front) and the thieves (taking the back half) race on a single compare-and-swap
+class _work_range
+{
+    std::atomic<uint64_t> _range;
+
+    static uint64_t _pack(uint32_t first, uint32_t last)
+    {
+        return uint64_t(first) << 32 | last;
+    }
+
+public:
+    _work_range() : _range(0) {}
+
+    void assign(uint32_t first, uint32_t last)
+    {
+        _range.store(_pack(first, last));
+    }
+
+    bool pop(uint32_t &index)
+    {
+        uint64_t range = _range.load();
+        while (uint32_t(range >> 32) < uint32_t(range))
+        {
+            if (_range.compare_exchange_weak(range, _pack(uint32_t(range >> 32) + 1, uint32_t(range))))
+            {
+                index = uint32_t(range >> 32);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool steal(uint32_t &first, uint32_t &last)
+    {
+        uint64_t range = _range.load();
+        while (uint32_t(range >> 32) < uint32_t(range))
+        {
+            uint32_t begin = uint32_t(range >> 32), end = uint32_t(range);
+            uint32_t half = begin + (end - begin) / 2;
+            if (_range.compare_exchange_weak(range, _pack(begin, half)))
+            {
+                first = half;
+                last = end;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// keeps the nodes of a parallel parse alive, every worker parses with its own tokenizer
+// (referenced by the nodes for `json()`) into its own arena
+struct _parallel_tree
+{
+    std::shared_ptr<const void> source;
+    std::vector<std::unique_ptr<Tokenizer>> tokenizers;
+    // empty if the nodes are allocated on the heap
+    std::vector<std::unique_ptr<arena>> arenas;
+    LazyTypedValues root;
+
+    arena *memory(size_t worker)
+    {
+        return arenas.empty() ? nullptr : arenas[worker].get();
+    }
+
+    ~_parallel_tree()
+    {
+        destroyLazyValue(root.values, root.type);
+    }
+};
+
+typedef struct
+{
+    // only for members of an object
+    Token key;
+    LazyTypedValues value;
+} _element;
+
+/// @brief Deep parse the member / element between `begin` and `end` (its separator)
+/// @return false if it's not a single value (or a `"key": value` pair), the serial parser
+/// would see something else there
+static bool _parse_element(const char *data, size_t begin, size_t end, bool member,
+                           Tokenizer &tokenizer, arena *memory, _element &element)
+{
+    size_t pos = skip_whitespace(data, begin, end);
+    if (pos >= end)
+    {
+        return false;
+    }
+    if (member)
+    {
+        tokenizer.setPos(pos);
+        element.key = tokenizer.getToken();
+        if (element.key.type != TOKEN_TYPE::STRING || tokenizer.getToken().type != TOKEN_TYPE::COLON)
+        {
+            return false;
+        }
+        pos = tokenizer.getPos();
+    }
+    element.value = lazy_parse(pos, true, &tokenizer, memory);
+    return tokenizer.getPos() <= end && skip_whitespace(data, tokenizer.getPos(), end) == end;
+}
+
+/// @brief Create the root node in the arena, on the heap if there is none
+template <class T>
+static T *_make_root(Tokenizer *tokenizer, arena *memory)
+{
+    if (!memory)
+    {
+        return new T(tokenizer, memory);
+    }
+    return new (memory->allocate(sizeof(T), alignof(T))) T(tokenizer, memory);
+}
+
+wrapper parallel_parse(const document &doc, unsigned threads)
+{
+    const char *data = doc.data();
+    size_t size = doc.size();
+    unsigned count = thread_count(threads, size);
+
+    std::shared_ptr<_parallel_tree> tree = std::make_shared<_parallel_tree>();
+    tree->source = doc.source();
+    structural_index index;
+    if (count > 1)
+    {
+        index = index_structure(data, size, count);
+    }
+    // the separators split the root into this many members / elements
+    size_t elements = index.separators.size() + 1;
+    if (!index.complete || elements > UINT32_MAX)
+    {
+        count = 1;
+    }
+    else if (elements == 1 && skip_whitespace(data, index.begin + 1, index.end - 1) == index.end - 1)
+    {
+        // empty object / list
+        elements = 0;
+    }
+    count = elements < count ? unsigned(elements ? elements : 1) : count;
+
+    for (unsigned w = 0; w < count; w++)
+    {
+        tree->tokenizers.push_back(std::unique_ptr<Tokenizer>(new Tokenizer(data, size)));
+        if (LAZY_JSON_ARENA_BLOCK)
+        {
+            tree->arenas.push_back(std::unique_ptr<arena>(new arena()));
+        }
+    }
+    Tokenizer *tokenizer = tree->tokenizers[0].get();
+
+    if (count > 1)
+    {
+        bool member = data[index.begin] == '{';
+        auto element_begin = [&](size_t i)
+        {
+            return i == 0 ? index.begin + 1 : index.separators[i - 1] + 1;
+        };
+        auto element_end = [&](size_t i)
+        {
+            return i + 1 == elements ? index.end - 1 : index.separators[i];
+        };
+
+        // every worker starts with the elements in its share of the bytes
+        std::unique_ptr<_work_range[]> ranges(new _work_range[count]);
+        size_t span = index.end - index.begin;
+        uint32_t first = 0;
+        for (unsigned w = 0; w < count; w++)
+        {
+            size_t limit = index.begin + span * (w + 1) / count;
+            uint32_t last = first;
+            while (last < elements && (w + 1 == count || element_begin(last) < limit))
+            {
+                last++;
+            }
+            ranges[w].assign(first, last);
+            first = last;
+        }
+
+        std::vector<_element> parsed(elements);
+        std::vector<std::exception_ptr> errors(count);
+        std::atomic<bool> failed(false);
+        run_parallel(count, [&](unsigned w)
+                      {
+            Tokenizer &own = *tree->tokenizers[w];
+            arena *memory = tree->memory(w);
+            uint32_t i, steal_first, steal_last;
+            try
+            {
+                while (!failed.load(std::memory_order_relaxed))
+                {
+                    if (ranges[w].pop(i))
+                    {
+                        if (!_parse_element(data, element_begin(i), element_end(i), member, own, memory, parsed[i]))
+                        {
+                            failed = true;
+                        }
+                        continue;
+                    }
+                    // out of work, take half of what's left of another worker
+                    bool stolen = false;
+                    for (unsigned k = 1; k < count && !stolen; k++)
+                    {
+                        stolen = ranges[(w + k) % count].steal(steal_first, steal_last);
+                    }
+                    if (!stolen)
+                    {
+                        return;
+                    }
+                    ranges[w].assign(steal_first, steal_last);
+                }
+            }
+            catch (...)
+            {
+                errors[w] = std::current_exception();
+                failed = true;
+            } });
+
+        if (!failed)
+        {
+            LazyTypedValues root;
+            if (member)
+            {
+                LazyObject *object = _make_root<LazyObject>(tokenizer, tree->memory(0));
+                object->_list.reserve(elements);
+                root.values.object = object;
+                root.type = LazyType::OBJECT;
+                tree->root = root;
+                for (auto &element : parsed)
+                {
+                    if (element.key.escaped)
+                    {
+                        std::string key = tokenizer->str(element.key);
+                        object->add(key.data(), key.size(), element.value);
+                        continue;
+                    }
+                    object->add(data + element.key.start, element.key.length, element.value);
+                }
+                object->push(index.begin + 1, index.end);
+            }
+            else
+            {
+                LazyList *list = _make_root<LazyList>(tokenizer, tree->memory(0));
+                list->_list.reserve(elements);
+                root.values.list = list;
+                root.type = LazyType::LIST;
+                tree->root = root;
+                for (size_t i = 0; i < elements; i++)
+                {
+                    list->add(int(i), parsed[i].value);
+                }
+                list->push(index.begin + 1, index.end);
+            }
+            return wrapper(tree->root, std::shared_ptr<void>(tree));
+        }
+
+        // nothing parsed so far is kept
+        for (auto &element : parsed)
+        {
+            destroyLazyValue(element.value.values, element.value.type);
+        }
+        for (auto &memory : tree->arenas)
+        {
+            memory->release();
+        }
+        for (auto &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // small, not a container, or doesn't split cleanly
+    tree->root = lazy_parse(0, true, tokenizer, tree->memory(0));
+    return wrapper(tree->root, std::shared_ptr<void>(tree));
+}
+
+END_LAZY_JSON_NAMESPACE
+
+#endif
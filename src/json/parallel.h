@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+
+## Parallel parse
+
+Deep parse of a large document on all cores, the result is the same `LazyObject` / `LazyList`
+tree as the serial deep parse (`lazy_parse(pos, true, ...)`):
+
+1. The buffer is split into chunks of whole scanner blocks, every chunk is scanned on its own
+   thread. The string state at the start of each chunk is resolved from the quote parity of the
+   chunks before it, and the nesting depth from their bracket balance, so the top-level commas
+   of the root container (the structural index) are found without a serial pass.
+2. The top-level members / elements are deep parsed on a work-stealing pool, each worker with
+   its own tokenizer and arena. Workers start with an equal share of the bytes, and once they
+   run out, take half of the remaining elements of another worker.
+3. The root node is assembled from the parsed values, in the json order.
+
+Documents that aren't an object or a list, or that don't split cleanly (malformed), are parsed
+serially, so the result never differs from the serial one.
+
+```cpp
+using namespace lazyjson;
+
+const document doc = document::from_file("records.json");
+wrapper root = parallel_parse(doc);
+for (auto& record : root.list()._list)
+    total += record.values.object->get("amount").values.real;
+```
+
+*/
+
+#include <vector>
+#include <thread>
+#include <stddef.h>
+
+#include "document.h"
+#include "wrappers.h"
+#include "../options.h"
+#include "../namespaces.h"
+
+#if LAZY_JSON_THREADS
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Number of threads for `size` bytes of json: `threads` if it's given, every core
+/// otherwise, but not less than `LAZY_JSON_PARALLEL_CHUNK` bytes per thread
+unsigned thread_count(unsigned threads, size_t size);
+
+/// @brief Run `task(i)` for every `i < count`, each on its own thread (the calling thread
+/// runs `task(0)`). The task must not throw.
+template <class Task>
+void run_parallel(unsigned count, const Task &task)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (unsigned i = 1; i < count; i++)
+    {
+        threads.push_back(std::thread(task, i));
+    }
+    task(0);
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/// @brief Top-level layout of the root container
+typedef struct
+{
+    // position of the opening bracket of the root
+    size_t begin = 0;
+    // position right after the matching closing bracket
+    size_t end = 0;
+    // positions of the commas separating the top-level members / elements
+    std::vector<size_t> separators;
+    // false if the root isn't an object or a list, or it isn't closed
+    bool complete = false;
+} structural_index;
+
+/// @brief Find the top-level separators of the root container, scanning `threads` chunks at once
+/// @param threads number of threads, 0 to use every core
+structural_index index_structure(const char *data, size_t size, unsigned threads = 0);
+
+/// @brief Deep parse the whole document on `threads` threads. The wrapper keeps the parsed nodes
+/// (and the json, if the document owns it) alive.
+/// @param threads number of threads, 0 to use every core, but not less than
+/// `LAZY_JSON_PARALLEL_CHUNK` bytes per thread
+/// @throw `std::runtime_error` on an invalid number, same as the serial parse
+wrapper parallel_parse(const document &doc, unsigned threads = 0);
+
+END_LAZY_JSON_NAMESPACE
+
+#endif
@@ -0,0 +1,301 @@
+#include "path.h"
+#include "errors.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+static bool _is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// @brief Parse a list index, -1 if `text` is not a canonical non-negative integer
+static int _parse_index(const char *text, size_t length)
+{
+    if (length == 0 || length > 9 || (length > 1 && text[0] == '0'))
+    {
+        return -1;
+    }
+    int index = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (!_is_digit(text[i]))
+        {
+            return -1;
+        }
+        index = index * 10 + (text[i] - '0');
+    }
+    return index;
+}
+
+size_t static_path_error(const char *source, size_t length, size_t pos, const char *reason)
+{
+    throw invalid_path(std::string(source, length), pos, reason);
+}
+
+path::path() : _hash(path_hash(nullptr, 0)) {}
+
+path::path(const char *source) : path(std::string(source ? source : "")) {}
+
+path::path(const std::string &source) : _source(source), _hash(path_hash(nullptr, 0))
+{
+    if (!_source.empty() && _source[0] == '/')
+    {
+        _parse_pointer();
+    }
+    else
+    {
+        _parse_dotted();
+    }
+}
+
+path path::dotted(const std::string &source)
+{
+    path p;
+    p._source = source;
+    p._parse_dotted();
+    return p;
+}
+
+path path::pointer(const std::string &source)
+{
+    path p;
+    p._source = source;
+    p._parse_pointer();
+    return p;
+}
+
+void path::_push_key(std::string key, int index)
+{
+    path_segment segment;
+    segment.hash = path_hash(key.data(), key.size());
+    segment.key = std::move(key);
+    segment.index = index;
+    segment.is_key = true;
+    _hash = (_hash ^ segment.hash) * 16777619u;
+    _segments.push_back(std::move(segment));
+}
+
+void path::_push_index(int index)
+{
+    path_segment segment;
+    // indices never collide with keys of the same text
+    std::string text = "[" + std::to_string(index);
+    segment.hash = path_hash(text.data(), text.size());
+    segment.index = index;
+    _hash = (_hash ^ segment.hash) * 16777619u;
+    _segments.push_back(std::move(segment));
+}
+
+void path::_parse_dotted()
+{
+    const std::string &s = _source;
+    size_t pos = 0, n = s.size();
+    while (pos < n)
+    {
+        if (s[pos] == '[')
+        {
+            pos++;
+            if (pos < n && (s[pos] == '"' || s[pos] == '\''))
+            {
+                // quoted key, backslash escapes the next character
+                char quote = s[pos++];
+                std::string key;
+                while (pos < n && s[pos] != quote)
+                {
+                    if (s[pos] == '\\' && pos + 1 < n)
+                    {
+                        pos++;
+                    }
+                    key += s[pos++];
+                }
+                if (pos + 1 >= n || s[pos + 1] != ']')
+                {
+                    throw invalid_path(s, pos, "unterminated quoted key");
+                }
+                pos += 2;
+                _push_key(std::move(key));
+            }
+            else
+            {
+                size_t start = pos;
+                while (pos < n && s[pos] != ']')
+                {
+                    pos++;
+                }
+                int index = _parse_index(s.data() + start, pos - start);
+                if (pos >= n || index < 0)
+                {
+                    throw invalid_path(s, start, "expected index");
+                }
+                pos++;
+                _push_index(index);
+            }
+        }
+        else
+        {
+            size_t start = pos;
+            while (pos < n && s[pos] != '.' && s[pos] != '[')
+            {
+                pos++;
+            }
+            if (pos == start)
+            {
+                throw invalid_path(s, pos, "empty key");
+            }
+            _push_key(s.substr(start, pos - start));
+        }
+
+        // segments are separated by dots, or directly followed by an index
+        if (pos < n && s[pos] == '.')
+        {
+            if (++pos == n)
+            {
+                throw invalid_path(s, pos, "empty key");
+            }
+        }
+        else if (pos < n && s[pos] != '[')
+        {
+            throw invalid_path(s, pos, "expected '.' or '['");
+        }
+    }
+}
+
+void path::_parse_pointer()
+{
+    const std::string &s = _source;
+    if (s.empty())
+    {
+        return;
+    }
+    if (s[0] != '/')
+    {
+        throw invalid_path(s, 0, "JSON Pointer must start with '/'");
+    }
+    size_t pos = 1, n = s.size();
+    while (true)
+    {
+        std::string key;
+        while (pos < n && s[pos] != '/')
+        {
+            if (s[pos] == '~')
+            {
+                if (pos + 1 >= n || (s[pos + 1] != '0' && s[pos + 1] != '1'))
+                {
+                    throw invalid_path(s, pos, "invalid '~' escape");
+                }
+                key += s[pos + 1] == '0' ? '~' : '/';
+                pos += 2;
+                continue;
+            }
+            key += s[pos++];
+        }
+        int index = _parse_index(key.data(), key.size());
+        _push_key(std::move(key), index);
+        if (pos >= n)
+        {
+            break;
+        }
+        pos++;
+    }
+}
+
+path::const_iterator path::begin() const
+{
+    return _segments.begin();
+}
+
+path::const_iterator path::end() const
+{
+    return _segments.end();
+}
+
+size_t path::size() const
+{
+    return _segments.size();
+}
+
+bool path::empty() const
+{
+    return _segments.empty();
+}
+
+const path_segment &path::operator[](size_t i) const
+{
+    return _segments[i];
+}
+
+uint32_t path::hash() const
+{
+    return _hash;
+}
+
+const std::string &path::str() const
+{
+    return _source;
+}
+
+static bool _same_segment(const path_segment &a, const path_segment &b)
+{
+    return a.index == b.index && a.is_key == b.is_key && a.hash == b.hash && a.key == b.key;
+}
+
+path_set::path_set(std::initializer_list<path> paths) : path_set(std::vector<path>(paths)) {}
+
+path_set::path_set(const std::vector<path> &paths) : _paths(paths), _nodes(1)
+{
+    for (size_t id = 0; id < _paths.size(); id++)
+    {
+        _insert(_paths[id], id);
+    }
+}
+
+void path_set::_insert(const path &p, size_t id)
+{
+    size_t current = 0;
+    _nodes[0].total++;
+    for (const path_segment &segment : p)
+    {
+        size_t next = 0;
+        for (size_t child : _nodes[current].children)
+        {
+            if (_same_segment(_nodes[child].segment, segment))
+            {
+                next = child;
+                break;
+            }
+        }
+        if (next == 0)
+        {
+            path_node node;
+            node.segment = segment;
+            next = _nodes.size();
+            _nodes.push_back(node);
+            _nodes[current].children.push_back(next);
+        }
+        current = next;
+        _nodes[current].total++;
+    }
+    _nodes[current].ids.push_back(id);
+}
+
+size_t path_set::size() const
+{
+    return _paths.size();
+}
+
+const path &path_set::operator[](size_t id) const
+{
+    return _paths[id];
+}
+
+const path_node &path_set::node(size_t index) const
+{
+    return _nodes[index];
+}
+
+size_t path_set::nodes() const
+{
+    return _nodes.size();
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,467 @@
+#pragma once
+
+/*
+
+## Path
+
+A `path` is a query compiled once and reused for every extraction, instead of
+building the keys with `operator[]` each time. The keys are stored with their
+lengths and hashes, so running the path is a tight loop of length and hash checks, the
+bytes are only compared (`memcmp`) when both match.
+
+The path is immutable after construction, so the same instance can be shared by
+many extractors (documents) and threads.
+
+Two syntaxes are accepted:
+- dotted: `list[3].main.temp`, keys with special characters can be quoted: `["a.b"]`
+- JSON Pointer (RFC 6901): `/list/3/main/temp`, `~1` stands for `/` and `~0` for `~`.
+  Numeric segments index lists and are used as keys in objects.
+
+```cpp
+using namespace lazyjson;
+
+const path temp("list[3].main.temp");
+
+extractor ex(json);
+float value = ex[temp].extract().asFloat();
+
+ex.set(other_json);
+value = ex.filter(temp).extract().asFloat();
+```
+
+*/
+
+#include <string>
+#include <vector>
+#include <initializer_list>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../options.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief 32-bit FNV-1a hash of the key, `seed` allows to chain hashes of the path segments
+inline uint32_t path_hash(const char *key, size_t length, uint32_t seed = 2166136261u)
+{
+    uint32_t hash = seed;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= uint8_t(key[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/// @brief Same as `path_hash()`, usable in constant expressions (keys known at compile time)
+constexpr uint32_t static_hash(const char *key, size_t length, uint32_t seed = 2166136261u)
+{
+    return length ? static_hash(key + 1, length - 1, uint32_t((seed ^ uint8_t(key[0])) * 16777619u)) : seed;
+}
+
+/// @brief Compile-time sequence `0, 1, ... N - 1` (`std::index_sequence` is C++14)
+template <size_t... I>
+struct index_list
+{
+};
+
+template <size_t N, size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...>
+{
+};
+
+template <size_t... I>
+struct make_index_list<0, I...>
+{
+    typedef index_list<I...> type;
+};
+
+/// @brief Single step of a path, either a key, an index or both (numeric JSON Pointer segment)
+typedef struct
+{
+    std::string key;
+    uint32_t hash = 0;
+    // -1 if the segment can't index a list
+    int index = -1;
+    // the segment can be used as an object key
+    bool is_key = false;
+} path_segment;
+
+class path
+{
+    std::string _source;
+    std::vector<path_segment> _segments;
+    uint32_t _hash;
+
+    void _push_key(std::string key, int index = -1);
+    void _push_index(int index);
+    void _parse_dotted();
+    void _parse_pointer();
+
+public:
+    /// @brief Empty path, resolves to the root value
+    path();
+
+    /// @brief Compile the path, JSON Pointer if it starts with `/`, dotted syntax otherwise
+    /// @throw `lazyjson::invalid_path` if the path is malformed
+    explicit path(const char *source);
+
+    /// @brief Compile the path, see `path(const char*)`
+    explicit path(const std::string &source);
+
+    /// @brief Compile a dotted path: `list[3].main.temp`
+    static path dotted(const std::string &source);
+
+    /// @brief Compile a JSON Pointer: `/list/3/main/temp`
+    static path pointer(const std::string &source);
+
+    typedef std::vector<path_segment>::const_iterator const_iterator;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_t size() const;
+    bool empty() const;
+    const path_segment &operator[](size_t i) const;
+
+    /// @brief Hash of the whole path, chained over the segments
+    uint32_t hash() const;
+
+    /// @brief The source string the path was compiled from
+    const std::string &str() const;
+};
+
+/*
+
+## Path literals
+
+`"main.temp"_jp` is a path parsed by the compiler: the segments are stored in a fixed array
+(`LAZY_JSON_STATIC_PATH_DEPTH` entries), with their lengths and hashes, the keys point into
+the literal itself. Running it allocates nothing and never hashes the literal, the keys of the
+json are compared by length and hash before any bytes, and the hash goes straight to the offset memo.
+
+Same syntax as `path`, except for escapes (backslashes in quoted keys, `~0` / `~1`),
+use `path` for those. With GCC and Clang (C++14 and up) the literal is always parsed at
+compile time and a malformed one is a compile error. Otherwise an inline literal may be parsed
+at run time (and throw `invalid_path`), declare it `constexpr` to be sure.
+
+```cpp
+using namespace lazyjson;
+
+constexpr static_path temp = "list[3].main.temp"_jp;
+float value = ex[temp].extract().asFloat();
+int humidity = ex["/main/humidity"_jp].extract().asInt();
+```
+
+*/
+
+/// @brief Segment of a `static_path`, the key points into the literal
+typedef struct
+{
+    const char *key;
+    size_t length;
+    uint32_t hash;
+    // -1 if the segment can't index a list
+    int index;
+    // the segment can be used as an object key
+    bool is_key;
+} static_segment;
+
+/// @brief Throws `invalid_path`. It's not constexpr, so a malformed literal parsed
+/// at compile time is a compile error.
+[[noreturn]] size_t static_path_error(const char *source, size_t length, size_t pos, const char *reason);
+
+// C++11 constexpr functions can't loop or declare variables, the parser below is a set of
+// recursions over the literal, see `path::_parse_dotted()` and `path::_parse_pointer()`
+
+// no segment after the last one
+constexpr size_t _static_none = size_t(-1);
+
+constexpr bool _static_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool _static_pointer(const char *s, size_t n)
+{
+    return n && s[0] == '/';
+}
+
+constexpr bool _static_digits(const char *s, size_t n)
+{
+    return !n || (_static_digit(s[0]) && _static_digits(s + 1, n - 1));
+}
+
+constexpr int _static_number(const char *s, size_t n, int value = 0)
+{
+    return n ? _static_number(s + 1, n - 1, value * 10 + (s[0] - '0')) : value;
+}
+
+/// @brief List index of the text, -1 if it's not a canonical non-negative integer
+constexpr int _static_index(const char *s, size_t n)
+{
+    return n == 0 || n > 9 || (n > 1 && s[0] == '0') || !_static_digits(s, n) ? -1 : _static_number(s, n);
+}
+
+constexpr size_t _static_key_end(const char *s, size_t n, size_t start, size_t pos)
+{
+    return pos < n && s[pos] != '.' && s[pos] != '[' ? _static_key_end(s, n, start, pos + 1)
+           : pos == start                           ? static_path_error(s, n, pos, "empty key")
+                                                    : pos;
+}
+
+/// @brief Position right after `quote]`
+constexpr size_t _static_quoted_end(const char *s, size_t n, size_t pos, char quote)
+{
+    return pos >= n              ? static_path_error(s, n, pos, "unterminated quoted key")
+           : s[pos] == '\\'      ? static_path_error(s, n, pos, "escapes are not supported in literals, use path")
+           : s[pos] != quote     ? _static_quoted_end(s, n, pos + 1, quote)
+           : pos + 1 < n && s[pos + 1] == ']' ? pos + 2
+                                 : static_path_error(s, n, pos, "unterminated quoted key");
+}
+
+/// @brief Position right after `]`
+constexpr size_t _static_index_end(const char *s, size_t n, size_t start, size_t pos)
+{
+    return pos < n && _static_digit(s[pos]) ? _static_index_end(s, n, start, pos + 1)
+           : pos < n && s[pos] == ']' && _static_index(s + start, pos - start) >= 0 ? pos + 1
+                                            : static_path_error(s, n, start, "expected index");
+}
+
+constexpr size_t _static_pointer_end(const char *s, size_t n, size_t pos)
+{
+    return pos >= n || s[pos] == '/' ? pos
+           : s[pos] == '~'           ? static_path_error(s, n, pos, "escapes are not supported in literals, use path")
+                                     : _static_pointer_end(s, n, pos + 1);
+}
+
+constexpr bool _static_quoted(const char *s, size_t n, size_t start)
+{
+    return start + 1 < n && (s[start + 1] == '"' || s[start + 1] == '\'');
+}
+
+/// @brief End of the segment starting at `start`
+constexpr size_t _static_end(const char *s, size_t n, size_t start)
+{
+    return _static_pointer(s, n)         ? _static_pointer_end(s, n, start)
+           : s[start] != '['             ? _static_key_end(s, n, start, start)
+           : _static_quoted(s, n, start) ? _static_quoted_end(s, n, start + 2, s[start + 1])
+                                         : _static_index_end(s, n, start + 1, start + 1);
+}
+
+/// @brief Start of the segment following the one ending at `end`
+constexpr size_t _static_after(const char *s, size_t n, size_t end)
+{
+    return _static_pointer(s, n) ? (end >= n ? _static_none : end + 1)
+           : end >= n            ? _static_none
+           : s[end] == '['       ? end
+           : s[end] != '.'       ? static_path_error(s, n, end, "expected '.' or '['")
+           : end + 1 < n         ? end + 1
+                                 : static_path_error(s, n, end + 1, "empty key");
+}
+
+constexpr size_t _static_first(const char *s, size_t n)
+{
+    return _static_pointer(s, n) ? 1 : n ? 0 : _static_none;
+}
+
+constexpr size_t _static_next(const char *s, size_t n, size_t start)
+{
+    return _static_after(s, n, _static_end(s, n, start));
+}
+
+/// @brief Start of the `i`-th segment from `start`
+constexpr size_t _static_nth(const char *s, size_t n, size_t start, size_t i)
+{
+    return i == 0 || start == _static_none ? start : _static_nth(s, n, _static_next(s, n, start), i - 1);
+}
+
+constexpr size_t _static_count(const char *s, size_t n, size_t start)
+{
+    return start == _static_none ? 0 : 1 + _static_count(s, n, _static_next(s, n, start));
+}
+
+constexpr size_t _static_depth(const char *s, size_t n)
+{
+    return _static_count(s, n, _static_first(s, n)) <= LAZY_JSON_STATIC_PATH_DEPTH
+               ? _static_count(s, n, _static_first(s, n))
+               : static_path_error(s, n, 0, "too many segments, see LAZY_JSON_STATIC_PATH_DEPTH");
+}
+
+constexpr static_segment _static_key(const char *key, size_t length, int index)
+{
+    return static_segment{key, length, static_hash(key, length), index, true};
+}
+
+/// @brief `text` is `[` and the digits, hashed like `path` hashes indices
+constexpr static_segment _static_list_index(const char *text, size_t length)
+{
+    return static_segment{nullptr, 0, static_hash(text, length), _static_number(text + 1, length - 1), false};
+}
+
+constexpr static_segment _static_segment(const char *s, size_t n, size_t start)
+{
+    return start == _static_none         ? static_segment{nullptr, 0, 0, -1, false}
+           : _static_pointer(s, n)       ? _static_key(s + start, _static_end(s, n, start) - start,
+                                                       _static_index(s + start, _static_end(s, n, start) - start))
+           : s[start] != '['             ? _static_key(s + start, _static_end(s, n, start) - start, -1)
+           : _static_quoted(s, n, start) ? _static_key(s + start + 2, _static_end(s, n, start) - start - 4, -1)
+                                         : _static_list_index(s + start, _static_end(s, n, start) - start - 1);
+}
+
+/// @brief Hash of the path from `start` on, chained like `path::hash()`
+constexpr uint32_t _static_chain(const char *s, size_t n, size_t start, uint32_t hash)
+{
+    return start == _static_none ? hash
+                                 : _static_chain(s, n, _static_next(s, n, start),
+                                                 uint32_t((hash ^ _static_segment(s, n, start).hash) * 16777619u));
+}
+
+class static_path
+{
+    static_segment _segments[LAZY_JSON_STATIC_PATH_DEPTH];
+    size_t _size;
+    uint32_t _hash;
+
+    template <size_t... I>
+    constexpr static_path(const char *source, size_t length, index_list<I...>)
+        : _segments{_static_segment(source, length, _static_nth(source, length, _static_first(source, length), I))...},
+          _size(_static_depth(source, length)),
+          _hash(_static_chain(source, length, _static_first(source, length), 2166136261u)) {}
+
+public:
+    /// @brief Parse the path, the source must outlive it (a literal always does)
+    /// @throw `lazyjson::invalid_path` if the path is malformed, a compile error in constant expressions
+    constexpr static_path(const char *source, size_t length)
+        : static_path(source, length, make_index_list<LAZY_JSON_STATIC_PATH_DEPTH>::type()) {}
+
+    constexpr size_t size() const
+    {
+        return _size;
+    }
+
+    constexpr const static_segment &operator[](size_t i) const
+    {
+        return _segments[i];
+    }
+
+    const static_segment *begin() const
+    {
+        return _segments;
+    }
+
+    const static_segment *end() const
+    {
+        return _segments + _size;
+    }
+
+    /// @brief Same as `path::hash()` of the same path
+    constexpr uint32_t hash() const
+    {
+        return _hash;
+    }
+};
+
+#if defined(__GNUC__) && __cplusplus >= 201402L
+
+/// @brief The literal's characters and its path, both constant (parsed by the compiler even if
+/// the literal is used inline, not only when it's declared `constexpr`)
+template <class Char, Char... Chars>
+struct static_literal
+{
+    static constexpr char source[sizeof...(Chars) + 1] = {Chars..., 0};
+    static constexpr static_path value = static_path(source, sizeof...(Chars));
+};
+
+template <class Char, Char... Chars>
+constexpr char static_literal<Char, Chars...>::source[sizeof...(Chars) + 1];
+
+template <class Char, Char... Chars>
+constexpr static_path static_literal<Char, Chars...>::value;
+
+// string literal operator templates are a GNU extension (GCC, Clang)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wgnu-string-literal-operator-template"
+#endif
+
+/// @brief Path literal, see `static_path`
+template <class Char, Char... Chars>
+constexpr const static_path &operator"" _jp()
+{
+    return static_literal<Char, Chars...>::value;
+}
+
+#pragma GCC diagnostic pop
+
+#else
+
+/// @brief Path literal, see `static_path`
+constexpr static_path operator"" _jp(const char *source, size_t length)
+{
+    return static_path(source, length);
+}
+
+#endif
+
+/// @brief Node of the `path_set` trie, the root node (0) is the filtered value itself
+typedef struct
+{
+    // step from the parent node, unused for the root
+    path_segment segment;
+    std::vector<size_t> children;
+    // ids of the paths ending at this node
+    std::vector<size_t> ids;
+    // number of paths ending at this node or below it
+    size_t total = 0;
+} path_node;
+
+/*
+
+## Path set
+
+Many paths merged into a trie, resolved together in a single forward pass with
+`extractor::extract(const path_set&)`. Subtrees no path goes into are skipped
+without tokenizing, and the pass stops as soon as every path is resolved.
+The results are indexed by the path id (its position in the set).
+
+Like `path`, the set is immutable and can be shared between threads.
+
+```cpp
+using namespace lazyjson;
+
+const path_set fields({path("city.name"), path("list[0].main.temp"), path("list[0].wind.speed")});
+
+extractor ex(json);
+std::vector<wrapper> values = ex.extract(fields);
+values[0].asString(); // city name
+values[1].asFloat();  // temperature
+```
+
+*/
+class path_set
+{
+    std::vector<path> _paths;
+    std::vector<path_node> _nodes;
+
+    void _insert(const path &p, size_t id);
+
+public:
+    path_set(std::initializer_list<path> paths);
+    path_set(const std::vector<path> &paths);
+
+    /// @brief Number of paths in the set
+    size_t size() const;
+
+    /// @brief Path with the given id
+    const path &operator[](size_t id) const;
+
+    /// @brief Trie node, 0 is the root
+    const path_node &node(size_t index) const;
+
+    /// @brief Number of trie nodes
+    size_t nodes() const;
+};
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,348 @@
+#include "scanner.h"
+
+#include <string.h>
+
+#if LAZY_JSON_SIMD && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#   define LAZY_JSON_SCANNER_X86 1
+#   include <immintrin.h>
+#elif LAZY_JSON_SIMD && defined(__aarch64__) && defined(__ARM_NEON)
+#   define LAZY_JSON_SCANNER_NEON 1
+#   include <arm_neon.h>
+#endif
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+typedef void (*classify_fn)(const char *block, structural_masks &masks);
+
+typedef struct
+{
+    classify_fn classify;
+    const char *name;
+} scanner_impl;
+
+static void _classify_scalar(const char *block, structural_masks &masks)
+{
+    uint64_t quote = 0, backslash = 0, whitespace = 0, structural = 0, open = 0, close = 0;
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i++)
+    {
+        uint64_t bit = uint64_t(1) << i;
+        switch (block[i])
+        {
+        case '"':
+            quote |= bit;
+            break;
+        case '\\':
+            backslash |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            whitespace |= bit;
+            break;
+        case '{':
+        case '[':
+            open |= bit;
+            structural |= bit;
+            break;
+        case '}':
+        case ']':
+            close |= bit;
+            structural |= bit;
+            break;
+        case ':':
+        case ',':
+            structural |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+    masks.quote = quote;
+    masks.backslash = backslash;
+    masks.whitespace = whitespace;
+    masks.structural = structural;
+    masks.open = open;
+    masks.close = close;
+}
+
+#if LAZY_JSON_SCANNER_X86
+
+#define _AVX2_EQ(v, c) \
+    uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)))))
+
+__attribute__((target("avx2")))
+static void _classify_avx2(const char *block, structural_masks &masks)
+{
+    uint64_t quote = 0, backslash = 0, whitespace = 0, structural = 0, open = 0, close = 0;
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+        uint64_t o = _AVX2_EQ(v, '{') | _AVX2_EQ(v, '[');
+        uint64_t c = _AVX2_EQ(v, '}') | _AVX2_EQ(v, ']');
+        quote |= _AVX2_EQ(v, '"') << i;
+        backslash |= _AVX2_EQ(v, '\\') << i;
+        whitespace |= (_AVX2_EQ(v, ' ') | _AVX2_EQ(v, '\t') |
+                       _AVX2_EQ(v, '\n') | _AVX2_EQ(v, '\r')) << i;
+        structural |= (o | c | _AVX2_EQ(v, ':') | _AVX2_EQ(v, ',')) << i;
+        open |= o << i;
+        close |= c << i;
+    }
+    masks.quote = quote;
+    masks.backslash = backslash;
+    masks.whitespace = whitespace;
+    masks.structural = structural;
+    masks.open = open;
+    masks.close = close;
+}
+
+#undef _AVX2_EQ
+
+#define _SSE_EQ(v, c) \
+    uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)))))
+
+// `_mm_cmpestrm` with explicit lengths, so NUL bytes in the input don't end the comparison
+#define _SSE42_ANY(set, set_len, v) \
+    uint64_t(uint32_t(_mm_cvtsi128_si32(_mm_cmpestrm(set, set_len, v, 16, \
+        _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK))) & 0xFFFF)
+
+__attribute__((target("sse4.2")))
+static void _classify_sse42(const char *block, structural_masks &masks)
+{
+    const __m128i whitespace_set = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i open_set = _mm_setr_epi8('{', '[', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i close_set = _mm_setr_epi8('}', ']', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    uint64_t quote = 0, backslash = 0, whitespace = 0, structural = 0, open = 0, close = 0;
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        uint64_t o = _SSE42_ANY(open_set, 2, v);
+        uint64_t c = _SSE42_ANY(close_set, 2, v);
+        quote |= _SSE_EQ(v, '"') << i;
+        backslash |= _SSE_EQ(v, '\\') << i;
+        whitespace |= _SSE42_ANY(whitespace_set, 4, v) << i;
+        structural |= (o | c | _SSE_EQ(v, ':') | _SSE_EQ(v, ',')) << i;
+        open |= o << i;
+        close |= c << i;
+    }
+    masks.quote = quote;
+    masks.backslash = backslash;
+    masks.whitespace = whitespace;
+    masks.structural = structural;
+    masks.open = open;
+    masks.close = close;
+}
+
+#undef _SSE_EQ
+#undef _SSE42_ANY
+
+#endif // LAZY_JSON_SCANNER_X86
+
+#if LAZY_JSON_SCANNER_NEON
+
+static inline uint64_t _neon_movemask(uint8x16_t v)
+{
+    const uint8x16_t bits = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t m = vandq_u8(v, bits);
+    return uint64_t(vaddv_u8(vget_low_u8(m))) | (uint64_t(vaddv_u8(vget_high_u8(m))) << 8);
+}
+
+#define _NEON_EQ(v, c) vceqq_u8(v, vdupq_n_u8(c))
+
+static void _classify_neon(const char *block, structural_masks &masks)
+{
+    uint64_t quote = 0, backslash = 0, whitespace = 0, structural = 0, open = 0, close = 0;
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(block + i));
+        uint8x16_t o = vorrq_u8(_NEON_EQ(v, '{'), _NEON_EQ(v, '['));
+        uint8x16_t c = vorrq_u8(_NEON_EQ(v, '}'), _NEON_EQ(v, ']'));
+        quote |= _neon_movemask(_NEON_EQ(v, '"')) << i;
+        backslash |= _neon_movemask(_NEON_EQ(v, '\\')) << i;
+        whitespace |= _neon_movemask(vorrq_u8(vorrq_u8(_NEON_EQ(v, ' '), _NEON_EQ(v, '\t')),
+                                              vorrq_u8(_NEON_EQ(v, '\n'), _NEON_EQ(v, '\r')))) << i;
+        structural |= _neon_movemask(vorrq_u8(vorrq_u8(o, c),
+                                              vorrq_u8(_NEON_EQ(v, ':'), _NEON_EQ(v, ',')))) << i;
+        open |= _neon_movemask(o) << i;
+        close |= _neon_movemask(c) << i;
+    }
+    masks.quote = quote;
+    masks.backslash = backslash;
+    masks.whitespace = whitespace;
+    masks.structural = structural;
+    masks.open = open;
+    masks.close = close;
+}
+
+#undef _NEON_EQ
+
+#endif // LAZY_JSON_SCANNER_NEON
+
+static scanner_impl _select_scanner()
+{
+#if LAZY_JSON_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return {_classify_avx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return {_classify_sse42, "sse4.2"};
+    }
+#elif LAZY_JSON_SCANNER_NEON
+    return {_classify_neon, "neon"};
+#endif
+    return {_classify_scalar, "scalar"};
+}
+
+static const scanner_impl &_scanner()
+{
+    static const scanner_impl impl = _select_scanner();
+    return impl;
+}
+
+void classify(const char *block, structural_masks &masks)
+{
+    _scanner().classify(block, masks);
+}
+
+size_t classify_at(const char *data, size_t pos, size_t end, structural_masks &masks)
+{
+    size_t len = end - pos;
+    if (len >= SCANNER_BLOCK_SIZE)
+    {
+        classify(data + pos, masks);
+        return SCANNER_BLOCK_SIZE;
+    }
+    // pad the tail with whitespace, so it won't be reported as anything meaningful
+    char block[SCANNER_BLOCK_SIZE];
+    memset(block, ' ', SCANNER_BLOCK_SIZE);
+    memcpy(block, data + pos, len);
+    classify(block, masks);
+    return len;
+}
+
+size_t skip_whitespace(const char *data, size_t pos, size_t end)
+{
+    structural_masks masks;
+    while (pos < end)
+    {
+        // minified json rarely has any whitespace, so check the first byte before classifying the block
+        char c = data[pos];
+        if (c != ' ' && c != '\n' && c != '\t' && c != '\r')
+        {
+            return pos;
+        }
+        size_t len = classify_at(data, pos, end, masks);
+        uint64_t other = ~masks.whitespace;
+        if (len < SCANNER_BLOCK_SIZE)
+        {
+            other &= (uint64_t(1) << len) - 1;
+        }
+        if (other)
+        {
+            return pos + ctz64(other);
+        }
+        pos += len;
+    }
+    return end;
+}
+
+uint64_t escaped_mask(uint64_t backslash, uint64_t &carry)
+{
+    const uint64_t even_bits = 0x5555555555555555ULL;
+
+    // the first character is escaped by the previous block, so it can't start a new escape
+    backslash &= ~carry;
+    uint64_t follows_escape = (backslash << 1) | carry;
+
+    // adding the starts of the backslash runs that begin on odd bits to the backslash mask
+    // carries through each run, the carry lands right after the run
+    uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t sequences_starting_on_even_bits = odd_starts + backslash;
+    carry = sequences_starting_on_even_bits < backslash ? 1 : 0;
+    uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+
+    // every other character after a backslash is escaped, flip the runs starting on even bits
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+size_t find_string_end(const char *data, size_t pos, size_t end, bool &escaped)
+{
+    structural_masks masks;
+    uint64_t carry = 0;
+    escaped = false;
+    while (pos < end)
+    {
+        size_t len = classify_at(data, pos, end, masks);
+        uint64_t quotes = masks.quote & ~escaped_mask(masks.backslash, carry);
+        if (quotes)
+        {
+            // backslashes before the closing quote
+            escaped = escaped || (masks.backslash & (quotes ^ (quotes - 1))) != 0;
+            return pos + ctz64(quotes);
+        }
+        escaped = escaped || masks.backslash != 0;
+        pos += len;
+    }
+    return end;
+}
+
+size_t skip_container(const char *data, size_t pos, size_t end)
+{
+    skip_state state;
+    return skip_container(data, pos, end, state);
+}
+
+size_t skip_container(const char *data, size_t pos, size_t end, skip_state &state)
+{
+    structural_masks masks;
+    int &depth = state.depth;
+    uint64_t &in_string = state.in_string;
+    uint64_t &carry = state.carry;
+    while (pos < end)
+    {
+        size_t len = classify_at(data, pos, end, masks);
+        uint64_t quotes = masks.quote & ~escaped_mask(masks.backslash, carry);
+        uint64_t strings = prefix_xor(quotes) ^ in_string;
+        in_string = uint64_t(int64_t(strings) >> 63);
+
+        uint64_t open = masks.open & ~strings;
+        uint64_t close = masks.close & ~strings;
+        int closes = popcount64(close);
+
+        // the depth can't reach 0 in this block, skip it as a whole
+        if (closes < depth)
+        {
+            depth += popcount64(open) - closes;
+            pos += len;
+            continue;
+        }
+
+        uint64_t brackets = open | close;
+        while (brackets)
+        {
+            uint64_t bit = brackets & (~brackets + 1);
+            if (open & bit)
+            {
+                depth++;
+            }
+            else if (--depth == 0)
+            {
+                return pos + ctz64(bit) + 1;
+            }
+            brackets ^= bit;
+        }
+        pos += len;
+    }
+    return end;
+}
+
+const char *scanner_backend()
+{
+    return _scanner().name;
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,132 @@
+#pragma once
+
+/*
+
+Stage-1 structural scanner. Classifies 64 byte blocks of the json string into
+bitmasks (one bit per byte), so the tokenizer can jump straight from one
+structural character to the next instead of reading the input char by char.
+
+The classifier is picked once at runtime:
+- AVX2 / SSE4.2 on x86 (checked with `__builtin_cpu_supports`)
+- NEON on aarch64
+- scalar fallback everywhere else (ESP32, AVR, etc.)
+
+Set `LAZY_JSON_SIMD` to `false` in `options.h` to always use the scalar version.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../options.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+#define SCANNER_BLOCK_SIZE 64
+
+/// @brief Bitmasks of a single 64 byte block, bit `i` is set if `block[i]` belongs to the class
+typedef struct
+{
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t whitespace = 0;
+    // one of: { } [ ] : ,
+    uint64_t structural = 0;
+    // { or [
+    uint64_t open = 0;
+    // } or ]
+    uint64_t close = 0;
+} structural_masks;
+
+/// @brief Classify exactly `SCANNER_BLOCK_SIZE` bytes starting at `block`
+void classify(const char *block, structural_masks &masks);
+
+/// @brief Classify up to `SCANNER_BLOCK_SIZE` bytes from `pos`, bytes past `end` are treated as whitespace
+/// @return number of valid bytes in the block
+size_t classify_at(const char *data, size_t pos, size_t end, structural_masks &masks);
+
+/// @brief Get the position of the first non-whitespace character at or after `pos`, `end` if there is none
+size_t skip_whitespace(const char *data, size_t pos, size_t end);
+
+/// @brief Get the position of the closing quote of a string, skipping escaped quotes (`\\"`)
+/// @param pos position right after the opening quote
+/// @param escaped set to true if the string contains escape sequences
+/// @return position of the closing quote, `end` if there is none
+size_t find_string_end(const char *data, size_t pos, size_t end, bool &escaped);
+
+/// @brief Get the mask of characters escaped by a backslash (odd length backslash runs)
+/// @param backslash backslash mask of the block
+/// @param carry 1 if the first character of the block is escaped by the previous block, updated for the next one
+uint64_t escaped_mask(uint64_t backslash, uint64_t &carry);
+
+/// @brief State of `skip_container()`, carried between calls when the data arrives in chunks
+typedef struct
+{
+    int depth = 1;
+    // all ones if the previous block ended inside a string
+    uint64_t in_string = 0;
+    uint64_t carry = 0;
+} skip_state;
+
+/// @brief Skip the rest of an object or a list, tracking only the nesting depth and whether
+/// the scan is inside a string. Nothing in between is tokenized.
+/// @param pos position right after the opening bracket
+/// @return position right after the matching closing bracket, `end` if there is none
+size_t skip_container(const char *data, size_t pos, size_t end);
+
+/// @brief Resumable `skip_container()`, `state.depth` is 0 once the matching bracket is found.
+/// To continue with more data, `end - pos` must be a multiple of `SCANNER_BLOCK_SIZE`
+/// (except for the last chunk), since the escape and string state is carried per block.
+/// @return position right after the matching closing bracket, `end` if there is none
+size_t skip_container(const char *data, size_t pos, size_t end, skip_state &state);
+
+/// @brief Name of the classifier picked at runtime: "avx2", "sse4.2", "neon" or "scalar"
+const char *scanner_backend();
+
+/// @brief Count trailing zeros of a non-zero mask
+inline int ctz64(uint64_t mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    int n = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/// @brief Count set bits of the mask
+inline int popcount64(uint64_t mask)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(mask);
+#else
+    int n = 0;
+    while (mask)
+    {
+        mask &= mask - 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/// @brief Bit `i` of the result is the xor of bits 0..i of the mask, used to turn the
+/// quote mask into a mask of bytes inside strings
+inline uint64_t prefix_xor(uint64_t mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,393 @@
+#pragma once
+
+/*
+
+## Input policies
+
+`basic_extractor<Policy>` picks at compile time how much the navigation trusts the json:
+
+- `safe_input` (default) - the `extractor` itself: every character is read through the stream
+  (end of data checks), the tokenizer checks for more tokens and throws on unexpected ones
+- `trusted_input` - the json is known to be well-formed (`validate()`d, or generated by the
+  program), the filters walk it with a plain pointer, nothing is checked against the end
+  and nothing malformed is expected
+- `trusted_minified` - well-formed and without whitespace between the tokens (`JSON.stringify()`,
+  ArduinoJson's `serializeJson()`, most APIs), the whitespace skipping is dropped as well
+
+With a trusted policy the filters are pointer increments: a key is compared in place, a skipped
+scalar is a scan for the next `,` `}` or `]`, a skipped object or list goes through the structural
+scanner. Malformed (or, for `trusted_minified`, pretty-printed) json is undefined behavior:
+the filters may read past the end of the data. The values are extracted by an `extractor`
+over the same json, so `extract()` and the wrappers are the same as for the default policy.
+
+```cpp
+using namespace lazyjson;
+
+basic_extractor<trusted_minified> ex(payload, length);
+float temp = ex["list"][3]["main"]["temp"].extract().asFloat();
+int id = ex["/weather/0/id"_jp].extract().asInt();
+```
+
+*/
+
+#include <string>
+#include <string.h>
+#include <stddef.h>
+#if __cplusplus >= 201703L
+#   include <string_view>
+#endif
+
+#include "extractor.h"
+#include "scanner.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Default policy, every read is checked (`extractor`)
+struct safe_input
+{
+};
+
+/// @brief Well-formed json, may have whitespace between the tokens
+struct trusted_input
+{
+    static constexpr bool whitespace = true;
+};
+
+/// @brief Well-formed json without any whitespace between the tokens
+struct trusted_minified
+{
+    static constexpr bool whitespace = false;
+};
+
+/// @brief Navigation over well-formed json with a plain pointer, see `trusted_input`
+template <class Policy = safe_input>
+class basic_extractor
+{
+    const char *_data;
+    size_t _size;
+    // the cached value (the root at first) and the filtered value
+    const char *_root;
+    const char *_value;
+    bool _null;
+    // parses the extracted values
+    extractor _values;
+
+    static bool _is_space(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    static const char *_skip_whitespace(const char *p)
+    {
+        if (Policy::whitespace)
+        {
+            while (_is_space(*p))
+            {
+                p++;
+            }
+        }
+        return p;
+    }
+
+    /// @param p right after the opening quote
+    /// @return the closing quote
+    static const char *_string_end(const char *p, bool &escaped)
+    {
+        while (*p != '"')
+        {
+            if (*p == '\\')
+            {
+                escaped = true;
+                p++;
+            }
+            p++;
+        }
+        return p;
+    }
+
+    static LazyType _type(char c)
+    {
+        switch (c)
+        {
+        case '{':
+            return LazyType::OBJECT;
+        case '[':
+            return LazyType::LIST;
+        case '"':
+            return LazyType::STRING;
+        case 't':
+        case 'f':
+            return LazyType::BOOL;
+        case 'n':
+            return LazyType::NULL_TYPE;
+        default:
+            return LazyType::NUMBER;
+        }
+    }
+
+    /// @return right after the value starting at `p`
+    const char *_skip_value(const char *p) const
+    {
+        switch (*p)
+        {
+        case '"':
+        {
+            bool escaped = false;
+            return _string_end(p + 1, escaped) + 1;
+        }
+        case '{':
+        case '[':
+            return _data + skip_container(_data, size_t(p + 1 - _data), _size);
+        default:
+            // a scalar always ends inside its object or list
+            while (*p != ',' && *p != '}' && *p != ']' && !(Policy::whitespace && _is_space(*p)))
+            {
+                p++;
+            }
+            return p;
+        }
+    }
+
+    /// @return false if the value is null (or was not found)
+    bool _enter(char open, LazyType expected)
+    {
+        if (_null)
+        {
+            return false;
+        }
+        if (*_value == open)
+        {
+            return true;
+        }
+        LazyType type = _type(*_value);
+        // null propagates through the filters
+        if (type == LazyType::NULL_TYPE)
+        {
+            _null = true;
+            return false;
+        }
+        // the next filter starts from the cached value
+        _value = _root;
+        throw invalid_type(expected, type);
+    }
+
+    basic_extractor &_filter_key(const char *key, size_t length)
+    {
+        if (!_enter('{', LazyType::OBJECT))
+        {
+            return *this;
+        }
+        const char *p = _skip_whitespace(_value + 1);
+        if (*p != '}')
+        {
+            for (;;)
+            {
+                bool escaped = false;
+                const char *start = p + 1, *end = _string_end(start, escaped);
+                bool found;
+                if (escaped)
+                {
+                    std::string decoded;
+                    unescape(start, size_t(end - start), decoded);
+                    found = decoded.size() == length && !memcmp(decoded.data(), key, length);
+                }
+                else
+                {
+                    found = size_t(end - start) == length && !memcmp(start, key, length);
+                }
+                // past the colon
+                p = _skip_whitespace(_skip_whitespace(end + 1) + 1);
+                if (found)
+                {
+                    _value = p;
+                    return *this;
+                }
+                p = _skip_whitespace(_skip_value(p));
+                if (*p != ',')
+                {
+                    break;
+                }
+                p = _skip_whitespace(p + 1);
+            }
+        }
+        _null = true;
+        return *this;
+    }
+
+    void _filter_segment(const char *key, size_t length, int index, bool is_key)
+    {
+        // numeric JSON Pointer segments index lists and are keys of objects
+        if (index < 0 || (is_key && !_null && *_value != '['))
+        {
+            static_cast<void>(_filter_key(key, length));
+        }
+        else
+        {
+            static_cast<void>(filter(index));
+        }
+    }
+
+    void _reset_cache()
+    {
+        _value = _root;
+        _null = false;
+    }
+
+public:
+    /// @brief Creates extractor over null-terminated json string, the string is not copied
+    basic_extractor(const char *json) : basic_extractor(json, strlen(json)) {}
+
+    /// @brief Creates extractor over `length` bytes of well-formed json, the string is not copied
+    basic_extractor(const char *json, size_t length)
+        : _data(json), _size(length), _root(_skip_whitespace(json)), _value(_root), _null(false), _values(json, length)
+    {
+    }
+
+#if __cplusplus >= 201703L
+    /// @brief Creates extractor over the viewed json, the data is not copied
+    basic_extractor(std::string_view json) : basic_extractor(json.data(), json.size()) {}
+#endif
+
+    /// @brief Creates extractor over the document, which is kept alive by the extractor
+    explicit basic_extractor(const document &doc)
+        : _data(doc.data()), _size(doc.size()), _root(_skip_whitespace(doc.data())), _value(_root), _null(false), _values(doc)
+    {
+    }
+
+    /// @brief Goes back to the whole json
+    void reset()
+    {
+        _root = _skip_whitespace(_data);
+        _reset_cache();
+    }
+
+    /// @brief The next filters start from the filtered value instead of the root (until `reset()`)
+    void cache()
+    {
+        if (!_null)
+        {
+            _root = _value;
+        }
+        _reset_cache();
+    }
+
+    /// @brief Filters the value by a key, see `extractor::filter(const std::string &)`
+    /// @throw `lazyjson::invalid_type` if the value is not an object
+    basic_extractor &filter(const std::string &key)
+    {
+        return _filter_key(key.data(), key.size());
+    }
+
+    /// @brief Filters the value by an index, see `extractor::filter(int)`
+    /// @throw `lazyjson::invalid_type` if the value is not a list
+    basic_extractor &filter(int index)
+    {
+        if (!_enter('[', LazyType::LIST))
+        {
+            return *this;
+        }
+        const char *p = _skip_whitespace(_value + 1);
+        if (*p != ']' && index >= 0)
+        {
+            for (int i = 0;; i++)
+            {
+                if (i == index)
+                {
+                    _value = p;
+                    return *this;
+                }
+                p = _skip_whitespace(_skip_value(p));
+                if (*p != ',')
+                {
+                    break;
+                }
+                p = _skip_whitespace(p + 1);
+            }
+        }
+        _null = true;
+        return *this;
+    }
+
+    /// @brief Filters the value by every segment of the compiled path
+    basic_extractor &filter(const path &query)
+    {
+        for (const path_segment &segment : query)
+        {
+            if (_null)
+            {
+                break;
+            }
+            _filter_segment(segment.key.data(), segment.key.size(), segment.index, segment.is_key);
+        }
+        return *this;
+    }
+
+    /// @brief Filters the value by every segment of the path literal
+    basic_extractor &filter(const static_path &query)
+    {
+        for (const static_segment &segment : query)
+        {
+            if (_null)
+            {
+                break;
+            }
+            _filter_segment(segment.key, segment.length, segment.index, segment.is_key);
+        }
+        return *this;
+    }
+
+    basic_extractor &operator[](const std::string &key)
+    {
+        return filter(key);
+    }
+
+    basic_extractor &operator[](int index)
+    {
+        return filter(index);
+    }
+
+    basic_extractor &operator[](const path &query)
+    {
+        return filter(query);
+    }
+
+    basic_extractor &operator[](const static_path &query)
+    {
+        return filter(query);
+    }
+
+    /// @brief Extract the filtered value (null if it was not found), the next filter starts
+    /// from the cached value again
+    wrapper extract()
+    {
+        wrapper value;
+        if (!_null)
+        {
+            size_t start = size_t(_value - _data);
+            _reset_cache();
+            value = _values.select(start, _size).extract();
+        }
+        _reset_cache();
+        return value;
+    }
+
+    /// @brief Checks whether the value was not found (or is null), the next filter starts
+    /// from the cached value again
+    bool isNull()
+    {
+        bool is_null = _null || *_value == 'n';
+        _reset_cache();
+        return is_null;
+    }
+};
+
+/// @brief The default policy is the `extractor`, unchanged
+template <>
+class basic_extractor<safe_input> : public extractor
+{
+public:
+    using extractor::extractor;
+};
+
+END_LAZY_JSON_NAMESPACE
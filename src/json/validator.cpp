@@ -0,0 +1,643 @@
+#include "validator.h"
+#include "scanner.h"
+
+#include <string.h>
+
+#if LAZY_JSON_SIMD && defined(__GNUC__) && defined(__SSE2__)
+#   define LAZY_JSON_VALIDATOR_SSE2 1
+#   include <emmintrin.h>
+#endif
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Grammar state, what the next structural character or value can be
+enum _grammar_state : uint8_t
+{
+    _expect_value,
+    _expect_value_or_close,
+    _expect_key,
+    _expect_key_or_close,
+    _expect_colon,
+    _expect_comma_or_close
+};
+
+/// @brief UTF-8 sequence in progress: continuation bytes still needed and the range of the next one
+typedef struct
+{
+    uint8_t need = 0;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+} _utf8_state;
+
+static validation _fail(size_t pos, const char *reason)
+{
+    validation result;
+    result.valid = false;
+    result.position = pos;
+    result.reason = reason;
+    return result;
+}
+
+static validation _pass(size_t end)
+{
+    validation result;
+    result.end = end;
+    return result;
+}
+
+/// @return false if the byte can't follow the bytes before it
+static inline bool _utf8_next(_utf8_state &state, uint8_t byte)
+{
+    if (state.need)
+    {
+        if (byte < state.low || byte > state.high)
+        {
+            return false;
+        }
+        state.need--;
+        state.low = 0x80;
+        state.high = 0xBF;
+        return true;
+    }
+    if (byte < 0x80)
+    {
+        return true;
+    }
+    // continuation bytes and overlong two byte sequences (C0, C1)
+    if (byte < 0xC2)
+    {
+        return false;
+    }
+    if (byte < 0xE0)
+    {
+        state.need = 1;
+        return true;
+    }
+    if (byte < 0xF0)
+    {
+        // E0: no overlongs, ED: no surrogates
+        state.need = 2;
+        state.low = byte == 0xE0 ? 0xA0 : 0x80;
+        state.high = byte == 0xED ? 0x9F : 0xBF;
+        return true;
+    }
+    if (byte < 0xF5)
+    {
+        // F0: no overlongs, F4: nothing above U+10FFFF
+        state.need = 3;
+        state.low = byte == 0xF0 ? 0x90 : 0x80;
+        state.high = byte == 0xF4 ? 0x8F : 0xBF;
+        return true;
+    }
+    return false;
+}
+
+static inline bool _is_hex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/// @param pos position of the escaped character (right after the backslash)
+static bool _valid_escape(const char *data, size_t pos, size_t size)
+{
+    switch (data[pos])
+    {
+    case '"':
+    case '\\':
+    case '/':
+    case 'b':
+    case 'f':
+    case 'n':
+    case 'r':
+    case 't':
+        return true;
+    case 'u':
+        // the closing quote has to follow the 4 digits
+        return pos + 4 < size && _is_hex(data[pos + 1]) && _is_hex(data[pos + 2]) &&
+               _is_hex(data[pos + 3]) && _is_hex(data[pos + 4]);
+    default:
+        return false;
+    }
+}
+
+static inline bool _is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// @brief Byte that can end a number or a literal
+static inline bool _is_delimiter(char c)
+{
+    switch (c)
+    {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ':':
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case '"':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline const char *_check_literal(const char *data, size_t &pos, size_t end, const char *literal, size_t length)
+{
+    if (end - pos == length && !memcmp(data + pos, literal, length))
+    {
+        return nullptr;
+    }
+    // reported at the first byte that doesn't match
+    for (size_t i = 0; i < length && pos < end && data[pos] == literal[i]; i++)
+    {
+        pos++;
+    }
+    return "invalid literal";
+}
+
+/// @brief Check the number or the literal in `[pos, end)`
+/// @return nullptr if it's well-formed, otherwise the error (at `pos`)
+static inline const char *_check_scalar(const char *data, size_t &pos, size_t end)
+{
+    switch (data[pos])
+    {
+    case 't':
+        return _check_literal(data, pos, end, "true", 4);
+    case 'f':
+        return _check_literal(data, pos, end, "false", 5);
+    case 'n':
+        return _check_literal(data, pos, end, "null", 4);
+    default:
+        break;
+    }
+
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    if (data[pos] == '-')
+    {
+        pos++;
+    }
+    if (pos >= end || !_is_digit(data[pos]))
+    {
+        return "invalid number";
+    }
+    if (data[pos] == '0')
+    {
+        pos++;
+    }
+    else
+    {
+        while (pos < end && _is_digit(data[pos]))
+        {
+            pos++;
+        }
+    }
+    if (pos < end && data[pos] == '.')
+    {
+        pos++;
+        if (pos >= end || !_is_digit(data[pos]))
+        {
+            return "invalid number";
+        }
+        while (pos < end && _is_digit(data[pos]))
+        {
+            pos++;
+        }
+    }
+    if (pos < end && (data[pos] == 'e' || data[pos] == 'E'))
+    {
+        pos++;
+        if (pos < end && (data[pos] == '+' || data[pos] == '-'))
+        {
+            pos++;
+        }
+        if (pos >= end || !_is_digit(data[pos]))
+        {
+            return "invalid number";
+        }
+        while (pos < end && _is_digit(data[pos]))
+        {
+            pos++;
+        }
+    }
+    return pos < end ? "invalid number" : nullptr;
+}
+
+/// @brief End of the number or the literal starting at `pos` (the first delimiter)
+static size_t _scalar_end(const char *data, size_t pos, size_t size)
+{
+    while (pos < size && !_is_delimiter(data[pos]))
+    {
+        pos++;
+    }
+    return pos;
+}
+
+/// @brief Check a string byte by byte (a string outside of any container)
+/// @param pos position right after the opening quote
+static validation _check_string(const char *data, size_t pos, size_t size)
+{
+    _utf8_state utf8;
+    for (; pos < size; pos++)
+    {
+        uint8_t c = static_cast<uint8_t>(data[pos]);
+        if (utf8.need || c >= 0x80)
+        {
+            if (!_utf8_next(utf8, c))
+            {
+                return _fail(pos, "invalid UTF-8");
+            }
+            continue;
+        }
+        if (c == '"')
+        {
+            return _pass(pos + 1);
+        }
+        if (c < 0x20)
+        {
+            return _fail(pos, "control character in a string");
+        }
+        if (c == '\\')
+        {
+            if (pos + 1 >= size || !_valid_escape(data, pos + 1, size))
+            {
+                return _fail(pos, "invalid escape sequence");
+            }
+            pos++;
+        }
+    }
+    return _fail(size, "unterminated string");
+}
+
+/// @brief Masks of the control characters (below 0x20) and of the non-ASCII bytes of a block
+static inline void _byte_masks(const char *block, uint64_t &control, uint64_t &high)
+{
+    control = 0;
+    high = 0;
+#if LAZY_JSON_VALIDATOR_SSE2
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        uint64_t h = uint32_t(_mm_movemask_epi8(v));
+        // signed compare, the non-ASCII bytes are negative
+        uint64_t below = uint32_t(_mm_movemask_epi8(_mm_cmplt_epi8(v, _mm_set1_epi8(0x20))));
+        high |= h << i;
+        control |= (below & ~h) << i;
+    }
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // eight bytes at a time, the top bit of every byte is gathered into a bit of the mask
+    const uint64_t top = 0x8080808080808080ull;
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, block + i, sizeof(word));
+        // no borrows between the bytes, `x | 0x80` is at least 0x80
+        uint64_t below = ~((word | top) - 0x2020202020202020ull) & ~word & top;
+        high |= ((((word & top) >> 7) * 0x0102040810204080ull) >> 56) << i;
+        control |= (((below >> 7) * 0x0102040810204080ull) >> 56) << i;
+    }
+#else
+    for (int i = 0; i < SCANNER_BLOCK_SIZE; i++)
+    {
+        uint8_t c = static_cast<uint8_t>(block[i]);
+        high |= uint64_t(c >= 0x80) << i;
+        control |= uint64_t(c < 0x20) << i;
+    }
+#endif
+}
+
+static const char *_expected(_grammar_state state, bool object)
+{
+    switch (state)
+    {
+    case _expect_value:
+        return "expected a value";
+    case _expect_value_or_close:
+        return "expected a value or ']'";
+    case _expect_key:
+        return "expected a key";
+    case _expect_key_or_close:
+        return "expected a key or '}'";
+    case _expect_colon:
+        return "expected ':'";
+    default:
+        return object ? "expected ',' or '}'" : "expected ',' or ']'";
+    }
+}
+
+/// @brief Check an object or a list block by block
+/// @param pos position of the opening bracket, or of the frontier if `from` is set
+/// @param from continue the check inside the container (`pos` is `from->pos`)
+/// @param frontier set to where the check stopped at `stop`, if it stopped right inside the container
+static validation _check_container(const char *data, size_t pos, size_t size, size_t stop,
+                                   const validation_frontier *from, validation_frontier *frontier)
+{
+    // bit set: object, clear: list
+    uint64_t kinds[(LAZY_JSON_MAX_DEPTH + 63) / 64];
+    size_t depth = 0;
+    // the innermost container is an object
+    bool object = false;
+    _grammar_state state = _expect_value;
+    if (from)
+    {
+        // the frontier is outside of any string or scalar, right inside the container
+        depth = 1;
+        object = from->object;
+        kinds[0] = object ? 1 : 0;
+        state = static_cast<_grammar_state>(from->state);
+    }
+    _utf8_state utf8;
+    // all ones if the previous block ended inside a string
+    uint64_t in_string = 0, escape_carry = 0, scalar_carry = 0;
+    char tail[SCANNER_BLOCK_SIZE];
+
+    for (size_t block_pos = pos; block_pos < size; block_pos += SCANNER_BLOCK_SIZE)
+    {
+        const char *block = data + block_pos;
+        size_t length = size - block_pos;
+        if (length < SCANNER_BLOCK_SIZE)
+        {
+            // padded with whitespace, like `classify_at()`
+            memcpy(tail, block, length);
+            memset(tail + length, ' ', SCANNER_BLOCK_SIZE - length);
+            block = tail;
+        }
+        else
+        {
+            length = SCANNER_BLOCK_SIZE;
+        }
+
+        structural_masks masks;
+        classify(block, masks);
+        uint64_t control, high;
+        _byte_masks(block, control, high);
+
+        uint64_t escaped = escaped_mask(masks.backslash, escape_carry);
+        uint64_t quotes = masks.quote & ~escaped;
+        // the opening quotes and the content of the strings
+        uint64_t strings = prefix_xor(quotes) ^ in_string;
+        in_string = uint64_t(int64_t(strings) >> 63);
+        // numbers, literals and anything else outside of the strings
+        uint64_t scalars = ~(masks.whitespace | masks.structural | quotes | strings);
+        uint64_t scalar_starts = scalars & ~((scalars << 1) | scalar_carry);
+        scalar_carry = scalars >> 63;
+        uint64_t tokens = (masks.structural & ~strings) | (quotes & strings) | scalar_starts;
+
+        // bytes of the block checked by the masks below, up to the error or the end of the value
+        size_t limit = length;
+        validation result;
+        bool finished = false;
+        const char *reason = nullptr;
+
+        while (tokens)
+        {
+            size_t index = ctz64(tokens);
+            tokens &= tokens - 1;
+            size_t at = block_pos + index;
+            if (at >= stop)
+            {
+                limit = index;
+                result = _pass(stop);
+                finished = true;
+                if (frontier && depth == 1)
+                {
+                    frontier->pos = at;
+                    frontier->object = object;
+                    frontier->state = state;
+                }
+                break;
+            }
+
+            // structural characters and keys `continue`, the values `break` out of the switch
+            char c = block[index];
+            switch (c)
+            {
+            case ':':
+                if (state != _expect_colon)
+                {
+                    reason = _expected(state, object);
+                    break;
+                }
+                state = _expect_value;
+                continue;
+            case ',':
+                if (state != _expect_comma_or_close)
+                {
+                    reason = _expected(state, object);
+                    break;
+                }
+                state = object ? _expect_key : _expect_value;
+                continue;
+            case '"':
+                if (state == _expect_key || state == _expect_key_or_close)
+                {
+                    state = _expect_colon;
+                    continue;
+                }
+                if (state > _expect_value_or_close)
+                {
+                    reason = _expected(state, object);
+                }
+                break;
+            case '{':
+            case '[':
+                if (state > _expect_value_or_close)
+                {
+                    reason = _expected(state, object);
+                    break;
+                }
+                if (depth >= LAZY_JSON_MAX_DEPTH)
+                {
+                    reason = "nested too deep";
+                    break;
+                }
+                object = c == '{';
+                if (object)
+                {
+                    kinds[depth / 64] |= uint64_t(1) << (depth % 64);
+                }
+                else
+                {
+                    kinds[depth / 64] &= ~(uint64_t(1) << (depth % 64));
+                }
+                depth++;
+                state = object ? _expect_key_or_close : _expect_value_or_close;
+                continue;
+            case '}':
+            case ']':
+                if (c == '}' ? !(state == _expect_key_or_close || (state == _expect_comma_or_close && object))
+                             : !(state == _expect_value_or_close || (state == _expect_comma_or_close && !object)))
+                {
+                    reason = _expected(state, object);
+                    break;
+                }
+                depth--;
+                object = depth && (kinds[(depth - 1) / 64] >> ((depth - 1) % 64) & 1);
+                break;
+            default:
+                if (state > _expect_value_or_close)
+                {
+                    reason = _expected(state, object);
+                    break;
+                }
+            {
+                // the run of scalar bytes, to the next block only if it doesn't end in this one
+                uint64_t rest = ~scalars >> index;
+                size_t end = rest ? at + ctz64(rest) : _scalar_end(data, at, size);
+                reason = _check_scalar(data, at, end);
+                break;
+            }
+            }
+
+            if (reason)
+            {
+                limit = index;
+                result = _fail(at, reason);
+                break;
+            }
+            // a value is done
+            state = _expect_comma_or_close;
+            if (!depth)
+            {
+                limit = index + 1;
+                result = _pass(block_pos + index + 1);
+                finished = true;
+                break;
+            }
+        }
+
+        // the string content before the limit, an earlier error wins over the grammar one
+        uint64_t keep = limit >= SCANNER_BLOCK_SIZE ? ~uint64_t(0) : (uint64_t(1) << limit) - 1;
+        size_t first = block_pos + limit;
+        reason = nullptr;
+        uint64_t bad = control & strings & keep;
+        if (bad)
+        {
+            first = block_pos + ctz64(bad);
+            reason = "control character in a string";
+        }
+        uint64_t escapes = escaped & strings & keep;
+        while (escapes && block_pos + ctz64(escapes) < first)
+        {
+            size_t at = block_pos + ctz64(escapes);
+            if (!_valid_escape(data, at, size))
+            {
+                // reported at the backslash
+                first = at - 1;
+                reason = "invalid escape sequence";
+                break;
+            }
+            escapes &= escapes - 1;
+        }
+        uint64_t pending = high & keep;
+        if (pending || utf8.need)
+        {
+            size_t index = utf8.need ? 0 : ctz64(pending);
+            while (block_pos + index < first)
+            {
+                if (!_utf8_next(utf8, static_cast<uint8_t>(block[index])))
+                {
+                    first = block_pos + index;
+                    reason = "invalid UTF-8";
+                    break;
+                }
+                if (++index >= SCANNER_BLOCK_SIZE)
+                {
+                    break;
+                }
+                if (!utf8.need)
+                {
+                    uint64_t rest = pending & (~uint64_t(0) << index);
+                    if (!rest)
+                    {
+                        break;
+                    }
+                    index = ctz64(rest);
+                }
+            }
+        }
+        if (reason)
+        {
+            return _fail(first, reason);
+        }
+        if (!result.valid || finished)
+        {
+            return result;
+        }
+    }
+    return _fail(size, in_string ? "unterminated string" : "unexpected end of the json");
+}
+
+static validation _check_value(const char *data, size_t size, size_t start, size_t stop, validation_frontier *frontier)
+{
+    start = skip_whitespace(data, start, size);
+    if (start >= size)
+    {
+        return _fail(start, "expected a value");
+    }
+    if (start >= stop)
+    {
+        return _pass(stop);
+    }
+    switch (data[start])
+    {
+    case '{':
+    case '[':
+        return _check_container(data, start, size, stop, nullptr, frontier);
+    case '"':
+        return _check_string(data, start + 1, size);
+    default:
+    {
+        size_t end = _scalar_end(data, start, size);
+        const char *reason = _check_scalar(data, start, end);
+        return reason ? _fail(start, reason) : _pass(end);
+    }
+    }
+}
+
+validation validate(const char *data, size_t size)
+{
+    validation result = _check_value(data, size, 0, size_t(-1), nullptr);
+    if (result.valid)
+    {
+        size_t rest = skip_whitespace(data, result.end, size);
+        if (rest < size)
+        {
+            return _fail(rest, "unexpected content after the value");
+        }
+    }
+    return result;
+}
+
+validation validate(const document &doc)
+{
+    return validate(doc.data(), doc.size());
+}
+
+validation validate_value(const char *data, size_t size, size_t start, size_t stop, validation_frontier *frontier)
+{
+    if (frontier)
+    {
+        frontier->pos = 0;
+    }
+    return _check_value(data, size, start, stop, frontier);
+}
+
+validation validate_rest(const char *data, size_t size, const validation_frontier &from, size_t stop,
+                         validation_frontier *frontier)
+{
+    // `from` may be `*frontier`
+    validation_frontier resume = from;
+    if (frontier)
+    {
+        frontier->pos = 0;
+    }
+    return _check_container(data, resume.pos, size, stop, &resume, frontier);
+}
+
+END_LAZY_JSON_NAMESPACE
@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+
+## Validator
+
+Checks that a json is well-formed without parsing it: the grammar (RFC 8259, strict:
+no trailing commas, no leading zeros, exact `true` / `false` / `null`), the strings
+(escape sequences, no raw control characters), UTF-8 (no overlong sequences, surrogates,
+or code points above U+10FFFF) and the nesting (matching brackets, at most
+`LAZY_JSON_MAX_DEPTH` levels).
+
+The extraction itself trusts the json: the tokenizer skips `true` / `false` / `null`
+by their length and the skipped values are only scanned for their brackets, so a malformed
+document can be misread instead of rejected. Validate untrusted input first.
+
+The json is processed in 64 byte blocks: the stage-1 classifier (`classify()`, vectorized)
+gives the quotes, backslashes and structural characters, the strings are resolved with
+`prefix_xor()` and the control / non-ASCII bytes are found eight at a time in 64-bit words.
+Only the structural characters and the starts of the scalars go through the grammar
+state machine, and only blocks with non-ASCII bytes go through the UTF-8 check.
+
+- `validate()` - the whole json is exactly one value (whitespace around it is fine)
+- `validate_value()` - only the value starting at the position, or its part before `stop`
+  (e.g. what a single extraction reads, see `extractor::validate()`)
+- `validate_rest()` - the rest of an object / list whose check stopped at `stop`
+
+```cpp
+using namespace lazyjson;
+
+validation result = validate(data, size);
+if (!result.valid)
+    Serial.printf("invalid json at %u: %s\n", unsigned(result.position), result.reason);
+```
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "document.h"
+#include "../options.h"
+#include "../namespaces.h"
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+typedef struct
+{
+    bool valid = true;
+    // position of the error (invalid only)
+    size_t position = 0;
+    // static description of the error, nullptr if valid
+    const char *reason = nullptr;
+    // position right after the checked value, or `stop` if it was reached first (valid only)
+    size_t end = 0;
+} validation;
+
+/// @brief Where a check of an object / list stopped (see `validate_value()`), it can be continued
+/// from there with `validate_rest()` instead of checking the container from its start again
+typedef struct
+{
+    // position of the first structural character or value not checked yet,
+    // 0 if the check can't be continued (the value ended, or the check stopped in a nested one)
+    size_t pos = 0;
+    // the container is an object, a list otherwise
+    bool object = false;
+    // what can follow at `pos` (internal)
+    uint8_t state = 0;
+} validation_frontier;
+
+/// @brief What `extractor::validate()` checks
+enum class validation_mode
+{
+    // nothing, the json is trusted (default)
+    none,
+    // the whole json, once
+    full,
+    // only the parts the filters and extractions read, right before they are read
+    touched
+};
+
+/// @brief Check that `data` is exactly one well-formed json value, surrounded by whitespace only
+validation validate(const char *data, size_t size);
+
+/// @brief Check the whole document, see `validate(const char *, size_t)`
+validation validate(const document &doc);
+
+/// @brief Check the value starting at `start` (after the whitespace), what follows it is not checked.
+/// The check ends early at the first structural character or value at or after `stop`,
+/// e.g. to check an object only up to the member an extraction stopped at.
+/// @param data the whole json, the positions are relative to it
+/// @param frontier where the check stopped, if it ended early
+validation validate_value(const char *data, size_t size, size_t start, size_t stop = size_t(-1),
+                          validation_frontier *frontier = nullptr);
+
+/// @brief Continue the check of a container from where it stopped, same as checking it
+/// from its start with `validate_value()` again, without the part already checked
+validation validate_rest(const char *data, size_t size, const validation_frontier &from, size_t stop = size_t(-1),
+                         validation_frontier *frontier = nullptr);
+
+END_LAZY_JSON_NAMESPACE
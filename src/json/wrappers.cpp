@@ -3,28 +3,38 @@
 
 BEGIN_LAZY_JSON_NAMESPACE
 
-wrapper::wrapper(LazyTypedValues value) {
-    this->_value = value;
+wrapper::wrapper(LazyTypedValues value) : _value(value) {
+    // nodes living in an arena are kept alive by it, not by the wrapper,
+    // strings, numbers, booleans and nulls are stored in place
+    if (value.type == LazyType::OBJECT && value.values.object && !value.values.object->_arena){
+        _owner = std::shared_ptr<LazyObject>(value.values.object);
+    } else if (value.type == LazyType::LIST && value.values.list && !value.values.list->_arena){
+        _owner = std::shared_ptr<LazyList>(value.values.list);
+    }
 }
 
-wrapper::wrapper(const wrapper& other) {
-    static_cast<void>(operator=(other));
+wrapper::wrapper(LazyTypedValues value, std::shared_ptr<arena> memory) : _value(value), _owner(std::move(memory)) {}
+
+wrapper::wrapper(LazyTypedValues value, std::shared_ptr<void> owner) : _value(value), _owner(std::move(owner)) {}
+
+wrapper::wrapper(const wrapper& other) : _value(other._value), _owner(other._owner) {}
+
+wrapper::wrapper(wrapper&& other) noexcept : _value(other._value), _owner(std::move(other._owner)) {
+    other._value = LazyTypedValues();
 }
 
 wrapper& wrapper::operator=(const wrapper& other) {
+    _value = other._value;
+    _owner = other._owner;
+    return *this;
+}
 
-#if DEBUG_LAZY_JSON
-    Serial.println("Copying wrapper");
-#endif
-
-    auto values = other._value.values;
-    auto type = other._value.type;
-    // clean up the current values
-    destroyLazyValue(_value.values, _value.type);
-    // copy the new values
-    deepCopyLazyValue(values, type, _value.values);
-    _value.type = type;
-    _value.repr = other._value.repr;
+wrapper& wrapper::operator=(wrapper&& other) noexcept {
+    if (this != &other){
+        _value = other._value;
+        _owner = std::move(other._owner);
+        other._value = LazyTypedValues();
+    }
     return *this;
 }
 
@@ -32,7 +42,17 @@ wrapper::~wrapper(){
 #if DEBUG_LAZY_JSON
     Serial.println("Destroying wrapper");
 #endif
-    destroyLazyValue(_value.values, _value.type);
+}
+
+wrapper wrapper::clone(){
+
+#if DEBUG_LAZY_JSON
+    Serial.println("Copying wrapper");
+#endif
+
+    LazyTypedValues copy = _value;
+    deepCopyLazyValue(_value.values, _value.type, copy.values);
+    return wrapper(copy);
 }
 
 LazyType wrapper::type(){
@@ -78,12 +98,11 @@ String wrapper::asString(){
         return String();
     }
     _assert_type(LazyType::STRING);
-    return String(_value.values.string->str().c_str());
+    return String(decodeLazyString(_value).c_str());
 }
 
 void wrapper::_assert_type(LazyType type){
     if(_value.type != type ){
-        this->~wrapper();
         throw invalid_type(type, _value.type);
     }
 }
@@ -3,6 +3,7 @@
 #include "errors.h"
 #include "objects.h"
 #include <type_traits>
+#include <memory>
 
 #include <Arduino.h>
 
@@ -10,17 +11,32 @@ BEGIN_LAZY_JSON_NAMESPACE
 
 
 
+/// @brief Parsed value. Copies share the parsed nodes (reference counted), nothing is
+/// cloned when a wrapper is returned, stored or assigned, use `clone()` for a deep copy.
 class wrapper
 {
     LazyTypedValues _value;
+    // keeps the nodes alive, either the document's arena or the root node on the heap
+    std::shared_ptr<void> _owner;
     void _assert_type(LazyType type);
 public:
     wrapper() = default;
+    /// @brief Takes over the value, its nodes must be allocated on the heap
     wrapper(LazyTypedValues init);
+    /// @brief Wraps a value parsed into `memory`, the arena is kept as long as the wrapper exists
+    wrapper(LazyTypedValues init, std::shared_ptr<arena> memory);
+    /// @brief Wraps a value whose nodes are kept alive by `owner` (e.g. the arenas of a parallel parse)
+    wrapper(LazyTypedValues init, std::shared_ptr<void> owner);
     wrapper(const wrapper& other);
+    wrapper(wrapper&& other) noexcept;
     ~wrapper();
 
+    /// @brief Shares the value of `other`
     wrapper& operator=(const wrapper& other);
+    wrapper& operator=(wrapper&& other) noexcept;
+
+    /// @brief Deep copy of the value, allocated on the heap and independent of the document
+    wrapper clone();
 
     LazyType type();
     LazyTypedValues& raw();
@@ -61,13 +77,12 @@ inline T wrapper::as()
     if (std::is_same<T, bool>::value){
         return asBool();
     }
-    if (std::is_floating_point<T>::value){
-        return static_cast<T>(_value.values.number);
-    }
-    if (!_value.repr.empty()){
-        return static_cast<T>(std::stoll(_value.repr));
+    _assert_type(LazyType::NUMBER);
+    // integral literals are exact, fractions are truncated for integer types
+    if (_value.flags & LAZY_VALUE_INTEGRAL){
+        return static_cast<T>(_value.values.integer);
     }
-    return static_cast<T>(_value.values.number);
+    return static_cast<T>(_value.values.real);
 }
 
 template<>
@@ -77,7 +92,11 @@ inline String wrapper::as<String>(){
 
 template<>
 inline std::string wrapper::as<std::string>(){
-    return std::string(asString().c_str());
+    if (isNull()){
+        return std::string();
+    }
+    _assert_type(LazyType::STRING);
+    return decodeLazyString(_value);
 }
 
 END_LAZY_JSON_NAMESPACE
@@ -1,3 +1,6 @@
 #pragma once
 
-#include "json/extractor.h"
\ No newline at end of file
+#include "json/extractor.h"
+#include "json/parallel.h"
+#include "json/ndjson.h"
+#include "json/trusted.h"
\ No newline at end of file
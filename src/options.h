@@ -11,3 +11,86 @@
 #   include <Arduino.h>
 #endif
 
+
+
+// Enables vectorized (SSE4.2 / AVX2 / NEON) structural scanning, picked at runtime.
+// Set to false to always use the portable scalar scanner.
+#ifndef LAZY_JSON_SIMD
+#   define LAZY_JSON_SIMD true
+#endif
+
+
+// Enables memory mapped file input (`extractor::from_file()`), available only on POSIX systems.
+#ifndef LAZY_JSON_MMAP
+#   if defined(__unix__) || defined(__APPLE__)
+#       define LAZY_JSON_MMAP true
+#   else
+#       define LAZY_JSON_MMAP false
+#   endif
+#endif
+
+
+// Number of entries (16 bytes each, 32 on 64-bit targets) of the extractor's offset memo, which remembers where
+// the already filtered keys and list elements start. Set to 0 to disable memoization.
+#ifndef LAZY_JSON_MEMO_SIZE
+#   define LAZY_JSON_MEMO_SIZE 64
+#endif
+
+
+// Size of the first block of the per-document arena the parsed values are allocated from,
+// see `arena` and `extractor::useArena()`. Set to 0 to allocate every node on the heap.
+#ifndef LAZY_JSON_ARENA_BLOCK
+#   define LAZY_JSON_ARENA_BLOCK 1024
+#endif
+
+
+// Enables the multithreaded deep parse (`parallel_parse()`), needs `std::thread`.
+#ifndef LAZY_JSON_THREADS
+#   if defined(__unix__) || defined(__APPLE__) || defined(ESP_PLATFORM)
+#       define LAZY_JSON_THREADS true
+#   else
+#       define LAZY_JSON_THREADS false
+#   endif
+#endif
+
+
+// Minimum number of bytes per thread of `parallel_parse()` when the thread count is picked
+// automatically, smaller documents are parsed on fewer threads (or serially).
+#ifndef LAZY_JSON_PARALLEL_CHUNK
+#   define LAZY_JSON_PARALLEL_CHUNK 65536
+#endif
+
+
+// Approximate number of bytes of records a worker of `ndjson_pipeline` takes at once.
+#ifndef LAZY_JSON_NDJSON_BATCH
+#   define LAZY_JSON_NDJSON_BATCH 32768
+#endif
+
+
+// Number of segments a path literal (`"main.temp"_jp`, see `static_path`) can have,
+// every literal takes that many entries.
+#ifndef LAZY_JSON_STATIC_PATH_DEPTH
+#   define LAZY_JSON_STATIC_PATH_DEPTH 8
+#endif
+
+
+// Deepest stack of `cache()`d scopes of an extractor (8 bytes each, kept in the extractor itself),
+// every nested iteration over elements or members takes one more.
+#ifndef LAZY_JSON_MAX_SCOPES
+#   define LAZY_JSON_MAX_SCOPES 16
+#endif
+
+
+// Number of objects / lists whose checked part an extractor remembers in `validation_mode::touched`
+// (16 bytes each on 32-bit targets, kept in the extractor itself, at least 1). Once more of them
+// are touched, the oldest one is forgotten and checked from its start again if it's looked into.
+#ifndef LAZY_JSON_CHECKED_VALUES
+#   define LAZY_JSON_CHECKED_VALUES 8
+#endif
+
+
+// Deepest nesting of objects and lists accepted by the validator (`validate()`),
+// deeper json is rejected before the recursive parse could run out of stack.
+#ifndef LAZY_JSON_MAX_DEPTH
+#   define LAZY_JSON_MAX_DEPTH 128
+#endif
@@ -0,0 +1,97 @@
+#include "mapped_file.h"
+
+#if LAZY_JSON_MMAP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+static std::runtime_error _mapping_error(const char *what, const char *path)
+{
+    return std::runtime_error(std::string("mapped_file: ") + what + " " + path + ": " + strerror(errno));
+}
+
+mapped_file::mapped_file(const char *path, access_pattern pattern)
+    : _data(""), _size(0)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        throw _mapping_error("can't open", path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        throw _mapping_error("can't stat", path);
+    }
+
+    // empty files can't be mapped, leave the data as an empty string
+    if (info.st_size > 0)
+    {
+        void *data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            throw _mapping_error("can't map", path);
+        }
+        _data = static_cast<const char *>(data);
+        _size = size_t(info.st_size);
+    }
+    // the mapping stays valid after closing the descriptor
+    close(fd);
+    advise(pattern);
+}
+
+mapped_file::~mapped_file()
+{
+    if (_size)
+    {
+        munmap(const_cast<char *>(_data), _size);
+    }
+}
+
+void mapped_file::advise(access_pattern pattern)
+{
+    if (!_size)
+    {
+        return;
+    }
+    int advice = MADV_SEQUENTIAL;
+    switch (pattern)
+    {
+    case access_pattern::random:
+        advice = MADV_RANDOM;
+        break;
+    case access_pattern::willneed:
+        advice = MADV_WILLNEED;
+        break;
+    default:
+        break;
+    }
+    // only a hint, failure is not an error
+    static_cast<void>(madvise(const_cast<char *>(_data), _size, advice));
+}
+
+const char *mapped_file::data() const
+{
+    return _data;
+}
+
+size_t mapped_file::size() const
+{
+    return _size;
+}
+
+END_LAZY_JSON_NAMESPACE
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+#include "../options.h"
+#include "../namespaces.h"
+
+#if LAZY_JSON_MMAP
+
+BEGIN_LAZY_JSON_NAMESPACE
+
+/// @brief Expected access pattern of the mapped file, passed to the kernel as a hint
+enum class access_pattern
+{
+    // forward scans, pages behind the cursor can be dropped early (default)
+    sequential,
+    // jumping around the file, no read-ahead
+    random,
+    // prefetch the whole file
+    willneed,
+};
+
+/// @brief Read-only memory mapping of a file, released in the destructor.
+/// Pages are loaded only when they are touched, so lazy extraction reads
+/// only the part of the file it actually scans.
+class mapped_file
+{
+    const char *_data;
+    size_t _size;
+
+public:
+    /// @throw `std::runtime_error` if the file can't be opened or mapped
+    mapped_file(const char *path, access_pattern pattern = access_pattern::sequential);
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /// @brief Give the kernel a new access-pattern hint
+    void advise(access_pattern pattern);
+
+    const char *data() const;
+    size_t size() const;
+};
+
+END_LAZY_JSON_NAMESPACE
+
+#endif
@@ -2,31 +2,123 @@
 
 BEGIN_LAZY_JSON_NAMESPACE
 
-void stream::set(char *data)
+void stream::set(const char *data)
 {
-    if (data != "")
+    set(data, data ? strlen(data) : 0);
+}
+
+void stream::set(const char *data, size_t size)
+{
+    _reader = nullptr;
+    std::vector<char>().swap(_buffer);
+    _offset = 0;
+    _mark = 0;
+    _exhausted = true;
+
+    _data = const_cast<char *>(data);
+    _end = _data ? size : 0;
+    _state = _end ? GOOB_BIT : EOF_BIT;
+    _pos = 0;
+}
+
+void stream::set(stream_reader reader, size_t capacity)
+{
+    _reader = reader;
+    _buffer.assign(capacity, '\0');
+    _data = _buffer.data();
+    _offset = 0;
+    _mark = 0;
+    _exhausted = !_reader || capacity == 0;
+    _end = 0;
+    _pos = 0;
+    _state = GOOB_BIT;
+}
+
+stream::stream(const stream &other)
+{
+    *this = other;
+}
+
+stream &stream::operator=(const stream &other)
+{
+    _pos = other._pos;
+    _end = other._end;
+    _state = other._state;
+    _reader = other._reader;
+    _buffer = other._buffer;
+    _offset = other._offset;
+    _mark = other._mark;
+    _exhausted = other._exhausted;
+    // the copied buffer lives somewhere else
+    _data = _buffer.empty() ? other._data : _buffer.data();
+    return *this;
+}
+
+bool stream::fill()
+{
+    if (_exhausted)
     {
-        _data = data;
-        _state = GOOB_BIT;
-        _end = strlen(_data);
+        return false;
     }
-    else
+
+    // drop everything before the mark, the rest is moved to the front of the buffer
+    size_t keep = _mark < _pos ? _mark : _pos;
+    keep = keep > _end ? _end : (keep < _offset ? _offset : keep);
+    if (keep > _offset)
     {
-        _state = EOF_BIT;
+        memmove(_data, _data + (keep - _offset), _end - keep);
+        _offset = keep;
     }
-    _pos = 0;
+
+    size_t used = _end - _offset;
+    if (used >= _buffer.size())
+    {
+        throw std::runtime_error("stream::fill(): Buffer of " + std::to_string(_buffer.size()) +
+                                 " bytes is too small to hold the value at: " + std::to_string(_offset));
+    }
+
+    size_t read = _reader(_data + used, _buffer.size() - used);
+    if (read == 0)
+    {
+        _exhausted = true;
+        return false;
+    }
+    _end += read;
+    return true;
+}
+
+bool stream::ensure(size_t pos)
+{
+    while (_end < pos)
+    {
+        if (!fill())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void stream::mark(size_t pos)
+{
+    _mark = pos;
+}
+
+bool stream::exhausted()
+{
+    return _exhausted;
 }
 
 void stream::get(char &c)
 {
-    if (eof() || !_data[_pos])
+    if (eof() || (_pos >= _end && !ensure(_pos + 1)))
     {
         _state = EOF_BIT;
         c = EOF_BIT;
     }
     else
     {
-        c = _data[_pos];
+        c = _data[_pos - _offset];
         _pos++;
     }
 }
@@ -44,54 +136,27 @@ void stream::seekg(size_t pos, stream_pos type)
     default:
         break;
     }
+    if (_pos < _offset)
+    {
+        throw std::runtime_error("stream::seekg(): Position " + std::to_string(_pos) +
+                                 " was already dropped from the buffer");
+    }
     clear();
-    if (_pos >= _end)
+    // a streaming source may still have more data past the end
+    if (_pos >= _end && _exhausted)
     {
         _state = EOF_BIT;
         _pos = _end;
     }
 }
 
-size_t stream::tellg()
-{
-    return _pos;
-}
-
 char stream::peek()
 {
-    if (good() && _data[_pos] != 0)
+    if (good() && (_pos < _end || ensure(_pos + 1)))
     {
-        return _data[_pos];
+        return _data[_pos - _offset];
     }
     return BAD_BIT;
 }
 
-size_t stream::size(){
-    return _end;
-}
-
-char* stream::data(){
-    return _data;
-}
-
-void stream::clear(size_t state)
-{
-    _state = state;
-}
-
-bool stream::eof()
-{
-    return (_state & EOF_BIT) != 0;
-}
-
-bool stream::bad()
-{
-    return (_state & BAD_BIT) != 0;
-}
-
-bool stream::good()
-{
-    return _state == GOOB_BIT;
-}
-
 END_LAZY_JSON_NAMESPACE
\ No newline at end of file
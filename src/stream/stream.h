@@ -2,6 +2,9 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
 #include "../namespaces.h"
 
 
@@ -17,8 +20,17 @@ enum stream_pos
     cur,
 };
 
+/// @brief Reads up to `size` bytes into `buffer`, returns the number of bytes read, 0 at the end of the input.
+/// Matches Arduino's `Stream::readBytes()`, so a `WiFiClient` or `File` can be wrapped in a lambda.
+typedef std::function<size_t(char *buffer, size_t size)> stream_reader;
+
 /// @brief Optimized stream, does not copy given char array, and doesn't delete it, a simple
-/// wrapper for char array access
+/// wrapper for char array access. The array doesn't have to be null-terminated,
+/// all bounds checks are done against its known size.
+///
+/// The stream can also pull the data through a `stream_reader` into a fixed-size buffer.
+/// Positions stay absolute (counted from the start of the input), the bytes before the `mark()`
+/// are dropped whenever the buffer is refilled, so only a window of the input is held in memory.
 class stream
 {
     char *_data;
@@ -26,30 +38,120 @@ class stream
     size_t _end;
     int _state;
 
+    // streaming source, empty for plain char arrays
+    stream_reader _reader;
+    std::vector<char> _buffer;
+    // absolute position of `_data[0]`
+    size_t _offset;
+    // bytes from this position on are kept in the buffer
+    size_t _mark;
+    bool _exhausted;
+
 public:
-    stream(char *data = const_cast<char*>(""))
+    stream(const char *data = "")
     {
         set(data);
     }
 
-    void set(char *data);
+    stream(const char *data, size_t size)
+    {
+        set(data, size);
+    }
+
+    /// @brief Streaming source, the data is pulled through `reader` into a buffer of `capacity` bytes
+    stream(stream_reader reader, size_t capacity)
+    {
+        set(reader, capacity);
+    }
+
+    stream(const stream &other);
+    stream &operator=(const stream &other);
+
+    /// @brief Set null-terminated data, the size is computed with `strlen()`
+    void set(const char *data);
+
+    /// @brief Set the data with known size, the data doesn't have to be null-terminated
+    void set(const char *data, size_t size);
+
+    /// @brief Set the streaming source, nothing is read until the data is accessed
+    void set(stream_reader reader, size_t capacity);
+
+    /// @brief Read more data from the reader, dropping everything before the mark (and the cursor)
+    /// @return false if there is nothing more to read
+    /// @throw `std::runtime_error` if the buffer is full and nothing can be dropped
+    bool fill();
+
+    /// @brief Read until the data up to `pos` (exclusive) is available
+    /// @return false if the input ended before `pos`
+    bool ensure(size_t pos);
+
+    /// @brief Keep the data from `pos` on in the buffer, the data before may be dropped on the next `fill()`
+    void mark(size_t pos);
+
+    /// @brief True if there is no more data to read (always true for char arrays)
+    bool exhausted();
+
+    /// @brief True for a streaming source, its buffer is reused, so pointers into it don't stay valid
+    bool streaming() const
+    {
+        return static_cast<bool>(_reader);
+    }
+
+    /// @brief Absolute position of the first byte held in the memory (always 0 for char arrays)
+    size_t offset()
+    {
+        return _offset;
+    }
+
+    /// @brief Pointer to the byte at absolute position `pos`, must be in range [offset(), size()]
+    const char *at(size_t pos)
+    {
+        return _data + (pos - _offset);
+    }
 
     void get(char &c);
 
     void seekg(size_t pos, stream_pos type = stream_pos::base);
-    size_t tellg();
+    size_t tellg()
+    {
+        return _pos;
+    }
 
-    void clear(size_t state = 0);
+    void clear(size_t state = 0)
+    {
+        _state = state;
+    }
 
     /// @brief Allows to 'peek' next value, works the same as `get(char& c)`, but doesn't move the cursor
     /// @return next char, if cursor is at the end of the stream, then returns `EOF_BIT`
     char peek();
 
-    bool eof();
-    bool bad();
-    bool good();
-    size_t size();
-    char* data();
+    bool eof()
+    {
+        return (_state & EOF_BIT) != 0;
+    }
+
+    bool bad()
+    {
+        return (_state & BAD_BIT) != 0;
+    }
+
+    bool good()
+    {
+        return _state == GOOB_BIT;
+    }
+
+    /// @brief Absolute end of the available data
+    size_t size()
+    {
+        return _end;
+    }
+
+    /// @brief The data held in memory, `data()[0]` is at the absolute position `offset()`
+    char *data()
+    {
+        return _data;
+    }
 };
 
 
@@ -0,0 +1,50 @@
+#include "allocations.h"
+
+#include <stdlib.h>
+#include <new>
+
+static size_t _allocations = 0;
+
+void *operator new(size_t size)
+{
+    _allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+namespace tests
+{
+    size_t allocationCount()
+    {
+        return _allocations;
+    }
+}
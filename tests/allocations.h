@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace tests
+{
+    /// @brief Number of `operator new` calls since the start of the program,
+    /// counted by the replacement allocation functions in allocations.cpp
+    size_t allocationCount();
+}
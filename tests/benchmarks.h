@@ -0,0 +1,650 @@
+#pragma once
+
+#include "testCases.h"
+
+namespace tests
+{
+    class BenchmarkCase : public JsonTestCase
+    {
+    public:
+        BenchmarkCase(std::string name = "BenchmarkCase") : JsonTestCase(name) {}
+
+    protected:
+        /// @brief Print the throughput of `bytes` processed in `us` microseconds
+        void reportThroughput(const char *label, size_t bytes, unsigned long us)
+        {
+            if (us == 0)
+            {
+                us = 1;
+            }
+            Serial.printf("\t%s: %lu us, %.2f MB/s\n", label, us, float(bytes) / float(us));
+        }
+
+        void reportTime(const char *label, unsigned long us)
+        {
+            Serial.printf("\t%s: %lu us\n", label, us);
+        }
+    };
+
+    class BenchmarkScannerThroughput : public BenchmarkCase
+    {
+    public:
+        BenchmarkScannerThroughput() : BenchmarkCase("BenchmarkScannerThroughput") {}
+
+        void test()
+        {
+            constexpr int LOOP = 200;
+            Serial.printf("\tScanner backend: %s\n", scanner_backend());
+
+            const char *payloads[] = {FORECAST_API_DATA, WEATHER_API_DATA};
+            const char *names[] = {"forecast", "weather"};
+
+            for (int p = 0; p < 2; p++)
+            {
+                const char *data = payloads[p];
+                size_t size = strlen(data);
+
+                // raw stage-1 classification
+                structural_masks masks;
+                uint64_t structurals = 0;
+                auto start = micros();
+                for (int i = 0; i < LOOP; i++)
+                {
+                    for (size_t pos = 0; pos < size; pos += SCANNER_BLOCK_SIZE)
+                    {
+                        static_cast<void>(classify_at(data, pos, size, masks));
+                        structurals += masks.structural;
+                    }
+                }
+                auto elapsed = micros() - start;
+                assertTrue(structurals != 0);
+                reportThroughput((std::string(names[p]) + " classify").c_str(), size * LOOP, elapsed);
+
+                // every token, the boundaries come from the masks of the block they are in
+                size_t tokens = 0;
+                start = micros();
+                for (int i = 0; i < LOOP; i++)
+                {
+                    Tokenizer tokenizer(data, size);
+                    while (tokenizer.skipWhiteSpace())
+                    {
+                        static_cast<void>(tokenizer.getToken());
+                        tokens++;
+                    }
+                }
+                elapsed = micros() - start;
+                assertTrue(tokens != 0);
+                reportThroughput((std::string(names[p]) + " tokenize").c_str(), size * LOOP, elapsed);
+
+                // skipping the whole document to reach the last key, not memoized
+                extractor ex(data);
+                ex.memoize(0);
+                start = micros();
+                for (int i = 0; i < LOOP; i++)
+                {
+                    ex.reset();
+                    assertFalse(ex[p == 0 ? "city" : "cod"].isNull());
+                }
+                elapsed = micros() - start;
+                reportThroughput((std::string(names[p]) + " filter last key").c_str(), size * LOOP, elapsed);
+            }
+        }
+    };
+
+    class BenchmarkCompiledPath : public BenchmarkCase
+    {
+    public:
+        BenchmarkCompiledPath() : BenchmarkCase("BenchmarkCompiledPath") {}
+
+        void test()
+        {
+            // short paths, the per-call overhead dominates over scanning
+            constexpr int LOOP = 2000;
+            extractor ex(WEATHER_API_DATA);
+
+            float chained = 0;
+            auto start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                chained += ex["coord"]["lon"].extract().asFloat();
+                chained += ex["main"]["humidity"].extract().asInt();
+                chained += ex["weather"][0]["id"].extract().asInt();
+                chained += ex["wind"]["speed"].extract().asFloat();
+            }
+            reportTime("chained filters", micros() - start);
+
+            const path lon("coord.lon"), humidity("main.humidity"), id("weather[0].id"), speed("/wind/speed");
+            float compiled = 0;
+            start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                compiled += ex[lon].extract().asFloat();
+                compiled += ex[humidity].extract().asInt();
+                compiled += ex[id].extract().asInt();
+                compiled += ex[speed].extract().asFloat();
+            }
+            reportTime("compiled paths", micros() - start);
+            assertEqual(compiled, chained, " %f != %f \n");
+
+            float literal = 0;
+            start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                literal += ex["coord.lon"_jp].extract().asFloat();
+                literal += ex["main.humidity"_jp].extract().asInt();
+                literal += ex["weather[0].id"_jp].extract().asInt();
+                literal += ex["/wind/speed"_jp].extract().asFloat();
+            }
+            reportTime("path literals", micros() - start);
+            assertEqual(literal, chained, " %f != %f \n");
+        }
+    };
+
+    class BenchmarkMultiPath : public BenchmarkCase
+    {
+    public:
+        BenchmarkMultiPath() : BenchmarkCase("BenchmarkMultiPath") {}
+
+        void test()
+        {
+            constexpr int LOOP = 50;
+            size_t size = strlen(FORECAST_API_DATA);
+
+            // 42 fields spread over the whole forecast
+            std::vector<path> paths;
+            for (int i = 0; i < 40; i++)
+            {
+                paths.push_back(path("list[" + std::to_string(i) + "].main.temp"));
+            }
+            paths.push_back(path("city.name"));
+            paths.push_back(path("cnt"));
+            const path_set set(paths);
+            extractor ex(FORECAST_API_DATA);
+
+            float separate = 0;
+            auto start = micros();
+            for (int n = 0; n < LOOP; n++)
+            {
+                for (size_t i = 0; i < 40; i++)
+                {
+                    separate += ex.filter(paths[i]).extract().asFloat();
+                }
+                separate += ex.filter(paths[40]).extract().asString().length();
+                separate += ex.filter(paths[41]).extract().asInt();
+            }
+            reportThroughput("42 separate filter chains", size * LOOP, micros() - start);
+
+            float single = 0;
+            start = micros();
+            for (int n = 0; n < LOOP; n++)
+            {
+                std::vector<wrapper> values = ex.extract(set);
+                for (size_t i = 0; i < 40; i++)
+                {
+                    single += values[i].asFloat();
+                }
+                single += values[40].asString().length();
+                single += values[41].asInt();
+            }
+            reportThroughput("single multi-path pass", size * LOOP, micros() - start);
+            assertEqual(single, separate, " %f != %f \n");
+        }
+    };
+
+    class BenchmarkMemo : public BenchmarkCase
+    {
+    public:
+        BenchmarkMemo() : BenchmarkCase("BenchmarkMemo") {}
+
+        void test()
+        {
+            // every element of the list is looked up by index, over and over
+            constexpr int LOOP = 50;
+            extractor plain(FORECAST_API_DATA), memoized(FORECAST_API_DATA);
+            plain.memoize(0);
+            // 40 elements with 2 keys each, the default capacity would keep evicting them
+            memoized.memoize(256);
+
+            float scanned = 0;
+            auto start = micros();
+            for (int n = 0; n < LOOP; n++)
+            {
+                for (int i = 0; i < 40; i++)
+                {
+                    scanned += plain["list"][i]["main"]["temp"].extract().asFloat();
+                }
+            }
+            reportTime("without memo", micros() - start);
+
+            float memo = 0;
+            start = micros();
+            for (int n = 0; n < LOOP; n++)
+            {
+                for (int i = 0; i < 40; i++)
+                {
+                    memo += memoized["list"][i]["main"]["temp"].extract().asFloat();
+                }
+            }
+            reportTime("with memo", micros() - start);
+            const memo_stats &stats = memoized.memoStats();
+            Serial.printf("\tmemo: %lu hits, %lu misses, %lu / %lu entries\n",
+                          (unsigned long)stats.hits, (unsigned long)stats.misses,
+                          (unsigned long)stats.entries, (unsigned long)stats.capacity);
+            assertEqual(memo, scanned, " %f != %f \n");
+        }
+    };
+
+    class BenchmarkIteration : public BenchmarkCase
+    {
+    public:
+        BenchmarkIteration() : BenchmarkCase("BenchmarkIteration") {}
+
+        void test()
+        {
+            // visiting every element of the forecast list
+            constexpr int LOOP = 50;
+            size_t size = strlen(FORECAST_API_DATA);
+            extractor ex(FORECAST_API_DATA);
+            ex.memoize(0);
+
+            float indexed = 0;
+            auto start = micros();
+            for (int n = 0; n < LOOP; n++)
+            {
+                for (int i = 0; i < 40; i++)
+                {
+                    indexed += ex["list"][i]["main"]["temp"].extract().asFloat();
+                }
+            }
+            reportThroughput("indexed, list walked from the head", size * LOOP, micros() - start);
+
+            float iterated = 0;
+            start = micros();
+            for (int n = 0; n < LOOP; n++)
+            {
+                for (auto day : ex["list"].elements())
+                {
+                    iterated += day["main"]["temp"].extract().asFloat();
+                }
+            }
+            reportThroughput("elements(), single pass", size * LOOP, micros() - start);
+            assertEqual(iterated, indexed, " %f != %f \n");
+        }
+    };
+
+    class BenchmarkWrapperCopy : public BenchmarkCase
+    {
+    public:
+        BenchmarkWrapperCopy() : BenchmarkCase("BenchmarkWrapperCopy") {}
+
+        void test()
+        {
+            constexpr int LOOP = 200;
+            extractor ex(FORECAST_API_DATA);
+            ex.useArena(std::make_shared<arena>(1024));
+
+            // the whole forecast list, parsed, then stored over and over
+            wrapper list = ex["list"].extract();
+            for (size_t i = 0; i < list.list().size(); i++)
+            {
+                static_cast<void>(list.list().get(int(i), true));
+            }
+            std::vector<wrapper> stored;
+            stored.reserve(LOOP);
+
+            size_t before = allocationCount();
+            auto start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                stored.push_back(list.clone());
+            }
+            reportTime("deep clones of the list", micros() - start);
+            Serial.printf("\t\t%lu allocations\n", (unsigned long)(allocationCount() - before));
+            stored.clear();
+
+            before = allocationCount();
+            start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                stored.push_back(list);
+            }
+            reportTime("shared copies of the list", micros() - start);
+            assertEqual(allocationCount() - before, size_t(0));
+            stored.clear();
+            list = wrapper();
+
+            // returned by value and used right away, nothing is cloned
+            float lat = 0;
+            static_cast<void>(ex["city"].extract());
+            before = allocationCount();
+            start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                lat += float(ex["city"].extract().object().get("coord").values.object->get("lat").values.real);
+            }
+            reportTime("extract().object()", micros() - start);
+            assertEqual(allocationCount() - before, size_t(0));
+            assertTrue(lat > 0);
+        }
+    };
+
+    class BenchmarkStructBinding : public BenchmarkCase
+    {
+    public:
+        BenchmarkStructBinding() : BenchmarkCase("BenchmarkStructBinding") {}
+
+        void test()
+        {
+            // the weather payload into a struct, one document at a time
+            constexpr int LOOP = 2000;
+            size_t size = strlen(WEATHER_API_DATA);
+
+            double filtered = 0;
+            auto start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                extractor ex(WEATHER_API_DATA);
+                bound_weather report;
+                report.position.lon = ex["coord"]["lon"].extract().as<float>();
+                report.position.lat = ex["coord"]["lat"].extract().as<float>();
+                bound_condition condition;
+                condition.id = ex["weather"][0]["id"].extract().asInt();
+                condition.main = ex["weather"][0]["main"].extract().as<std::string>();
+                condition.description = ex["weather"][0]["description"].extract().as<std::string>();
+                condition.icon = ex["weather"][0]["icon"].extract().asString();
+                report.weather.push_back(condition);
+                report.main.temp = ex["main"]["temp"].extract().as<float>();
+                report.main.feels_like = ex["main"]["feels_like"].extract().as<float>();
+                report.main.pressure = ex["main"]["pressure"].extract().asInt();
+                report.main.humidity = ex["main"]["humidity"].extract().asInt();
+                report.visibility = ex["visibility"].extract().asInt();
+                report.wind.speed = ex["wind"]["speed"].extract().as<float>();
+                report.wind.deg = ex["wind"]["deg"].extract().asInt();
+                report.wind.gust = ex["wind"]["gust"].extract().as<double>();
+                report.dt = ex["dt"].extract().as<int64_t>();
+                report.name = ex["name"].extract().as<std::string>();
+                report.cod = ex["cod"].extract().asInt();
+                filtered += report.main.temp + report.wind.gust + report.weather[0].id;
+            }
+            reportThroughput("field by field", size * LOOP, micros() - start);
+
+            double decoded = 0;
+            start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                extractor ex(WEATHER_API_DATA);
+                bound_weather report;
+                ex.decode(report);
+                decoded += report.main.temp + report.wind.gust + report.weather[0].id;
+            }
+            reportThroughput("decode(), bound struct", size * LOOP, micros() - start);
+            assertEqual(decoded, filtered, " %f != %f \n");
+        }
+    };
+
+    class BenchmarkValidator : public BenchmarkCase
+    {
+    public:
+        BenchmarkValidator() : BenchmarkCase("BenchmarkValidator") {}
+
+        void test()
+        {
+            constexpr int LOOP = 200;
+            const char *payloads[] = {FORECAST_API_DATA, WEATHER_API_DATA};
+            const char *names[] = {"forecast", "weather"};
+
+            for (int p = 0; p < 2; p++)
+            {
+                const char *data = payloads[p];
+                size_t size = strlen(data);
+
+                // the upper bound: copying the json
+                std::vector<char> copy(size);
+                auto start = micros();
+                for (int i = 0; i < LOOP; i++)
+                {
+                    memcpy(copy.data(), data, size);
+                    assertTrue(copy[i % size] == data[i % size]);
+                }
+                reportThroughput((std::string(names[p]) + " memcpy").c_str(), size * LOOP, micros() - start);
+
+                start = micros();
+                for (int i = 0; i < LOOP; i++)
+                {
+                    assertTrue(validate(data, size).valid);
+                }
+                reportThroughput((std::string(names[p]) + " validate()").c_str(), size * LOOP, micros() - start);
+            }
+
+            // a few values of a large document: the whole json vs the parts the extraction reads
+            std::string large = "[";
+            for (int i = 0; i < 32; i++)
+            {
+                large += i ? ", " : "";
+                large += FORECAST_API_DATA;
+            }
+            large += "]";
+            constexpr int LOOKUPS = 20;
+            double full = 0, touched = 0;
+            auto start = micros();
+            for (int i = 0; i < LOOKUPS; i++)
+            {
+                extractor ex(large.data(), large.size());
+                ex.validate();
+                full += ex[1]["list"][0]["main"]["temp"].extract().asFloat();
+            }
+            reportThroughput("full validation + lookup", large.size() * LOOKUPS, micros() - start);
+
+            start = micros();
+            for (int i = 0; i < LOOKUPS; i++)
+            {
+                extractor ex(large.data(), large.size());
+                ex.validate(validation_mode::touched);
+                touched += ex[1]["list"][0]["main"]["temp"].extract().asFloat();
+            }
+            reportThroughput("touched validation + lookup", large.size() * LOOKUPS, micros() - start);
+            assertEqual(full, touched, " %f != %f \n");
+        }
+    };
+
+    class BenchmarkTrustedPolicy : public BenchmarkCase
+    {
+    public:
+        BenchmarkTrustedPolicy() : BenchmarkCase("BenchmarkTrustedPolicy") {}
+
+        template <class Extractor>
+        void run(const char *label, Extractor &ex, double &checksum)
+        {
+            constexpr int LOOP = 500;
+            size_t size = strlen(FORECAST_API_DATA);
+            auto start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                // members of the first elements, tokenized key by key
+                checksum += ex["list"][1]["sys"]["pod"].isNull();
+                checksum += ex["list"][0]["wind"]["gust"].extract().asFloat();
+            }
+            reportTime((std::string(label) + " keys").c_str(), micros() - start);
+
+            start = micros();
+            for (int i = 0; i < LOOP; i++)
+            {
+                // mostly skipped objects
+                checksum += ex["list"][39]["main"]["temp"].extract().asFloat();
+                checksum += ex["city"]["population"].extract().asInt();
+            }
+            reportThroughput((std::string(label) + " skipping").c_str(), size * LOOP, micros() - start);
+        }
+
+        void test()
+        {
+            // the memo would hide the scanning, every lookup starts from the root
+            extractor safe(FORECAST_API_DATA);
+            safe.memoize(0);
+            basic_extractor<trusted_input> trusted(FORECAST_API_DATA);
+            basic_extractor<trusted_minified> minified(FORECAST_API_DATA);
+
+            double checked = 0, spaced = 0, stripped = 0;
+            run("safe_input (extractor)", safe, checked);
+            run("trusted_input", trusted, spaced);
+            run("trusted_minified", minified, stripped);
+            assertEqual(spaced, checked, " %f != %f \n");
+            assertEqual(stripped, checked, " %f != %f \n");
+        }
+    };
+
+#if LAZY_JSON_THREADS
+    class BenchmarkParallelParse : public BenchmarkCase
+    {
+    public:
+        BenchmarkParallelParse() : BenchmarkCase("BenchmarkParallelParse") {}
+
+        void test()
+        {
+            // ~16 MB: [<forecast>, <forecast>, ...], deep parsed as a whole
+            constexpr int COPIES = 1000;
+            std::string json = "[";
+            for (int i = 0; i < COPIES; i++)
+            {
+                json += FORECAST_API_DATA;
+                json += i + 1 < COPIES ? "," : "]";
+            }
+            const document doc(json.data(), json.size());
+            Serial.printf("\t%u hardware threads\n", std::thread::hardware_concurrency());
+
+            Tokenizer tokenizer(doc.data(), doc.size());
+            arena memory;
+            auto start = micros();
+            LazyTypedValues serial = lazy_parse(0, true, &tokenizer, &memory);
+            reportThroughput("serial deep parse", json.size(), micros() - start);
+            assertEqual(serial.values.list->size(), size_t(COPIES), " %lu != %lu \n");
+
+            for (unsigned threads = 1; threads <= 8; threads *= 2)
+            {
+                start = micros();
+                structural_index index = index_structure(doc.data(), doc.size(), threads);
+                reportThroughput(("structural index, " + std::to_string(threads) + " threads").c_str(), json.size(), micros() - start);
+                assertEqual(index.separators.size(), size_t(COPIES - 1), " %lu != %lu \n");
+
+                start = micros();
+                wrapper parallel = parallel_parse(doc, threads);
+                reportThroughput(("parallel deep parse, " + std::to_string(threads) + " threads").c_str(), json.size(), micros() - start);
+                assertEqual(parallel.list().size(), size_t(COPIES), " %lu != %lu \n");
+            }
+        }
+    };
+#endif
+
+#if LAZY_JSON_THREADS
+    class BenchmarkNdjson : public BenchmarkCase
+    {
+    public:
+        BenchmarkNdjson() : BenchmarkCase("BenchmarkNdjson") {}
+
+        void test()
+        {
+            // ~11 MB, one weather record per line
+            constexpr int RECORDS = 20000;
+            std::string json;
+            for (int i = 0; i < RECORDS; i++)
+            {
+                json += WEATHER_API_DATA;
+                json += '\n';
+            }
+            const document doc(json.data(), json.size());
+
+            // an extractor and filter chains per line
+            double chained = 0;
+            auto start = micros();
+            for (size_t pos = 0; pos < json.size();)
+            {
+                size_t end = json.find('\n', pos);
+                extractor ex(json.data() + pos, end - pos);
+                chained += ex["main"]["temp"].extract().asFloat();
+                chained += ex["wind"]["speed"].extract().asFloat();
+                chained += ex["name"].extract().asString().length();
+                pos = end + 1;
+            }
+            reportThroughput("extractor per line", json.size(), micros() - start);
+
+            const path_set fields({path("main.temp"), path("wind.speed"), path("name")});
+            for (unsigned threads = 1; threads <= 8; threads *= 2)
+            {
+                for (int o = 0; o < 2; o++)
+                {
+                    record_order order = o ? record_order::unordered : record_order::input;
+                    double sum = 0;
+                    ndjson_stats stats = ndjson_pipeline(fields, threads, order).run(doc, [&](ndjson_record &record)
+                                                                                     {
+                        sum += record.values[0].asFloat();
+                        sum += record.values[1].asFloat();
+                        sum += record.values[2].asString().length(); });
+                    Serial.printf("\tpipeline, %u threads, %s: %.0f records/s, %.2f MB/s\n", threads,
+                                  o ? "unordered" : "in order", stats.records_per_second, stats.bytes_per_second / 1e6);
+                    assertEqual(stats.records, size_t(RECORDS), " %lu != %lu \n");
+                    // the records are summed in a different order
+                    assertTrue(sum - chained < 1 && chained - sum < 1);
+                }
+            }
+        }
+    };
+#endif
+
+#if LAZY_JSON_MMAP
+    class BenchmarkMappedFile : public BenchmarkCase
+    {
+    public:
+        BenchmarkMappedFile() : BenchmarkCase("BenchmarkMappedFile") {}
+
+        void test()
+        {
+            // ~64 MB: {"first": 1, "list": [<forecast>, <forecast>, ...], "last": 2}
+            constexpr int COPIES = 4000;
+            const char *path = "/tmp/lazyjson_mapped_file_benchmark.json";
+            size_t payload = strlen(FORECAST_API_DATA);
+
+            FILE *file = fopen(path, "wb");
+            assertTrue(file != nullptr);
+            fputs("{\"first\": 1, \"list\": [", file);
+            for (int i = 0; i < COPIES; i++)
+            {
+                fwrite(FORECAST_API_DATA, 1, payload, file);
+                fputc(i + 1 < COPIES ? ',' : ']', file);
+            }
+            fputs(", \"last\": 2}", file);
+            fclose(file);
+
+            // read into memory
+            auto start = micros();
+            std::string buffer;
+            file = fopen(path, "rb");
+            fseek(file, 0, SEEK_END);
+            buffer.resize(size_t(ftell(file)));
+            fseek(file, 0, SEEK_SET);
+            size_t read = fread(&buffer[0], 1, buffer.size(), file);
+            fclose(file);
+            extractor in_memory(buffer.data(), read);
+            assertEqual(in_memory["first"].extract().asInt(), 1, " %i != %i \n");
+            auto elapsed = micros() - start;
+            reportTime("read into memory, time to first value", elapsed);
+
+            start = micros();
+            assertEqual(in_memory["last"].extract().asInt(), 2, " %i != %i \n");
+            reportThroughput("read into memory, last value", buffer.size(), micros() - start);
+
+            // memory mapped, only the first page is touched
+            start = micros();
+            extractor mapped = extractor::from_file(path);
+            assertEqual(mapped["first"].extract().asInt(), 1, " %i != %i \n");
+            elapsed = micros() - start;
+            reportTime("memory mapped, time to first value", elapsed);
+
+            start = micros();
+            assertEqual(mapped["last"].extract().asInt(), 2, " %i != %i \n");
+            reportThroughput("memory mapped, last value", buffer.size(), micros() - start);
+
+            remove(path);
+        }
+    };
+#endif
+}
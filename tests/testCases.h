@@ -1,12 +1,106 @@
 #pragma once
 
 #include "TestCase.h"
+#include "testData.h"
+#include "allocations.h"
 #include <lazyjson.h>
 
 #include <vector>
+#include <cmath>
+#include <thread>
+#include <memory>
+
+#if LAZY_JSON_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace lazyjson;
 
+namespace tests
+{
+    // structs bound to the weather payloads, see StructBindingTest and BenchmarkStructBinding
+    struct bound_coord
+    {
+        float lon = 0;
+        float lat = 0;
+    };
+
+    struct bound_condition
+    {
+        int id = 0;
+        std::string main;
+        std::string description;
+        String icon;
+    };
+
+    struct bound_main
+    {
+        float temp = 0;
+        float feels_like = 0;
+        int pressure = 0;
+        int humidity = 0;
+    };
+
+    struct bound_wind
+    {
+        float speed = 0;
+        int deg = 0;
+        double gust = 0;
+    };
+
+    struct bound_weather
+    {
+        bound_coord position;
+        std::vector<bound_condition> weather;
+        bound_main main;
+        int visibility = 0;
+        bound_wind wind;
+        int64_t dt = 0;
+        std::string name;
+        int cod = 0;
+    };
+
+    struct bound_forecast_day
+    {
+        long dt = 0;
+        bound_main main;
+        std::vector<bound_condition> weather;
+    };
+
+    struct bound_forecast
+    {
+        std::string cod;
+        int cnt = 0;
+        std::vector<bound_forecast_day> list;
+    };
+
+    struct bound_misc
+    {
+        int id = 0;
+        int missing = 5;
+        int nothing = 6;
+        std::string tag;
+        std::vector<bool> flags;
+        std::vector<float> values;
+        std::vector<std::vector<int>> matrix;
+    };
+}
+
+LAZY_JSON_BIND(tests::bound_coord, LAZY_JSON_FIELD(lon), LAZY_JSON_FIELD(lat))
+LAZY_JSON_BIND(tests::bound_condition, LAZY_JSON_FIELD(id), LAZY_JSON_FIELD(main), LAZY_JSON_FIELD(description),
+               LAZY_JSON_FIELD(icon))
+LAZY_JSON_BIND(tests::bound_main, LAZY_JSON_FIELD(temp), LAZY_JSON_FIELD(feels_like), LAZY_JSON_FIELD(pressure),
+               LAZY_JSON_FIELD(humidity))
+LAZY_JSON_BIND(tests::bound_wind, LAZY_JSON_FIELD(speed), LAZY_JSON_FIELD(deg), LAZY_JSON_FIELD(gust))
+LAZY_JSON_BIND(tests::bound_weather, LAZY_JSON_FIELD_AS(position, "coord"), LAZY_JSON_FIELD(weather), LAZY_JSON_FIELD(main),
+               LAZY_JSON_FIELD(visibility), LAZY_JSON_FIELD(wind), LAZY_JSON_FIELD(dt), LAZY_JSON_FIELD(name),
+               LAZY_JSON_FIELD(cod))
+LAZY_JSON_BIND(tests::bound_forecast_day, LAZY_JSON_FIELD(dt), LAZY_JSON_FIELD(main), LAZY_JSON_FIELD(weather))
+LAZY_JSON_BIND(tests::bound_forecast, LAZY_JSON_FIELD(cod), LAZY_JSON_FIELD(cnt), LAZY_JSON_FIELD(list))
+LAZY_JSON_BIND(tests::bound_misc, LAZY_JSON_FIELD(id), LAZY_JSON_FIELD(missing), LAZY_JSON_FIELD(nothing),
+               LAZY_JSON_FIELD(tag), LAZY_JSON_FIELD(flags), LAZY_JSON_FIELD(values), LAZY_JSON_FIELD(matrix))
+
 namespace tests
 {
     struct MemoryWatchpoint
@@ -143,10 +237,7 @@ namespace tests
 
         void test(){
             setMemoryWatchpoint();
-            extractor extractor(
-                "{\"coord\":{\"lon\":17.2903,\"lat\":50.9571},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"base\":\"stations\",\"main\":"
-                "{\"temp\":-6.26,\"feels_like\":-12.88,\"temp_min\":-7.22,\"temp_max\":-6.03,\"pressure\":1020,\"humidity\":77,\"sea_level\":1020,\"grnd_level\":1004},\"visibility\":10000,"
-                "\"wind\":{\"speed\":5.2,\"deg\":17,\"gust\":8.05},\"clouds\":{\"all\":100},\"dt\":1704642926,\"sys\":{\"type\":2,\"id\":2034837,\"country\":\"PL\",\"sunrise\":1704610351,\"sunset\":1704639641},\"timezone\":3600,\"id\":7532481,\"name\":\"Oława\",\"cod\":200}");
+            extractor extractor(WEATHER_API_DATA);
 
             assertLazyType(extractor["coord"]["lon"].extract().raw(), LazyType::NUMBER);
             assertLazyType(extractor["coord"]["lat"].extract().raw(), LazyType::NUMBER);
@@ -249,7 +340,7 @@ namespace tests
             setMemoryWatchpoint();
             // Not gonna visualize this nicely -.-
 
-            const char* data = "{\"cod\":\"200\",\"message\":0,\"cnt\":40,\"list\":[{\"dt\":1704650400,\"main\":{\"temp\":-6.7,\"feels_like\":-13.23,\"temp_min\":-6.7,\"temp_max\":-5.91,\"pressure\":1021,\"sea_level\":1021,\"grnd_level\":1005,\"humidity\":78,\"temp_kf\":-0.79},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":100},\"wind\":{\"speed\":4.91,\"deg\":16,\"gust\":7.55},\"visibility\":10000,\"pop\":0.16,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-07 18:00:00\"},{\"dt\":1704661200,\"main\":{\"temp\":-6.71,\"feels_like\":-12.99,\"temp_min\":-6.72,\"temp_max\":-6.71,\"pressure\":1022,\"sea_level\":1022,\"grnd_level\":1007,\"humidity\":79,\"temp_kf\":0.01},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":99},\"wind\":{\"speed\":4.57,\"deg\":12,\"gust\":6.99},\"visibility\":10000,\"pop\":0.12,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-07 21:00:00\"},{\"dt\":1704672000,\"main\":{\"temp\":-7.21,\"feels_like\":-13.51,\"temp_min\":-7.46,\"temp_max\":-7.21,\"pressure\":1023,\"sea_level\":1023,\"grnd_level\":1008,\"humidity\":79,\"temp_kf\":0.25},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":98},\"wind\":{\"speed\":4.44,\"deg\":14,\"gust\":6.86},\"visibility\":10000,\"pop\":0.12,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-08 00:00:00\"},{\"dt\":1704682800,\"main\":{\"temp\":-7.55,\"feels_like\":-13.91,\"temp_min\":-7.55,\"temp_max\":-7.55,\"pressure\":1025,\"sea_level\":1025,\"grnd_level\":1009,\"humidity\":79,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":99},\"wind\":{\"speed\":4.42,\"deg\":17,\"gust\":6.91},\"visibility\":10000,\"pop\":0.03,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-08 03:00:00\"},{\"dt\":1704693600,\"main\":{\"temp\":-7.86,\"feels_like\":-14.1,\"temp_min\":-7.86,\"temp_max\":-7.86,\"pressure\":1027,\"sea_level\":1027,\"grnd_level\":1011,\"humidity\":81,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":99},\"wind\":{\"speed\":4.18,\"deg\":20,\"gust\":7.12},\"visibility\":10000,\"pop\":0.03,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-08 06:00:00\"},{\"dt\":1704704400,\"main\":{\"temp\":-7.25,\"feels_like\":-13.87,\"temp_min\":-7.25,\"temp_max\":-7.25,\"pressure\":1029,\"sea_level\":1029,\"grnd_level\":1012,\"humidity\":74,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04d\"}],\"clouds\":{\"all\":86},\"wind\":{\"speed\":4.84,\"deg\":34,\"gust\":7.22},\"visibility\":10000,\"pop\":0.02,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-08 09:00:00\"},{\"dt\":1704715200,\"main\":{\"temp\":-5.88,\"feels_like\":-12.21,\"temp_min\":-5.88,\"temp_max\":-5.88,\"pressure\":1029,\"sea_level\":1029,\"grnd_level\":1013,\"humidity\":64,\"temp_kf\":0},\"weather\":[{\"id\":803,\"main\":\"Clouds\",\"description\":\"zachmurzenie umiarkowane\",\"icon\":\"04d\"}],\"clouds\":{\"all\":75},\"wind\":{\"speed\":4.92,\"deg\":39,\"gust\":6.81},\"visibility\":10000,\"pop\":0.01,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-08 12:00:00\"},{\"dt\":1704726000,\"main\":{\"temp\":-6.97,\"feels_like\":-12.87,\"temp_min\":-6.97,\"temp_max\":-6.97,\"pressure\":1031,\"sea_level\":1031,\"grnd_level\":1015,\"humidity\":74,\"temp_kf\":0},\"weather\":[{\"id\":802,\"main\":\"Clouds\",\"description\":\"zachmurzenie małe\",\"icon\":\"03d\"}],\"clouds\":{\"all\":28},\"wind\":{\"speed\":4.03,\"deg\":27,\"gust\":7.24},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-08 15:00:00\"},{\"dt\":1704736800,\"main\":{\"temp\":-7.82,\"feels_like\":-13.27,\"temp_min\":-7.82,\"temp_max\":-7.82,\"pressure\":1033,\"sea_level\":1033,\"grnd_level\":1016,\"humidity\":81,\"temp_kf\":0},\"weather\":[{\"id\":801,\"main\":\"Clouds\",\"description\":\"pochmurnie\",\"icon\":\"02n\"}],\"clouds\":{\"all\":21},\"wind\":{\"speed\":3.35,\"deg\":34,\"gust\":6.81},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-08 18:00:00\"},{\"dt\":1704747600,\"main\":{\"temp\":-8.45,\"feels_like\":-13.06,\"temp_min\":-8.45,\"temp_max\":-8.45,\"pressure\":1034,\"sea_level\":1034,\"grnd_level\":1018,\"humidity\":81,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":2.52,\"deg\":35,\"gust\":5.14},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-08 21:00:00\"},{\"dt\":1704758400,\"main\":{\"temp\":-9.22,\"feels_like\":-13.7,\"temp_min\":-9.22,\"temp_max\":-9.22,\"pressure\":1035,\"sea_level\":1035,\"grnd_level\":1019,\"humidity\":83,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":2.33,\"deg\":30,\"gust\":4.98},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-09 00:00:00\"},{\"dt\":1704769200,\"main\":{\"temp\":-9.76,\"feels_like\":-13.35,\"temp_min\":-9.76,\"temp_max\":-9.76,\"pressure\":1036,\"sea_level\":1036,\"grnd_level\":1019,\"humidity\":85,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":4},\"wind\":{\"speed\":1.73,\"deg\":37,\"gust\":3.05},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-09 03:00:00\"},{\"dt\":1704780000,\"main\":{\"temp\":-10.14,\"feels_like\":-10.14,\"temp_min\":-10.14,\"temp_max\":-10.14,\"pressure\":1037,\"sea_level\":1037,\"grnd_level\":1020,\"humidity\":87,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":4},\"wind\":{\"speed\":1.07,\"deg\":78,\"gust\":1.34},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-09 06:00:00\"},{\"dt\":1704790800,\"main\":{\"temp\":-7.59,\"feels_like\":-10.53,\"temp_min\":-7.59,\"temp_max\":-7.59,\"pressure\":1038,\"sea_level\":1038,\"grnd_level\":1021,\"humidity\":75,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":4},\"wind\":{\"speed\":1.56,\"deg\":125,\"gust\":2.78},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-09 09:00:00\"},{\"dt\":1704801600,\"main\":{\"temp\":-5.29,\"feels_like\":-7.53,\"temp_min\":-5.29,\"temp_max\":-5.29,\"pressure\":1037,\"sea_level\":1037,\"grnd_level\":1020,\"humidity\":65,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":3},\"wind\":{\"speed\":1.37,\"deg\":109,\"gust\":2.58},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-09 12:00:00\"},{\"dt\":1704812400,\"main\":{\"temp\":-7.38,\"feels_like\":-7.38,\"temp_min\":-7.38,\"temp_max\":-7.38,\"pressure\":1037,\"sea_level\":1037,\"grnd_level\":1020,\"humidity\":82,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":2},\"wind\":{\"speed\":0.9,\"deg\":250,\"gust\":1.02},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-09 15:00:00\"},{\"dt\":1704823200,\"main\":{\"temp\":-8.82,\"feels_like\":-8.82,\"temp_min\":-8.82,\"temp_max\":-8.82,\"pressure\":1037,\"sea_level\":1037,\"grnd_level\":1020,\"humidity\":89,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":3},\"wind\":{\"speed\":1.28,\"deg\":241,\"gust\":1.24},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-09 18:00:00\"},{\"dt\":1704834000,\"main\":{\"temp\":-9.37,\"feels_like\":-9.37,\"temp_min\":-9.37,\"temp_max\":-9.37,\"pressure\":1037,\"sea_level\":1037,\"grnd_level\":1020,\"humidity\":90,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":1.07,\"deg\":202,\"gust\":1.02},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-09 21:00:00\"},{\"dt\":1704844800,\"main\":{\"temp\":-9.53,\"feels_like\":-12.45,\"temp_min\":-9.53,\"temp_max\":-9.53,\"pressure\":1036,\"sea_level\":1036,\"grnd_level\":1019,\"humidity\":88,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":1.42,\"deg\":188,\"gust\":1.36},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-10 00:00:00\"},{\"dt\":1704855600,\"main\":{\"temp\":-9.8,\"feels_like\":-13.52,\"temp_min\":-9.8,\"temp_max\":-9.8,\"pressure\":1036,\"sea_level\":1036,\"grnd_level\":1019,\"humidity\":86,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":1.8,\"deg\":173,\"gust\":1.78},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-10 03:00:00\"},{\"dt\":1704866400,\"main\":{\"temp\":-9.88,\"feels_like\":-13.7,\"temp_min\":-9.88,\"temp_max\":-9.88,\"pressure\":1036,\"sea_level\":1036,\"grnd_level\":1019,\"humidity\":83,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":1.85,\"deg\":167,\"gust\":1.81},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-10 06:00:00\"},{\"dt\":1704877200,\"main\":{\"temp\":-7.14,\"feels_like\":-11.04,\"temp_min\":-7.14,\"temp_max\":-7.14,\"pressure\":1036,\"sea_level\":1036,\"grnd_level\":1019,\"humidity\":69,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":2},\"wind\":{\"speed\":2.18,\"deg\":176,\"gust\":3.03},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-10 09:00:00\"},{\"dt\":1704888000,\"main\":{\"temp\":-3.91,\"feels_like\":-6.07,\"temp_min\":-3.91,\"temp_max\":-3.91,\"pressure\":1035,\"sea_level\":1035,\"grnd_level\":1019,\"humidity\":60,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":1},\"wind\":{\"speed\":1.42,\"deg\":151,\"gust\":1.62},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-10 12:00:00\"},{\"dt\":1704898800,\"main\":{\"temp\":-6.31,\"feels_like\":-9.39,\"temp_min\":-6.31,\"temp_max\":-6.31,\"pressure\":1034,\"sea_level\":1034,\"grnd_level\":1017,\"humidity\":80,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":0},\"wind\":{\"speed\":1.74,\"deg\":182,\"gust\":1.69},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-10 15:00:00\"},{\"dt\":1704909600,\"main\":{\"temp\":-7.5,\"feels_like\":-9.97,\"temp_min\":-7.5,\"temp_max\":-7.5,\"pressure\":1033,\"sea_level\":1033,\"grnd_level\":1017,\"humidity\":81,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":2},\"wind\":{\"speed\":1.34,\"deg\":185,\"gust\":1.32},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-10 18:00:00\"},{\"dt\":1704920400,\"main\":{\"temp\":-7.79,\"feels_like\":-7.79,\"temp_min\":-7.79,\"temp_max\":-7.79,\"pressure\":1032,\"sea_level\":1032,\"grnd_level\":1016,\"humidity\":81,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":7},\"wind\":{\"speed\":0.85,\"deg\":197,\"gust\":0.82},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-10 21:00:00\"},{\"dt\":1704931200,\"main\":{\"temp\":-7.81,\"feels_like\":-10.66,\"temp_min\":-7.81,\"temp_max\":-7.81,\"pressure\":1031,\"sea_level\":1031,\"grnd_level\":1015,\"humidity\":81,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":10},\"wind\":{\"speed\":1.5,\"deg\":244,\"gust\":1.44},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-11 00:00:00\"},{\"dt\":1704942000,\"main\":{\"temp\":-6.82,\"feels_like\":-10.65,\"temp_min\":-6.82,\"temp_max\":-6.82,\"pressure\":1029,\"sea_level\":1029,\"grnd_level\":1013,\"humidity\":79,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":5},\"wind\":{\"speed\":2.17,\"deg\":251,\"gust\":3.15},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-11 03:00:00\"},{\"dt\":1704952800,\"main\":{\"temp\":-5.95,\"feels_like\":-10.63,\"temp_min\":-5.95,\"temp_max\":-5.95,\"pressure\":1028,\"sea_level\":1028,\"grnd_level\":1012,\"humidity\":74,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01n\"}],\"clouds\":{\"all\":7},\"wind\":{\"speed\":2.98,\"deg\":270,\"gust\":7.31},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-11 06:00:00\"},{\"dt\":1704963600,\"main\":{\"temp\":-2.82,\"feels_like\":-8.21,\"temp_min\":-2.82,\"temp_max\":-2.82,\"pressure\":1026,\"sea_level\":1026,\"grnd_level\":1010,\"humidity\":73,\"temp_kf\":0},\"weather\":[{\"id\":803,\"main\":\"Clouds\",\"description\":\"zachmurzenie umiarkowane\",\"icon\":\"04d\"}],\"clouds\":{\"all\":71},\"wind\":{\"speed\":4.65,\"deg\":278,\"gust\":10.91},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-11 09:00:00\"},{\"dt\":1704974400,\"main\":{\"temp\":-0.01,\"feels_like\":-5.21,\"temp_min\":-0.01,\"temp_max\":-0.01,\"pressure\":1025,\"sea_level\":1025,\"grnd_level\":1009,\"humidity\":78,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04d\"}],\"clouds\":{\"all\":85},\"wind\":{\"speed\":5.51,\"deg\":290,\"gust\":11.31},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-11 12:00:00\"},{\"dt\":1704985200,\"main\":{\"temp\":-1.03,\"feels_like\":-6.41,\"temp_min\":-1.03,\"temp_max\":-1.03,\"pressure\":1024,\"sea_level\":1024,\"grnd_level\":1009,\"humidity\":87,\"temp_kf\":0},\"weather\":[{\"id\":803,\"main\":\"Clouds\",\"description\":\"zachmurzenie umiarkowane\",\"icon\":\"04d\"}],\"clouds\":{\"all\":76},\"wind\":{\"speed\":5.36,\"deg\":306,\"gust\":10.72},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-11 15:00:00\"},{\"dt\":1704996000,\"main\":{\"temp\":-0.82,\"feels_like\":-6.1,\"temp_min\":-0.82,\"temp_max\":-0.82,\"pressure\":1025,\"sea_level\":1025,\"grnd_level\":1009,\"humidity\":96,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":85},\"wind\":{\"speed\":5.27,\"deg\":309,\"gust\":10.83},\"visibility\":461,\"pop\":0,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-11 18:00:00\"},{\"dt\":1705006800,\"main\":{\"temp\":-0.4,\"feels_like\":-5.16,\"temp_min\":-0.4,\"temp_max\":-0.4,\"pressure\":1026,\"sea_level\":1026,\"grnd_level\":1011,\"humidity\":96,\"temp_kf\":0},\"weather\":[{\"id\":600,\"main\":\"Snow\",\"description\":\"słabe opady śniegu\",\"icon\":\"13n\"}],\"clouds\":{\"all\":99},\"wind\":{\"speed\":4.58,\"deg\":331,\"gust\":9.62},\"visibility\":1894,\"pop\":0.59,\"snow\":{\"3h\":0.34},\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-11 21:00:00\"},{\"dt\":1705017600,\"main\":{\"temp\":-0.58,\"feels_like\":-5.21,\"temp_min\":-0.58,\"temp_max\":-0.58,\"pressure\":1027,\"sea_level\":1027,\"grnd_level\":1012,\"humidity\":88,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":100},\"wind\":{\"speed\":4.31,\"deg\":340,\"gust\":9.01},\"visibility\":10000,\"pop\":0.43,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-12 00:00:00\"},{\"dt\":1705028400,\"main\":{\"temp\":-1.32,\"feels_like\":-6.01,\"temp_min\":-1.32,\"temp_max\":-1.32,\"pressure\":1029,\"sea_level\":1029,\"grnd_level\":1013,\"humidity\":87,\"temp_kf\":0},\"weather\":[{\"id\":804,\"main\":\"Clouds\",\"description\":\"zachmurzenie duże\",\"icon\":\"04n\"}],\"clouds\":{\"all\":100},\"wind\":{\"speed\":4.14,\"deg\":339,\"gust\":8.63},\"visibility\":10000,\"pop\":0.1,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-12 03:00:00\"},{\"dt\":1705039200,\"main\":{\"temp\":-3.83,\"feels_like\":-7.52,\"temp_min\":-3.83,\"temp_max\":-3.83,\"pressure\":1030,\"sea_level\":1030,\"grnd_level\":1014,\"humidity\":95,\"temp_kf\":0},\"weather\":[{\"id\":803,\"main\":\"Clouds\",\"description\":\"zachmurzenie umiarkowane\",\"icon\":\"04n\"}],\"clouds\":{\"all\":76},\"wind\":{\"speed\":2.47,\"deg\":347,\"gust\":5.07},\"visibility\":10000,\"pop\":0.1,\"sys\":{\"pod\":\"n\"},\"dt_txt\":\"2024-01-12 06:00:00\"},{\"dt\":1705050000,\"main\":{\"temp\":-2.26,\"feels_like\":-5.62,\"temp_min\":-2.26,\"temp_max\":-2.26,\"pressure\":1032,\"sea_level\":1032,\"grnd_level\":1016,\"humidity\":87,\"temp_kf\":0},\"weather\":[{\"id\":801,\"main\":\"Clouds\",\"description\":\"pochmurnie\",\"icon\":\"02d\"}],\"clouds\":{\"all\":11},\"wind\":{\"speed\":2.43,\"deg\":352,\"gust\":4.21},\"visibility\":10000,\"pop\":0.02,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-12 09:00:00\"},{\"dt\":1705060800,\"main\":{\"temp\":-0.94,\"feels_like\":-3.96,\"temp_min\":-0.94,\"temp_max\":-0.94,\"pressure\":1032,\"sea_level\":1032,\"grnd_level\":1016,\"humidity\":71,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":9},\"wind\":{\"speed\":2.34,\"deg\":325,\"gust\":3.48},\"visibility\":10000,\"pop\":0.01,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-12 12:00:00\"},{\"dt\":1705071600,\"main\":{\"temp\":-3.62,\"feels_like\":-5.68,\"temp_min\":-3.62,\"temp_max\":-3.62,\"pressure\":1032,\"sea_level\":1032,\"grnd_level\":1016,\"humidity\":86,\"temp_kf\":0},\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"bezchmurnie\",\"icon\":\"01d\"}],\"clouds\":{\"all\":7},\"wind\":{\"speed\":1.39,\"deg\":288,\"gust\":1.52},\"visibility\":10000,\"pop\":0,\"sys\":{\"pod\":\"d\"},\"dt_txt\":\"2024-01-12 15:00:00\"}],\"city\":{\"id\":7532481,\"name\":\"Oława\",\"coord\":{\"lat\":50.9571,\"lon\":17.2903},\"country\":\"PL\",\"population\":0,\"timezone\":3600,\"sunrise\":1704610351,\"sunset\":1704639641}}";
+            const char* data = FORECAST_API_DATA;
 
             extractor ex(data);
             
@@ -348,6 +439,2147 @@ namespace tests
         }
     };
 
+    class ScannerClassifyTest : public JsonTestCase
+    {
+    public:
+        ScannerClassifyTest() : JsonTestCase("ScannerClassifyTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            // longer than a single block, so both the vector and the padded tail paths are used
+            const char *data =
+                "{\n\t\"key\" : [1, 2,\r\n 3],\n\t\"escaped\": \"a\\\\b\",\n"
+                "\t\"nested\": {\"list\": [{}, [], \"x\"]}   ,\"last\":   true\n}";
+            size_t size = strlen(data);
+
+            structural_masks masks;
+            for (size_t pos = 0; pos < size; pos += SCANNER_BLOCK_SIZE)
+            {
+                size_t len = classify_at(data, pos, size, masks);
+                for (size_t i = 0; i < len; i++)
+                {
+                    char c = data[pos + i];
+                    uint64_t bit = uint64_t(1) << i;
+                    assertEqual(bool(masks.quote & bit), c == '"');
+                    assertEqual(bool(masks.backslash & bit), c == '\\');
+                    assertEqual(bool(masks.whitespace & bit), c == ' ' || c == '\n' || c == '\t' || c == '\r');
+                    assertEqual(bool(masks.structural & bit), strchr("{}[]:,", c) != nullptr && c != 0);
+                }
+            }
+
+            assertEqual(skip_whitespace(data, 1, size), size_t(3));
+            assertEqual(skip_whitespace(data, size, size), size);
+            bool escaped = true;
+            assertEqual(find_string_end(data, 4, size, escaped), size_t(7));
+            assertFalse(escaped);
+
+            extractor ex(data);
+            assertEqual(ex["key"][2].extract().asInt(), 3, " %i != %i \n");
+            assertEqual(ex["last"].extract().asBool(), true, " %i != %i \n");
+
+            // token boundaries found in the block masks, across the blocks
+            std::string tokens = "[" + std::string(60, ' ') + "123456, \"" + std::string(70, ',') + "\\\"]\", -1.5e3 ,true]";
+            Tokenizer tokenizer(tokens.data(), tokens.size());
+            assertTrue(tokenizer.getToken().type == TOKEN_TYPE::ARRAY_OPEN);
+            Token token = tokenizer.getToken();
+            assertTrue(token.type == TOKEN_TYPE::NUMBER);
+            assertEqual(token.length, size_t(6), " %lu != %lu \n");
+            assertTrue(tokenizer.getToken().type == TOKEN_TYPE::COMMA);
+            token = tokenizer.getToken();
+            assertTrue(token.type == TOKEN_TYPE::STRING);
+            assertEqual(token.length, size_t(73), " %lu != %lu \n");
+            assertTrue(token.escaped);
+            assertTrue(tokenizer.getToken().type == TOKEN_TYPE::COMMA);
+            tokenizer.skipValue();
+            assertTrue(tokenizer.getToken().type == TOKEN_TYPE::COMMA);
+            assertTrue(tokenizer.getToken().type == TOKEN_TYPE::BOOLEAN);
+            ex.set(tokens.c_str());
+            assertEqual(ex[2].extract().asFloat(), -1500.0f, " %f != %f \n");
+
+            // skipped values end at the first structural character outside of a string
+            ex.set("{\"a\": \"x,}\\\"]y\" , \"b\": -2e1, \"c\":{\"d\":[1]}, \"e\": 4}");
+            assertEqual(ex["e"].extract().asInt(), 4, " %i != %i \n");
+            assertEqual(ex["b"].extract().asInt(), -20, " %i != %i \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+    class TokenAllocationTest : public JsonTestCase
+    {
+    public:
+        TokenAllocationTest() : JsonTestCase("TokenAllocationTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            extractor ex(WEATHER_API_DATA);
+            // the memo table is allocated by the first filter
+            static_cast<void>(ex["timezone"].extract());
+
+            // scalar extraction: tokenizing, peeking and comparing keys shouldn't allocate
+            size_t before = allocationCount();
+            for (int i = 0; i < 10; i++)
+            {
+                assertLazyType(ex["coord"]["lon"].extract().raw(), LazyType::NUMBER);
+                assertLazyType(ex["main"]["humidity"].extract().raw(), LazyType::NUMBER);
+                assertLazyType(ex["sys"]["sunset"].extract().raw(), LazyType::NUMBER);
+                assertLazyType(ex["timezone"].extract().raw(), LazyType::NUMBER);
+                assertFalse(ex["weather"][0]["icon"].isNull());
+            }
+            size_t allocations = allocationCount() - before;
+            Serial.printf("\tAllocations: %u\n", unsigned(allocations));
+            assertEqual(allocations, size_t(0));
+
+            extractor bools("{\"list\": [null, true, {\"a\": false}], \"b\": true}");
+            bools.memoize(0);
+            before = allocationCount();
+            assertEqual(bools["list"][2]["a"].extract().asBool(), false, " %i != %i \n");
+            assertEqual(bools["b"].extract().asBool(), true, " %i != %i \n");
+            assertTrue(bools["list"][0].extract().isNull());
+            assertEqual(allocationCount() - before, size_t(0));
+            setMemoryWatchpoint();
+        }
+    };
+
+    class SkipContainerTest : public JsonTestCase
+    {
+    public:
+        SkipContainerTest() : JsonTestCase("SkipContainerTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            // brackets inside strings, nesting and strings spanning over the 64 byte blocks
+            std::string nested = "{\"skip\": [";
+            for (int i = 0; i < 40; i++)
+            {
+                nested += "{\"a\": [1, \"]}]}\", {\"b\": \"{[\"}], \"long string that spans over the block ][}{\": []},";
+            }
+            nested += "null], \"value\": 42, \"list\": [[[]], {\"x\": \"]\"}, 7]}";
+
+            const char *data = nested.c_str();
+            size_t size = nested.size();
+            size_t list = nested.find("[", 1) + 1;
+            assertEqual(skip_container(data, list, size), nested.find(", \"value\""));
+            assertEqual(skip_container(data, 1, size), size);
+            assertEqual(skip_container(data, 1, size - 1), size - 1);
+
+            extractor ex(data);
+            assertEqual(ex["value"].extract().asInt(), 42, " %i != %i \n");
+            assertEqual(ex["list"][2].extract().asInt(), 7, " %i != %i \n");
+            assertEqual(ex["skip"][40].extract().isNull(), true, " %i != %i \n");
+            assertTrue(ex["skip"][41].isNull());
+            setMemoryWatchpoint();
+        }
+    };
+
+    class EscapedStringTest : public JsonTestCase
+    {
+    public:
+        EscapedStringTest() : JsonTestCase("EscapedStringTest") {}
+
+        // reference: a quote is escaped if it's preceded by an odd number of backslashes
+        size_t referenceStringEnd(const std::string &data, size_t pos)
+        {
+            size_t backslashes = 0;
+            for (; pos < data.size(); pos++)
+            {
+                if (data[pos] == '"' && backslashes % 2 == 0)
+                {
+                    return pos;
+                }
+                backslashes = data[pos] == '\\' ? backslashes + 1 : 0;
+            }
+            return data.size();
+        }
+
+        void test()
+        {
+            setMemoryWatchpoint();
+
+            // backslash runs of every length, crossing the 64 byte block boundaries
+            const char alphabet[] = {'a', '\\', '"', '\\', '\\'};
+            uint32_t seed = 12345;
+            for (int round = 0; round < 200; round++)
+            {
+                std::string data;
+                for (int i = 0; i < 200; i++)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    data += alphabet[(seed >> 16) % sizeof(alphabet)];
+                }
+                bool escaped;
+                for (size_t pos = 0; pos < 70; pos += 7)
+                {
+                    assertEqual(find_string_end(data.c_str(), pos, data.size(), escaped), referenceStringEnd(data, pos));
+                }
+            }
+
+            extractor ex(
+                "{\"say \\\"hi\\\"\": \"she said \\\"hi\\\" \\\\\", \"path\": \"C:\\\\dir\\\\\","
+                "\"unicode\": \"\\u017c\\u00f3\\u0142w \\ud83d\\ude00\\n\", \"plain\": \"no escapes\", \"after\": 1}");
+
+            assertEqual(ex["say \"hi\""].extract().as<std::string>(), std::string("she said \"hi\" \\"));
+            assertEqual(ex["path"].extract().as<std::string>(), std::string("C:\\dir\\"));
+            assertEqual(ex["unicode"].extract().as<std::string>(), std::string("\xC5\xBC\xC3\xB3\xC5\x82w \xF0\x9F\x98\x80\n"));
+            assertEqual(ex["after"].extract().asInt(), 1, " %i != %i \n");
+
+            // zero-copy access to strings without escape sequences
+            auto plain = ex["plain"].extract();
+            assertFalse(plain.raw().flags & LAZY_VALUE_ESCAPED);
+            assertEqual(std::string(plain.raw().values.string, plain.raw().length), std::string("no escapes"));
+            assertTrue(ex["path"].extract().raw().flags & LAZY_VALUE_ESCAPED);
+            setMemoryWatchpoint();
+        }
+    };
+
+    class NonNullTerminatedInputTest : public JsonTestCase
+    {
+    public:
+        NonNullTerminatedInputTest() : JsonTestCase("NonNullTerminatedInputTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            // only the first `length` bytes belong to the json, the rest is garbage
+            const char buffer[] = {'{', '"', 'a', '"', ':', '[', '1', ',', '2', '3', ']', '}', '9', '9', '"', '{'};
+            extractor ex(buffer, 12);
+            assertEqual(ex["a"][1].extract().asInt(), 23, " %i != %i \n");
+            assertTrue(ex["a"][2].isNull());
+
+            ex.set(buffer + 6, 3); // "1,2"
+            assertEqual(ex.extract().asInt(), 1, " %i != %i \n");
+            ex.set(buffer + 8, 1); // "2" followed by "3"
+            assertEqual(ex.extract().asInt(), 2, " %i != %i \n");
+            ex.reset();
+            assertEqual(ex.extract().asInt(), 2, " %i != %i \n");
+
+            stream ss(buffer + 1, 3);
+            char c;
+            ss.get(c);
+            ss.get(c);
+            ss.get(c);
+            assertEqual(c, '"');
+            assertEqual(int(ss.peek()), BAD_BIT, " %i != %i \n");
+            ss.get(c);
+            assertTrue(ss.eof());
+
+#if __cplusplus >= 201703L
+            std::string_view view(WEATHER_API_DATA, 24); // {"coord":{"lon":17.2903
+            extractor viewed(view);
+            assertEqual(viewed["coord"]["lon"].extract().asFloat(), 17.2903f, " %f != %f \n");
+#endif
+            setMemoryWatchpoint();
+        }
+    };
+
+    class StreamingReaderTest : public JsonTestCase
+    {
+    public:
+        StreamingReaderTest() : JsonTestCase("StreamingReaderTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            const char *data = FORECAST_API_DATA;
+            size_t size = strlen(data), read = 0;
+            // hands out the json in small, odd-sized chunks
+            stream_reader reader = [&](char *buffer, size_t n) -> size_t
+            {
+                n = std::min(n, std::min<size_t>(37, size - read));
+                memcpy(buffer, data + read, n);
+                read += n;
+                return n;
+            };
+
+            extractor in_memory(data);
+            float temp = in_memory["list"][3]["main"]["temp"].extract().asFloat();
+            String city = in_memory["city"]["name"].extract().asString();
+            in_memory.reset();
+            int humidity = in_memory["list"][5]["main"]["humidity"].extract().asInt();
+            in_memory.reset();
+            String description = in_memory["list"][5]["weather"][0]["description"].extract().asString();
+
+            // the reading stops right after the value
+            extractor ex(reader, 256);
+            assertEqual(ex["list"][3]["main"]["temp"].extract().asFloat(), temp, " %f != %f \n");
+            assertTrue(read < size / 2);
+            // the root was already dropped
+            assertThrow<std::runtime_error>([&]()
+                                            { ex["city"]; });
+            assertThrow<std::runtime_error>([&]()
+                                            { ex.reset(); });
+
+            // the last key, almost the whole document goes through a 64 byte buffer
+            read = 0;
+            ex.set(reader, 64);
+            assertEqual(ex["city"]["name"].extract().asString(), city);
+            assertTrue(read > size / 2 && read < size);
+
+            // cached value can be read multiple times
+            read = 0;
+            ex.set(reader, 1024);
+            ex["list"][5].cache();
+            assertEqual(ex["main"]["humidity"].extract().asInt(), humidity, " %i != %i \n");
+            assertEqual(ex["weather"][0]["description"].extract().asString(), description);
+
+            // the value doesn't fit in the buffer
+            read = 0;
+            ex.set(reader, 128);
+            assertThrow<std::runtime_error>([&]()
+                                            { ex["list"][0].cache(); });
+
+            // small documents are kept as a whole, so the extractor can go back to the root
+            const char *small = "{\"a\": [1, 2, {\"b\": \"c\"}], \"d\": true}";
+            data = small;
+            size = strlen(small);
+            read = 0;
+            ex.set(reader, 64);
+            assertEqual(ex["a"][2]["b"].extract().asString(), String("c"));
+            assertTrue(ex["d"].extract().asBool());
+
+            // skipped strings and keys don't have to fit in the buffer, only the extracted value
+            std::string pad(2000, 'x');
+            std::string large = "{\"s\": \"short\", \"pad\": \"" + pad + "\", \"" + pad + "\": 1, " +
+                                "\"l\": [\"" + pad + "\", 7], \"n\": 5}";
+            data = large.c_str();
+            size = large.size();
+            for (size_t buffer : {64, 1024})
+            {
+                read = 0;
+                ex.set(reader, buffer);
+                assertEqual(ex["n"].extract().asInt(), 5, " %i != %i \n");
+                read = 0;
+                ex.set(reader, buffer);
+                assertEqual(ex["l"][1].extract().asInt(), 7, " %i != %i \n");
+                read = 0;
+                ex.set(reader, buffer);
+                std::vector<wrapper> values = ex.extract(path_set({path("l[1]"), path("n")}));
+                assertEqual(values[0].asInt(), 7, " %i != %i \n");
+                assertEqual(values[1].asInt(), 5, " %i != %i \n");
+            }
+            // the value itself still has to fit
+            read = 0;
+            ex.set(reader, 64);
+            assertThrow<std::runtime_error>([&]()
+                                            { ex["pad"].extract(); });
+
+            // extracted strings outlive the data dropped by the next filters, even with the nodes on the heap
+            std::string members = "{\"s\": \"hello world string\", ";
+            for (int i = 0; i < 100; i++)
+            {
+                members += "\"p" + std::to_string(i) + "\": " + std::to_string(i) + ", ";
+            }
+            members += "\"e\": \"tab\\there\", \"n\": 5}";
+            data = members.c_str();
+            size = members.size();
+            for (int heap = 0; heap < 2; heap++)
+            {
+                if (heap)
+                {
+                    ex.useArena(nullptr);
+                }
+                read = 0;
+                ex.set(reader, 128);
+                wrapper text = ex["s"].extract();
+                assertEqual(ex["n"].extract().asInt(), 5, " %i != %i \n");
+                assertTrue(read == size);
+                assertEqual(text.asString(), String("hello world string"));
+                read = 0;
+                ex.set(reader, 128);
+                std::vector<wrapper> values = ex.extract(path_set({path("s"), path("e")}));
+                assertEqual(values[0].asString(), String("hello world string"));
+                assertEqual(values[1].asString(), String("tab\there"));
+            }
+            setMemoryWatchpoint();
+        }
+    };
+
+    class NumberParsingTest : public JsonTestCase
+    {
+    public:
+        NumberParsingTest() : JsonTestCase("NumberParsingTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            extractor ex("{\"dt\": 1704650400123, \"max\": 9223372036854775807, \"min\": -9223372036854775808, "
+                         "\"odd\": 9007199254740993, \"exp\": [1e3, -2.5E-3, 1E+2, 0.1e1], \"pi\": 3.141592653589793, "
+                         "\"big\": 123456789012345678901234567890, \"tiny\": 4.9406564584124654e-324, "
+                         "\"zero\": -0.0, \"frac\": -7.75, \"text\": \"12\"}");
+
+            // integral literals are exact
+            assertTrue(ex["dt"].extract().as<int64_t>() == 1704650400123LL);
+            assertTrue(ex["max"].extract().as<int64_t>() == INT64_MAX);
+            assertTrue(ex["min"].extract().as<int64_t>() == INT64_MIN);
+            assertTrue(ex["odd"].extract().as<long long>() == 9007199254740993LL);
+            assertTrue(ex["dt"].extract().raw().flags & LAZY_VALUE_INTEGRAL);
+
+            // exponents
+            assertEqual(ex["exp"][0].extract().as<double>(), 1000.0, " %f != %f \n");
+            assertEqual(ex["exp"][1].extract().as<double>(), -0.0025, " %f != %f \n");
+            assertEqual(ex["exp"][2].extract().asInt(), 100, " %i != %i \n");
+            assertEqual(ex["exp"][3].extract().as<double>(), 1.0, " %f != %f \n");
+            assertFalse(ex["exp"][0].extract().raw().flags & LAZY_VALUE_INTEGRAL);
+
+            // full double precision, both the fast path and the fallback
+            assertEqual(ex["pi"].extract().as<double>(), 3.141592653589793, " %f != %f \n");
+            assertEqual(ex["big"].extract().as<double>(), 1.2345678901234568e29, " %f != %f \n");
+            assertTrue(ex["tiny"].extract().as<double>() == 4.9406564584124654e-324);
+            assertTrue(ex["zero"].extract().as<double>() == 0.0);
+            assertEqual(ex["frac"].extract().asFloat(), -7.75f, " %f != %f \n");
+            assertEqual(ex["frac"].extract().asInt(), -7, " %i != %i \n");
+
+            // forecast timestamps and temperatures
+            extractor forecast(FORECAST_API_DATA);
+            assertTrue(forecast["list"][0]["dt"].extract().as<int64_t>() == 1704650400LL);
+            assertEqual(forecast["list"][0]["main"]["temp"].extract().as<double>(), -6.7, " %f != %f \n");
+
+            // strings are not converted
+            assertThrow<invalid_type>([&]()
+                                      { ex["text"].extract().as<int>(); });
+
+            lazy_number number;
+            const char *invalid[] = {"-", "1.", ".5", "1e", "1e+", "1.2.3", "--1", "0x10", "1 ", "01", "-01", "00.5"};
+            for (const char *literal : invalid)
+            {
+                assertFalse(parse_number(literal, strlen(literal), number));
+            }
+            assertTrue(parse_number("-0.5", 4, number) && number.real == -0.5);
+
+            // out of range, like strtod
+            extractor range("[1e400, -1e400, 1e-400, 123456789012345678901234567890e300]");
+            assertTrue(std::isinf(range[0].extract().as<double>()) && range[0].extract().as<double>() > 0);
+            assertTrue(std::isinf(range[1].extract().as<double>()) && range[1].extract().as<double>() < 0);
+            assertTrue(range[2].extract().as<double>() == 0.0);
+            assertTrue(std::isinf(range[3].extract().as<double>()));
+            extractor broken("{\"a\": 1.2.3}");
+            assertThrow<std::runtime_error>([&]()
+                                            { broken["a"].extract(); });
+
+            // decoding doesn't allocate
+            size_t before = allocationCount();
+            double sum = 0;
+            for (int i = 0; i < 10; i++)
+            {
+                sum += ex["pi"].extract().as<double>() + ex["exp"][1].extract().as<double>();
+            }
+            assertTrue(sum > 0);
+            assertEqual(allocationCount() - before, size_t(0));
+            setMemoryWatchpoint();
+        }
+    };
+
+    class PathQueryTest : public JsonTestCase
+    {
+    public:
+        PathQueryTest() : JsonTestCase("PathQueryTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            const path temp("list[3].main.temp");
+            assertEqual(temp.size(), size_t(4), " %lu != %lu \n");
+            assertTrue(temp[1].index == 3 && !temp[1].is_key);
+            assertTrue(temp[3].key == "temp" && temp[3].hash == path_hash("temp", 4));
+            assertTrue(temp.hash() == path::dotted("list[3].main.temp").hash());
+            assertTrue(path("a.b").hash() == path("/a/b").hash());
+            assertTrue(path("a.b").hash() != path("a.c").hash());
+
+            // same results as the chained filters
+            extractor chained(FORECAST_API_DATA), compiled(FORECAST_API_DATA);
+            for (int i = 0; i < 40; i++)
+            {
+                float expected = chained["list"][i]["main"]["temp"].extract().asFloat();
+                const path dotted("list[" + std::to_string(i) + "].main.temp");
+                const path pointer("/list/" + std::to_string(i) + "/main/temp");
+                assertEqual(compiled[dotted].extract().asFloat(), expected, " %f != %f \n");
+                assertEqual(compiled[pointer].extract().asFloat(), expected, " %f != %f \n");
+            }
+            assertEqual(compiled[path("city.name")].extract().asString(), chained["city"]["name"].extract().asString());
+            assertTrue(compiled[path("city.missing.deeper[2]")].isNull());
+            assertTrue(compiled[path("")].extract().type() == LazyType::OBJECT);
+
+            // the path is reusable across documents
+            const path humidity("main.humidity");
+            extractor weather(WEATHER_API_DATA);
+            assertEqual(weather[humidity].extract().asInt(), 77, " %i != %i \n");
+            assertTrue(compiled[humidity].isNull());
+
+            // keys of the same length are told apart by the hash, then the bytes
+            extractor same("{\"ba\": 1, \"bb\": 2, \"ab\": 3}");
+            same.memoize(0);
+            assertEqual(same[path("ab")].extract().asInt(), 3, " %i != %i \n");
+            assertEqual(same["bb"].extract().asInt(), 2, " %i != %i \n");
+
+            // JSON Pointer escapes, numeric keys and quoted dotted keys
+            extractor ex("{\"a/b\": {\"m~n\": 1, \"3\": [10, 20], \"x.y\": true}, \"list\": [\"zero\", {\"0\": 5}]}");
+            assertEqual(ex[path("/a~1b/m~0n")].extract().asInt(), 1, " %i != %i \n");
+            assertEqual(ex[path("/a~1b/3/1")].extract().asInt(), 20, " %i != %i \n");
+            assertEqual(ex[path("/list/1/0")].extract().asInt(), 5, " %i != %i \n");
+            assertEqual(ex[path("[\"a/b\"]['m~n']")].extract().asInt(), 1, " %i != %i \n");
+            assertEqual(ex[path("[\"a/b\"][\"x.y\"]")].extract().asBool(), true, " %i != %i \n");
+            assertEqual(ex[path("list[0]")].extract().asString(), String("zero"));
+
+            // type mismatch behaves like the chained filters
+            assertThrow<invalid_type>([&]()
+                                      { ex[path("list.a")]; });
+            assertEqual(ex[path("list[1].0")].extract().asInt(), 5, " %i != %i \n");
+
+            const char *invalid[] = {"a..b", "a.", ".a", "a[", "a[x]", "a[01]", "a[1]b", "a[\"b]", "/a~2"};
+            for (const char *source : invalid)
+            {
+                assertThrow<invalid_path>([&]()
+                                          { path p(source); });
+            }
+
+            // running a compiled path doesn't allocate
+            size_t before = allocationCount();
+            for (int i = 0; i < 10; i++)
+            {
+                assertFalse(compiled[temp].isNull());
+            }
+            assertEqual(allocationCount() - before, size_t(0));
+            setMemoryWatchpoint();
+        }
+    };
+
+    class MultiPathTest : public JsonTestCase
+    {
+    public:
+        MultiPathTest() : JsonTestCase("MultiPathTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            std::vector<path> paths = {
+                path("city.name"), path("list[0].main.temp"), path("list[39].main.temp"),
+                path("list[0].main.humidity"), path("/list/5/weather/0/description"), path("cnt"),
+                path("list[0].main.temp"), path("list[0].missing"), path("city.name.deeper"),
+                path("list.key"), path("list[40]"), path("list[2].main")};
+            const path_set set(paths);
+            assertEqual(set.size(), paths.size(), " %lu != %lu \n");
+
+            extractor ex(FORECAST_API_DATA);
+            std::vector<wrapper> values = ex.extract(set);
+            assertEqual(values.size(), paths.size(), " %lu != %lu \n");
+
+            extractor chained(FORECAST_API_DATA);
+            assertEqual(values[0].asString(), chained[paths[0]].extract().asString());
+            assertEqual(values[1].asFloat(), chained[paths[1]].extract().asFloat(), " %f != %f \n");
+            assertEqual(values[2].asFloat(), chained[paths[2]].extract().asFloat(), " %f != %f \n");
+            assertEqual(values[3].asInt(), chained[paths[3]].extract().asInt(), " %i != %i \n");
+            assertEqual(values[4].asString(), chained[paths[4]].extract().asString());
+            assertEqual(values[5].asInt(), 40, " %i != %i \n");
+            // duplicates get their own copy
+            assertEqual(values[6].asFloat(), values[1].asFloat(), " %f != %f \n");
+            // not found or not matching the value types
+            for (int i = 7; i < 11; i++)
+            {
+                assertTrue(values[i].isNull());
+            }
+            // containers are lazy, like `extract()`
+            assertTrue(values[11].type() == LazyType::OBJECT);
+            assertEqual(wrapper(values[11].object()["temp"]).asFloat(), chained[path("list[2].main.temp")].extract().asFloat(), " %f != %f \n");
+
+            // duplicate keys, the first one wins like with `filter()`
+            extractor duplicates("{\"a\": 1, \"a\": 2, \"b\": 3}");
+            values = duplicates.extract(path_set({path("a"), path("b")}));
+            assertEqual(values[0].asInt(), 1, " %i != %i \n");
+            assertEqual(values[1].asInt(), 3, " %i != %i \n");
+            assertEqual(duplicates["a"].extract().asInt(), 1, " %i != %i \n");
+
+            // a JSON Pointer segment and the same index or key written with dots are separate
+            // children, every one of them is resolved
+            extractor indices("{\"a\": [5, 6]}");
+            values = indices.extract(path_set({path("/a/0"), path("a[0]"), path("/a/1")}));
+            assertEqual(values[0].asInt(), 5, " %i != %i \n");
+            assertEqual(values[1].asInt(), 5, " %i != %i \n");
+            assertEqual(values[2].asInt(), 6, " %i != %i \n");
+            extractor keys("{\"a\": {\"0\": 5}}");
+            values = keys.extract(path_set({path("/a/0"), path("a.0")}));
+            assertEqual(values[0].asInt(), 5, " %i != %i \n");
+            assertEqual(values[1].asInt(), 5, " %i != %i \n");
+            // streamed, the element is kept in the buffer until both children are resolved
+            std::string padding(400, 'x');
+            std::string nested = "{\"p\": \"" + padding + "\", \"a\": [{\"b\": 1, \"c\": \"" + padding.substr(0, 30) +
+                                 "\"}, 3], \"q\": \"" + padding + "\", \"d\": 4}";
+            size_t length = nested.size(), offset = 0;
+            extractor streamedNested([&](char *buffer, size_t n) -> size_t
+                                     {
+                n = std::min(n, length - offset);
+                memcpy(buffer, nested.data() + offset, n);
+                offset += n;
+                return n; }, 128);
+            values = streamedNested.extract(path_set({path("/a/0/c"), path("a[0].b"), path("d")}));
+            assertEqual(values[0].as<std::string>(), padding.substr(0, 30));
+            assertEqual(values[1].asInt(), 1, " %i != %i \n");
+            assertEqual(values[2].asInt(), 4, " %i != %i \n");
+
+            // relative to the filtered value, the extractor goes back to the root afterwards
+            values = ex["list"][3].extract(path_set({path("main.temp"), path("dt"), path("")}));
+            assertEqual(values[0].asFloat(), chained[path("list[3].main.temp")].extract().asFloat(), " %f != %f \n");
+            assertTrue(values[1].as<int64_t>() == chained[path("list[3].dt")].extract().as<int64_t>());
+            assertTrue(values[2].type() == LazyType::OBJECT);
+            assertEqual(ex["cnt"].extract().asInt(), 40, " %i != %i \n");
+
+            // the pass stops once every path is resolved
+            size_t size = strlen(FORECAST_API_DATA), read = 0;
+            extractor streamed([&](char *buffer, size_t n) -> size_t
+                               {
+                n = std::min(n, size - read);
+                memcpy(buffer, FORECAST_API_DATA + read, n);
+                read += n;
+                return n; }, 256);
+            values = streamed.extract(path_set({path("list[0].dt"), path("list[1].main.temp")}));
+            assertTrue(values[0].as<int64_t>() == 1704650400LL);
+            assertEqual(values[1].asFloat(), chained[path("list[1].main.temp")].extract().asFloat(), " %f != %f \n");
+            assertTrue(read < size / 4);
+            setMemoryWatchpoint();
+        }
+    };
+
+    class CacheScopeTest : public JsonTestCase
+    {
+    public:
+        CacheScopeTest() : JsonTestCase("CacheScopeTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            extractor chained(FORECAST_API_DATA);
+            extractor ex(FORECAST_API_DATA);
+
+            ex["list"].cache();
+            assertEqual(ex.depth(), size_t(1), " %lu != %lu \n");
+            ex[5].cache();
+            assertEqual(ex.depth(), size_t(2), " %lu != %lu \n");
+            assertEqual(ex["main"]["temp"].extract().asFloat(), chained[path("list[5].main.temp")].extract().asFloat(), " %f != %f \n");
+            assertTrue(ex["dt"].extract().as<int64_t>() == chained[path("list[5].dt")].extract().as<int64_t>());
+            assertTrue(ex["cnt"].isNull());
+
+            // the cached window is the value itself
+            std::string window = ex.json();
+            assertTrue(window.front() == '{' && window.back() == '}');
+            assertEqual(window.find("\"dt\""), size_t(1), " %lu != %lu \n");
+
+            // sibling subtrees, without going back to the root
+            ex.pop();
+            size_t before = allocationCount();
+            for (int i = 6; i < 40; i++)
+            {
+                ex[i].cache();
+                assertEqual(ex["main"]["humidity"].extract().asInt(),
+                            chained["list"][i]["main"]["humidity"].extract().asInt(), " %i != %i \n");
+                ex.pop();
+            }
+            // caching only pushes two integers (the stack already has room for them)
+            assertEqual(allocationCount() - before, size_t(0));
+
+            assertEqual(ex[39]["main"]["humidity"].extract().asInt(),
+                        chained["list"][39]["main"]["humidity"].extract().asInt(), " %i != %i \n");
+            ex.pop();
+            assertEqual(ex.depth(), size_t(0), " %lu != %lu \n");
+            assertTrue(ex.json().empty());
+            assertEqual(ex["cnt"].extract().asInt(), 40, " %i != %i \n");
+            ex.pop();
+            assertEqual(ex["cnt"].extract().asInt(), 40, " %i != %i \n");
+
+            // reset drops every scope
+            ex["city"].cache();
+            ex["coord"].cache();
+            ex.reset();
+            assertEqual(ex.depth(), size_t(0), " %lu != %lu \n");
+            assertEqual(ex["cnt"].extract().asInt(), 40, " %i != %i \n");
+
+            // the scopes are kept in the extractor, caching doesn't allocate
+            before = allocationCount();
+            for (int i = 0; i < LAZY_JSON_MAX_SCOPES; i++)
+            {
+                ex["list"].cache();
+                ex.pop();
+                ex["list"].cache();
+                ex[0].cache();
+                ex.reset();
+            }
+            assertEqual(allocationCount() - before, size_t(0));
+            extractor nested("[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]");
+            for (int i = 0; i < LAZY_JSON_MAX_SCOPES; i++)
+            {
+                nested[0].cache();
+            }
+            assertThrow<std::runtime_error>([&]()
+                                            { nested[0].cache(); });
+            setMemoryWatchpoint();
+        }
+    };
+
+    class MemoTest : public JsonTestCase
+    {
+    public:
+        MemoTest() : JsonTestCase("MemoTest") {}
+
+        void test()
+        {
+            extractor plain(FORECAST_API_DATA);
+            plain.memoize(0);
+            assertFalse(plain.memoStats().capacity != 0);
+
+            // shared prefix: the second lookup of "main" is a hit
+            extractor ex(WEATHER_API_DATA);
+            assertEqual(ex["main"]["temp"].extract().asFloat(), -6.26f, " %f != %f \n");
+            assertEqual(ex.memoStats().hits, size_t(0), " %lu != %lu \n");
+            assertEqual(ex.memoStats().misses, size_t(2), " %lu != %lu \n");
+            assertEqual(ex["main"]["humidity"].extract().asInt(), 77, " %i != %i \n");
+            assertEqual(ex.memoStats().hits, size_t(1), " %lu != %lu \n");
+            assertEqual(ex["main"]["temp"].extract().asFloat(), -6.26f, " %f != %f \n");
+            assertEqual(ex.memoStats().hits, size_t(3), " %lu != %lu \n");
+            // reset keeps the memo, it's the same document
+            ex.reset();
+            assertEqual(ex[path("weather[0].main")].extract().asString(), String("Clouds"));
+            assertEqual(ex["weather"][0]["main"].extract().asString(), String("Clouds"));
+            assertEqual(ex.memoStats().hits, size_t(3 + 3), " %lu != %lu \n");
+            // missing keys are never memoized
+            assertTrue(ex["main"]["nope"].isNull());
+            assertTrue(ex["main"]["nope"].isNull());
+
+            // list elements, walked backwards and forwards (resuming from the furthest element)
+            extractor forecast(FORECAST_API_DATA);
+            for (int i = 39; i >= 0; i -= 3)
+            {
+                assertEqual(forecast["list"][i]["dt"].extract().as<int64_t>(),
+                            plain["list"][i]["dt"].extract().as<int64_t>(), " %lld != %lld \n");
+            }
+            extractor walk(FORECAST_API_DATA);
+            for (int i = 0; i < 40; i += 7)
+            {
+                assertEqual(walk["list"][i]["main"]["temp"].extract().asFloat(),
+                            plain["list"][i]["main"]["temp"].extract().asFloat(), " %f != %f \n");
+            }
+            assertTrue(walk["list"][40].isNull());
+            assertTrue(walk["list"][41].isNull());
+            assertEqual(walk["list"][39]["dt"].extract().as<int64_t>(),
+                        plain["list"][39]["dt"].extract().as<int64_t>(), " %lld != %lld \n");
+
+            // the capacity caps the number of entries, evicted offsets are found again by scanning
+            extractor small(FORECAST_API_DATA);
+            small.memoize(3);
+            assertEqual(small.memoStats().capacity, size_t(4), " %lu != %lu \n");
+            for (int n = 0; n < 2; n++)
+            {
+                for (int i = 0; i < 40; i++)
+                {
+                    assertEqual(small["list"][i]["main"]["humidity"].extract().asInt(),
+                                plain["list"][i]["main"]["humidity"].extract().asInt(), " %i != %i \n");
+                }
+            }
+            assertTrue(small.memoStats().entries <= 4);
+            assertEqual(small["city"]["name"].extract().asString(), String("Oława"));
+
+            // lookups don't allocate, the table is allocated up front
+            size_t before = allocationCount();
+            for (int i = 0; i < 40; i++)
+            {
+                static_cast<void>(forecast["list"][i]["main"]["temp"].isNull());
+            }
+            assertEqual(allocationCount() - before, size_t(0));
+            assertEqual(plain.memoStats().hits + plain.memoStats().misses, size_t(0), " %lu != %lu \n");
+
+            // a new document drops the memo
+            const char *other = "{\"main\": {\"temp\": 1}}";
+            ex.set(other);
+            assertEqual(ex.memoStats().entries, size_t(0), " %lu != %lu \n");
+            assertEqual(ex["main"]["temp"].extract().asInt(), 1, " %i != %i \n");
+
+            // streamed json is never memoized
+            std::string data(WEATHER_API_DATA);
+            size_t offset = 0;
+            extractor streamed([&](char *buffer, size_t size) {
+                size_t n = std::min(size, data.size() - offset);
+                memcpy(buffer, data.data() + offset, n);
+                offset += n;
+                return n;
+            }, 128);
+            assertEqual(streamed["main"]["humidity"].extract().asInt(), 77, " %i != %i \n");
+            assertEqual(streamed.memoStats().hits + streamed.memoStats().misses, size_t(0), " %lu != %lu \n");
+        }
+    };
+
+    class IterationTest : public JsonTestCase
+    {
+    public:
+        IterationTest() : JsonTestCase("IterationTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            extractor indexed(FORECAST_API_DATA);
+            extractor ex(FORECAST_API_DATA);
+
+            // every element, in order, the same as indexing
+            int count = 0;
+            for (auto day : ex["list"].elements())
+            {
+                assertEqual(day["main"]["temp"].extract().asFloat(),
+                            indexed["list"][count]["main"]["temp"].extract().asFloat(), " %f != %f \n");
+                // extract() goes back to the element, not the root
+                assertTrue(day["dt"].extract().as<int64_t>() == indexed["list"][count]["dt"].extract().as<int64_t>());
+                assertEqual(day["weather"][0]["id"].extract().asInt(),
+                            indexed["list"][count]["weather"][0]["id"].extract().asInt(), " %i != %i \n");
+                assertEqual(ex.depth(), size_t(1), " %lu != %lu \n");
+                count++;
+            }
+            assertEqual(count, 40, " %i != %i \n");
+            // back at the root once the loop ends
+            assertEqual(ex.depth(), size_t(0), " %lu != %lu \n");
+            assertEqual(ex["cnt"].extract().asInt(), 40, " %i != %i \n");
+
+            // members with their keys, nested in the elements
+            const char *keys[] = {"temp", "feels_like", "temp_min", "temp_max", "pressure",
+                                  "sea_level", "grnd_level", "humidity", "temp_kf"};
+            count = 0;
+            for (auto day : ex["list"].elements())
+            {
+                size_t i = 0;
+                for (auto item : day["main"].items())
+                {
+                    assertEqual(item.key, std::string(keys[i]));
+                    assertEqual(item.value.extract().asFloat(),
+                                indexed["list"][count]["main"][keys[i]].extract().asFloat(), " %f != %f \n");
+                    i++;
+                }
+                assertEqual(i, size_t(9), " %lu != %lu \n");
+                // the inner loop went back to the element
+                assertEqual(ex.depth(), size_t(1), " %lu != %lu \n");
+                count++;
+            }
+            assertEqual(count, 40, " %i != %i \n");
+
+#if __cplusplus >= 201703L
+            std::string joined;
+            for (auto [key, value] : ex["city"]["coord"].items())
+            {
+                joined += key + "=" + value.json() + ";";
+            }
+            assertEqual(joined, std::string("lat=50.9571;lon=17.2903;"));
+#endif
+
+            // the range keeps its position, lists of scalars, escaped keys
+            extractor small("{\"a\\\"b\": [1, \"two\", [3], {\"four\": 4}, null], \"empty\": [], \"obj\": {}}");
+            auto range = small["a\"b"].elements();
+            std::vector<std::string> values;
+            for (auto value : range)
+            {
+                values.push_back(value.json());
+                assertEqual(range.index(), values.size() - 1, " %lu != %lu \n");
+            }
+            assertEqual(values.size(), size_t(5), " %lu != %lu \n");
+            assertEqual(values[1], std::string("\"two\""));
+            assertEqual(values[3], std::string("{\"four\": 4}"));
+            for (auto item : small.items())
+            {
+                assertEqual(item.key, std::string("a\"b"));
+                break;
+            }
+            // left early, the scope of the element is dropped
+            assertEqual(small.depth(), size_t(0), " %lu != %lu \n");
+
+            // empty and missing containers
+            count = 0;
+            for (auto value : small["empty"].elements())
+            {
+                static_cast<void>(value);
+                count++;
+            }
+            for (auto item : small["obj"].items())
+            {
+                static_cast<void>(item);
+                count++;
+            }
+            for (auto value : small["missing"].elements())
+            {
+                static_cast<void>(value);
+                count++;
+            }
+            assertEqual(count, 0, " %i != %i \n");
+            assertThrow<invalid_type>([&]()
+                                      { small["obj"].elements(); });
+            assertThrow<invalid_type>([&]()
+                                      { small["a\"b"].items(); });
+            assertEqual(small["a\"b"][1].extract().asString(), String("two"));
+
+            // inside a cached scope, the iteration goes back to it
+            ex["list"].cache();
+            count = 0;
+            for (auto day : ex.elements())
+            {
+                static_cast<void>(day);
+                count++;
+            }
+            assertEqual(count, 40, " %i != %i \n");
+            assertEqual(ex.depth(), size_t(1), " %lu != %lu \n");
+            assertEqual(ex[39]["dt"].extract().as<int64_t>(), indexed["list"][39]["dt"].extract().as<int64_t>(), " %lld != %lld \n");
+            ex.pop();
+
+            // moving on to the next element doesn't allocate
+            size_t before = 0;
+            count = 0;
+            for (auto day : ex["list"].elements())
+            {
+                if (count++ == 0)
+                {
+                    before = allocationCount();
+                }
+                static_cast<void>(day["main"]["humidity"].isNull());
+            }
+            assertEqual(allocationCount() - before, size_t(0));
+
+            // streamed, the element has to fit in the buffer
+            const char *data = FORECAST_API_DATA;
+            size_t size = strlen(data), read = 0;
+            extractor streamed([&](char *buffer, size_t n) -> size_t
+                               {
+                n = std::min(n, std::min<size_t>(37, size - read));
+                memcpy(buffer, data + read, n);
+                read += n;
+                return n; }, 1024);
+            count = 0;
+            for (auto day : streamed["list"].elements())
+            {
+                assertEqual(day["main"]["humidity"].extract().asInt(),
+                            indexed["list"][count]["main"]["humidity"].extract().asInt(), " %i != %i \n");
+                count++;
+            }
+            assertEqual(count, 40, " %i != %i \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+    class LazyContainerIndexTest : public JsonTestCase
+    {
+    public:
+        LazyContainerIndexTest() : JsonTestCase("LazyContainerIndexTest") {}
+
+        void test()
+        {
+            // {"key0": 0, "key1": "1", ..., "key499": 499, "key0": -1, "list": [0, 1, ..., 999]}
+            std::string json = "{";
+            for (int i = 0; i < 500; i++)
+            {
+                std::string value = i % 2 ? "\"" + std::to_string(i) + "\"" : std::to_string(i);
+                json += "\"key" + std::to_string(i) + "\": " + value + ", ";
+            }
+            json += "\"key0\": -1, \"esc\\\"aped\": true, \"list\": [";
+            for (int i = 0; i < 1000; i++)
+            {
+                json += (i ? ", " : "") + std::to_string(i);
+            }
+            json += "]}";
+
+            extractor ex(json.c_str());
+            wrapper root = ex.extract();
+            LazyObject &object = root.object();
+            assertEqual(object.size(), size_t(503), " %lu != %lu \n");
+            assertTrue(object._table.size() >= 2 * object.size());
+            for (int i = 499; i >= 0; i--)
+            {
+                LazyTypedValues value = object.get("key" + std::to_string(i));
+                if (i % 2)
+                {
+                    assertLazyType(value, LazyType::STRING);
+                    assertEqual(decodeLazyString(value), std::to_string(i));
+                }
+                else
+                {
+                    assertLazyType(value, LazyType::NUMBER);
+                    // the first of the duplicated keys
+                    assertEqual(int(value.values.integer), i, " %i != %i \n");
+                }
+            }
+            assertLazyType(object["key500"], LazyType::NULL_TYPE);
+            assertLazyType(object["esc\"aped"], LazyType::BOOL);
+
+            LazyTypedValues list = object["list"];
+            assertLazyType(list, LazyType::LIST);
+            assertEqual(list.values.list->size(), size_t(1000), " %lu != %lu \n");
+            for (int i = 0; i < 1000; i += 7)
+            {
+                assertEqual(int((*list.values.list)[i].values.integer), i, " %i != %i \n");
+            }
+            assertLazyType(list.values.list->get(1000), LazyType::NULL_TYPE);
+            assertLazyType(list.values.list->get(-1), LazyType::NULL_TYPE);
+
+            // copies keep the index
+            wrapper copy = root;
+            assertEqual(decodeLazyString(copy.object().get("key499")), std::string("499"));
+            assertEqual(int((*copy.object()["list"].values.list)[999].values.integer), 999, " %i != %i \n");
+
+            // small objects are scanned, deep parsed lists keep their indices
+            extractor small("{\"a\": 1, \"b\": [[1, 2], {\"c\": 3}, \"d\"]}");
+            wrapper value = small.extract();
+            assertTrue(value.object()._table.empty());
+            assertLazyType(value.object()["b"], LazyType::LIST);
+            LazyList *b = value.object()["b"].values.list;
+            LazyTypedValues deep = b->get(0, true);
+            assertLazyType(deep, LazyType::LIST);
+            assertEqual(deep.values.list->size(), size_t(2), " %lu != %lu \n");
+            assertTrue(deep.values.list->_list[1].type == LazyType::NUMBER);
+            assertEqual(int(deep.values.list->_list[1].values.integer), 2, " %i != %i \n");
+            deep = b->get(1, true);
+            assertTrue(deep.values.object->_list[0].value.type == LazyType::NUMBER);
+            assertEqual(decodeLazyString(b->get(2)), std::string("d"));
+        }
+    };
+
+    class ArenaTest : public JsonTestCase
+    {
+    public:
+        ArenaTest() : JsonTestCase("ArenaTest") {}
+
+        /// @brief Deep parse of the first `count` forecast elements, returns the sum of the temperatures
+        float deepParse(extractor &ex, int count = 40)
+        {
+            wrapper list = ex["list"].extract();
+            float sum = 0;
+            for (int i = 0; i < count; i++)
+            {
+                LazyTypedValues day = list.list().get(i, true);
+                LazyTypedValues main = day.values.object->get("main");
+                sum += float(main.values.object->get("temp").values.real);
+                assertEqual(decodeLazyString(day.values.object->get("weather").values.list->get(0).values.object->get("main")).size() > 0, true, " %i != %i \n");
+            }
+            return sum;
+        }
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            extractor heap(FORECAST_API_DATA);
+            heap.useArena(nullptr);
+            size_t before = allocationCount();
+            float expected = deepParse(heap);
+            size_t heap_allocations = allocationCount() - before;
+
+            // the same nodes, bump-allocated from a few blocks
+            auto memory = std::make_shared<arena>(1024);
+            extractor ex(FORECAST_API_DATA);
+            ex.useArena(memory);
+            // the memo table is allocated by the first filter
+            static_cast<void>(ex["cnt"].extract());
+            before = allocationCount();
+            assertEqual(deepParse(ex), expected, " %f != %f \n");
+            size_t arena_allocations = allocationCount() - before;
+            Serial.printf("\tHeap allocations: %u, with arena: %u, %u blocks, %u bytes\n", unsigned(heap_allocations),
+                          unsigned(arena_allocations), unsigned(memory->blocks()), unsigned(memory->used()));
+            assertEqual(arena_allocations, size_t(0));
+            assertTrue(heap_allocations > 500);
+            assertTrue(memory->blocks() < 10);
+
+            // nothing holds the values, the next extraction starts over in the largest block
+            size_t used = memory->used();
+            assertEqual(deepParse(ex), expected, " %f != %f \n");
+            assertEqual(memory->used(), used, " %lu != %lu \n");
+            assertTrue(memory->blocks() <= 2);
+
+            // values outlive the extraction, clones are independent of the arena
+            static_cast<void>(ex["list"].extract());
+            size_t list_used = memory->used();
+            wrapper city = ex["city"].extract();
+            wrapper copy = city.clone();
+            wrapper shared = city;
+            wrapper name = ex["city"]["name"].extract();
+            assertEqual(name.asString(), String("Oława"));
+            // held by the wrappers, nothing is reused
+            static_cast<void>(ex["list"].extract());
+            assertTrue(memory->used() > list_used);
+            assertEqual(decodeLazyString(city.object().get("country")), std::string("PL"));
+            city = wrapper();
+            name = wrapper();
+            // a copy of the wrapper holds the arena too
+            static_cast<void>(ex["list"].extract());
+            assertTrue(memory->used() > list_used);
+            assertEqual(decodeLazyString(shared.object().get("name")), std::string("Oława"));
+            shared = wrapper();
+            static_cast<void>(ex["list"].extract());
+            assertEqual(memory->used(), list_used, " %lu != %lu \n");
+            assertEqual(decodeLazyString(copy.object().get("name")), std::string("Oława"));
+            assertTrue(copy.object()._list.get_allocator()._arena == nullptr);
+
+            // caller-supplied buffer, nothing else is allocated
+            static char buffer[32768];
+            auto fixed = std::make_shared<arena>(buffer, sizeof(buffer), null_upstream());
+            ex.useArena(fixed);
+            heap.reset();
+            float first = deepParse(heap, 2);
+            before = allocationCount();
+            assertEqual(deepParse(ex, 2), first, " %f != %f \n");
+            assertEqual(allocationCount() - before, size_t(0));
+            assertEqual(fixed->blocks(), size_t(0), " %lu != %lu \n");
+            assertTrue(fixed->used() > 0 && fixed->used() <= sizeof(buffer));
+
+            // too small, the upstream refuses to grow
+            static char tiny[256];
+            ex.useArena(std::make_shared<arena>(tiny, sizeof(tiny), null_upstream()));
+            assertThrow<std::bad_alloc>([&]()
+                                        { deepParse(ex); });
+
+#if LAZY_JSON_PMR
+            std::pmr::monotonic_buffer_resource resource;
+            pmr_upstream upstream(&resource);
+            ex.useArena(std::make_shared<arena>(256, &upstream));
+            assertEqual(deepParse(ex), expected, " %f != %f \n");
+            ex.useArena(nullptr);
+#endif
+            setMemoryWatchpoint();
+        }
+    };
+
+    class WrapperOwnershipTest : public JsonTestCase
+    {
+    public:
+        WrapperOwnershipTest() : JsonTestCase("WrapperOwnershipTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            for (int memory = 0; memory < 2; memory++)
+            {
+                extractor ex(FORECAST_API_DATA);
+                if (!memory)
+                {
+                    ex.useArena(nullptr);
+                }
+                wrapper city = ex["city"].extract();
+                LazyObject *node = &city.object();
+
+                std::vector<wrapper> stored;
+                stored.reserve(4);
+
+                // copies and moves share the node, nothing is cloned
+                size_t before = allocationCount();
+                wrapper copy = city;
+                for (int i = 0; i < 4; i++)
+                {
+                    stored.push_back(copy);
+                }
+                wrapper moved = std::move(copy);
+                wrapper assigned;
+                assigned = moved;
+                assertEqual(allocationCount() - before, size_t(0), " %lu != %lu \n");
+                assertTrue(&moved.object() == node);
+                assertTrue(&assigned.object() == node);
+                assertTrue(&stored[3].object() == node);
+                assertTrue(copy.isNull());
+
+                // the value is kept alive by the last copy
+                city = wrapper();
+                stored.clear();
+                moved = wrapper();
+                assertEqual(decodeLazyString(assigned.object().get("name")), std::string("Oława"));
+
+                // clones are deep, independent copies
+                wrapper clone = assigned.clone();
+                assertTrue(&clone.object() != node);
+                assigned = wrapper();
+                assertEqual(decodeLazyString(clone.object().get("country")), std::string("PL"));
+                assertEqual(clone.object().size(), size_t(8), " %lu != %lu \n");
+            }
+
+            // containers taking over the records of another one
+            extractor ex(WEATHER_API_DATA);
+            ex.useArena(nullptr);
+            wrapper main = ex["main"].extract();
+            LazyObject object(std::move(main.object()));
+            assertEqual(main.object().size(), size_t(0), " %lu != %lu \n");
+            assertEqual(object.get("humidity").values.integer, int64_t(77));
+            LazyObject assigned(nullptr);
+            assigned = std::move(object);
+            assertEqual(object.size(), size_t(0), " %lu != %lu \n");
+            assertTrue(assigned.size() > 0);
+
+            wrapper weather = ex["weather"].extract();
+            LazyList list(std::move(weather.list()));
+            assertEqual(weather.list().size(), size_t(0), " %lu != %lu \n");
+            assertEqual(decodeLazyString(list.get(0, true).values.object->get("main")), std::string("Clouds"));
+            setMemoryWatchpoint();
+        }
+    };
+
+    class CompactValueTest : public JsonTestCase
+    {
+    public:
+        CompactValueTest() : JsonTestCase("CompactValueTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            assertTrue(sizeof(LazyTypedValues) <= 16);
+
+            // scalars and strings are stored in place, even without an arena
+            extractor ex(WEATHER_API_DATA);
+            ex.useArena(nullptr);
+            ex.memoize(0);
+            size_t before = allocationCount();
+            wrapper humidity = ex["main"]["humidity"].extract();
+            wrapper temp = ex["main"]["temp"].extract();
+            wrapper name = ex["name"].extract();
+            wrapper icon = ex["weather"][0]["icon"].extract();
+            wrapper missing = ex["nokey"]["none"].extract();
+            assertEqual(allocationCount() - before, size_t(0), " %lu != %lu \n");
+
+            assertEqual(humidity.asInt(), 77, " %i != %i \n");
+            assertTrue(humidity.raw().flags & LAZY_VALUE_INTEGRAL);
+            assertEqual(temp.as<double>(), -6.26, " %f != %f \n");
+            assertLazyType(name.raw(), LazyType::STRING);
+            assertEqual(std::string(name.raw().values.string, name.raw().length), std::string("Oława"));
+            assertEqual(icon.as<std::string>(), std::string("04n"));
+            assertTrue(missing.isNull());
+
+            // the string children of a parsed object are spans too
+            wrapper main = ex["weather"][0].extract();
+            LazyTypedValues description = main.object().get("description");
+            assertEqual(decodeLazyString(description), std::string("zachmurzenie duże"));
+            setMemoryWatchpoint();
+        }
+    };
+
+    class DocumentCursorTest : public JsonTestCase
+    {
+    public:
+        DocumentCursorTest() : JsonTestCase("DocumentCursorTest") {}
+
+        /// @brief Sum of the temperatures and humidities of the forecast
+        static double forecastSum(extractor &cur)
+        {
+            double sum = 0;
+            for (auto day : cur["list"].elements())
+            {
+                sum += day["main"]["temp"].extract().as<double>();
+                sum += day["main"]["humidity"].extract().asInt();
+            }
+            return sum;
+        }
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            std::unique_ptr<cursor> outliving;
+            double expected = 0;
+            {
+                // the document owns the payload
+                const document doc{std::string(FORECAST_API_DATA)};
+                cursor first(doc);
+                expected = forecastSum(first);
+
+                // creating a cursor allocates nothing, the memo table is allocated by the first filter
+                size_t before = allocationCount();
+                {
+                    cursor cur(doc);
+                    cursor copy(cur);
+                    assertEqual(allocationCount() - before, size_t(0));
+                    assertEqual(cur["cnt"].extract().asInt(), 40, " %i != %i \n");
+                }
+                assertEqual(allocationCount() - before, size_t(LAZY_JSON_MEMO_SIZE ? 1 : 0), " %lu != %lu \n");
+
+                // many threads, one document, a cursor each
+                constexpr int THREADS = 4;
+                double sums[THREADS] = {0};
+                std::vector<std::thread> workers;
+                for (int t = 0; t < THREADS; t++)
+                {
+                    workers.push_back(std::thread([&doc, &sums, t]()
+                                                  {
+                        cursor cur(doc);
+                        for (int n = 0; n < 20; n++)
+                        {
+                            cur.reset();
+                            sums[t] += forecastSum(cur);
+                        } }));
+                }
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+                for (int t = 0; t < THREADS; t++)
+                {
+                    assertEqual(sums[t], expected * 20, " %f != %f \n");
+                }
+                outliving.reset(new cursor(doc));
+            }
+            // the owned json is kept alive by the cursor
+            assertEqual((*outliving)["city"]["name"].extract().as<std::string>(), std::string("Oława"));
+            outliving.reset();
+
+            // the extracted strings point into the owned json, the wrappers keep it alive
+            wrapper name, city;
+            {
+                const document doc{std::string(FORECAST_API_DATA)};
+                cursor cur(doc);
+                name = cur["city"]["name"].extract();
+                city = cur.extract(path_set({path("city")}), true)[0];
+            }
+            assertEqual(name.as<std::string>(), std::string("Oława"));
+            assertEqual(wrapper(city.object()["country"]).as<std::string>(), std::string("PL"));
+            name = wrapper();
+            city = wrapper();
+
+            // referenced json, nothing is copied
+            const document view(WEATHER_API_DATA);
+            assertTrue(view.data() == WEATHER_API_DATA);
+            assertTrue(view.source() == nullptr);
+            cursor cur(view);
+            assertEqual(cur["main"]["humidity"].extract().asInt(), 77, " %i != %i \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+    class MultiDocumentTest : public JsonTestCase
+    {
+    public:
+        MultiDocumentTest() : JsonTestCase("MultiDocumentTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            // no delimiter, whitespace, scalars, brackets inside strings
+            const char *frame = "{\"id\": 1, \"v\": [1, 2]}{\"id\": 2}  \n \"text\" 42 [3, 4]{\"id\": 3, \"s\": \"}{\"}";
+            const char *expected[] = {"{\"id\": 1, \"v\": [1, 2]}", "{\"id\": 2}", "\"text\"", "42", "[3, 4]", "{\"id\": 3, \"s\": \"}{\"}"};
+            extractor ex(frame);
+            size_t count = 0;
+            int ids = 0;
+            auto documents = ex.documents();
+            for (auto doc : documents)
+            {
+                assertEqual(documents.index(), count, " %lu != %lu \n");
+                assertEqual(doc.json(), std::string(expected[count]));
+                assertEqual(ex.depth(), size_t(1), " %lu != %lu \n");
+                if (count == 0 || count == 1 || count == 5)
+                {
+                    ids += doc["id"].extract().asInt();
+                    // extract() goes back to the document, not the first one
+                    assertFalse(doc.extract().isNull());
+                }
+                count++;
+            }
+            assertEqual(count, size_t(6), " %lu != %lu \n");
+            assertEqual(ids, 6, " %i != %i \n");
+            assertEqual(ex.depth(), size_t(0), " %lu != %lu \n");
+
+            // left early, then the first document again
+            for (auto doc : ex.documents())
+            {
+                assertEqual(doc["v"][1].extract().asInt(), 2, " %i != %i \n");
+                break;
+            }
+            assertEqual(ex.depth(), size_t(0), " %lu != %lu \n");
+            ex.reset();
+            assertEqual(ex["id"].extract().asInt(), 1, " %i != %i \n");
+
+            // nothing but whitespace
+            count = 0;
+            extractor empty(" \n ");
+            for (auto doc : empty.documents())
+            {
+                static_cast<void>(doc);
+                count++;
+            }
+            assertEqual(count, size_t(0), " %lu != %lu \n");
+
+            // streamed in small reads, the documents are read once, the buffer holds only a few of them
+            std::string stream;
+            for (int i = 0; i < 50; i++)
+            {
+                stream += "{\"id\": " + std::to_string(i) + ", \"list\": [{\"x\": \"]\"}, " + std::to_string(i) + "]}\r\n";
+            }
+            size_t offset = 0;
+            extractor streamed([&](char *buffer, size_t size)
+                               {
+                size_t n = std::min(size, std::min(stream.size() - offset, size_t(7)));
+                memcpy(buffer, stream.data() + offset, n);
+                offset += n;
+                return n; },
+                               128);
+            count = 0;
+            ids = 0;
+            for (auto doc : streamed.documents())
+            {
+                ids += doc["list"][1].extract().asInt();
+                count++;
+            }
+            assertEqual(count, size_t(50), " %lu != %lu \n");
+            assertEqual(ids, 49 * 50 / 2, " %i != %i \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+    class StructBindingTest : public JsonTestCase
+    {
+    public:
+        StructBindingTest() : JsonTestCase("StructBindingTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            {
+                extractor ex(WEATHER_API_DATA);
+                bound_weather report;
+                assertTrue(ex.decode(report));
+                assertTrue(report.position.lon == 17.2903f && report.position.lat == 50.9571f);
+                assertEqual(report.weather.size(), size_t(1), " %lu != %lu \n");
+                assertEqual(report.weather[0].id, 804, " %i != %i \n");
+                assertEqual(report.weather[0].main, std::string("Clouds"));
+                assertEqual(report.weather[0].description, std::string("zachmurzenie duże"));
+                assertTrue(report.weather[0].icon == String("04n"));
+                assertTrue(report.main.temp == -6.26f && report.main.feels_like == -12.88f);
+                assertEqual(report.main.pressure, 1020, " %i != %i \n");
+                assertEqual(report.main.humidity, 77, " %i != %i \n");
+                assertEqual(report.visibility, 10000, " %i != %i \n");
+                assertTrue(report.wind.speed == 5.2f && report.wind.deg == 17 && report.wind.gust == 8.05);
+                assertTrue(report.dt == 1704642926);
+                assertEqual(report.name, std::string("Oława"));
+                assertEqual(report.cod, 200, " %i != %i \n");
+                // the next filter starts from the root again
+                assertEqual(ex["main"]["humidity"].extract().asInt(), 77, " %i != %i \n");
+
+                // a filtered value, and a missing one
+                bound_main main;
+                assertTrue(ex["main"].decode(main));
+                assertEqual(main.pressure, 1020, " %i != %i \n");
+                main.humidity = -1;
+                assertFalse(ex["missing"]["main"].decode(main));
+                assertEqual(main.humidity, -1, " %i != %i \n");
+            }
+            {
+                // the whole forecast at once, same values as filtering them one by one
+                extractor ex(FORECAST_API_DATA);
+                bound_forecast forecast;
+                assertTrue(ex.decode(forecast));
+                assertEqual(forecast.cod, std::string("200"));
+                assertEqual(forecast.cnt, 40, " %i != %i \n");
+                assertEqual(forecast.list.size(), size_t(40), " %lu != %lu \n");
+                for (int i = 0; i < 40; i += 13)
+                {
+                    assertTrue(forecast.list[i].dt == long(ex["list"][i]["dt"].extract().as<double>()));
+                    assertEqual(forecast.list[i].main.temp, ex["list"][i]["main"]["temp"].extract().asFloat(), " %f != %f \n");
+                    assertEqual(forecast.list[i].weather[0].description, ex["list"][i]["weather"][0]["description"].extract().as<std::string>());
+                }
+
+                // element by element
+                size_t i = 0;
+                for (auto day : ex["list"].elements())
+                {
+                    bound_forecast_day decoded;
+                    assertTrue(day.decode(decoded));
+                    assertTrue(decoded.dt == forecast.list[i].dt && decoded.main.temp == forecast.list[i].main.temp);
+                    i++;
+                }
+                assertEqual(i, size_t(40), " %lu != %lu \n");
+            }
+            {
+                // null and missing members keep their values, unbound ones are skipped,
+                // escaped keys are decoded
+                extractor ex("{\"extra\": {\"id\": 1, \"tag\": [\"}\"]}, \"missing\": null, \"\\u0074ag\": \"x\", "
+                             "\"flags\": [true, false, true], \"values\": [1, 2.5, -3e2], \"matrix\": [[1], [], [2, 3]], \"id\": 7}");
+                bound_misc misc;
+                assertTrue(ex.decode(misc));
+                assertEqual(misc.id, 7, " %i != %i \n");
+                assertEqual(misc.missing, 5, " %i != %i \n");
+                assertEqual(misc.nothing, 6, " %i != %i \n");
+                assertEqual(misc.tag, std::string("x"));
+                assertTrue(misc.flags == std::vector<bool>({true, false, true}));
+                assertTrue(misc.values == std::vector<float>({1.0f, 2.5f, -300.0f}));
+                assertEqual(misc.matrix.size(), size_t(3), " %lu != %lu \n");
+                assertTrue(misc.matrix[0] == std::vector<int>({1}) && misc.matrix[1].empty() && misc.matrix[2] == std::vector<int>({2, 3}));
+
+                // a value of another type than the member
+                bool thrown = false;
+                extractor wrong("{\"id\": \"seven\"}");
+                try
+                {
+                    wrong.decode(misc);
+                }
+                catch (const invalid_type &e)
+                {
+                    thrown = true;
+                }
+                assertTrue(thrown);
+                assertEqual(wrong["id"].extract().as<std::string>(), std::string("seven"));
+            }
+            {
+                // streamed in small reads through a buffer smaller than the payload
+                size_t offset = 0, size = strlen(WEATHER_API_DATA);
+                extractor streamed([&](char *buffer, size_t capacity)
+                                   {
+                    size_t n = std::min(capacity, std::min(size - offset, size_t(7)));
+                    memcpy(buffer, WEATHER_API_DATA + offset, n);
+                    offset += n;
+                    return n; },
+                                   64);
+                bound_weather report;
+                assertTrue(streamed.decode(report));
+                assertEqual(report.weather[0].description, std::string("zachmurzenie duże"));
+                assertTrue(report.wind.gust == 8.05);
+                assertEqual(report.name, std::string("Oława"));
+                assertEqual(report.cod, 200, " %i != %i \n");
+            }
+            setMemoryWatchpoint();
+        }
+    };
+
+    class PathLiteralTest : public JsonTestCase
+    {
+    public:
+        PathLiteralTest() : JsonTestCase("PathLiteralTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            // parsed by the compiler
+            constexpr static_path temp = "list[3].main.temp"_jp;
+            static_assert(temp.size() == 4, "segments of the literal");
+            static_assert(temp[1].index == 3 && !temp[1].is_key, "index segment");
+            static_assert(temp[3].length == 4 && temp[3].hash == static_hash("temp", 4), "key segment");
+            assertTrue(temp.hash() == path("list[3].main.temp").hash());
+            assertTrue("/a/b"_jp.hash() == "a.b"_jp.hash());
+            assertTrue("/a/3/"_jp.size() == 3 && "/a/3/"_jp[1].is_key && "/a/3/"_jp[1].index == 3);
+            assertTrue("[\"a.b\"]"_jp[0].length == 3);
+
+            // same results as the compiled paths
+            extractor literal(FORECAST_API_DATA), compiled(FORECAST_API_DATA);
+            assertEqual(literal[temp].extract().asFloat(), compiled[path("list[3].main.temp")].extract().asFloat(), " %f != %f \n");
+            assertEqual(literal["/list/39/main/temp"_jp].extract().asFloat(), compiled[path("/list/39/main/temp")].extract().asFloat(), " %f != %f \n");
+            assertEqual(literal["city.name"_jp].extract().asString(), String("Oława"));
+            assertTrue(literal["city.missing.deeper[2]"_jp].isNull());
+            assertTrue(literal[""_jp].extract().type() == LazyType::OBJECT);
+            for (auto day : literal["list"_jp].elements())
+            {
+                assertTrue(!day["main.temp"_jp].isNull());
+            }
+
+            extractor ex("{\"a/b\": {\"m~n\": 1, \"3\": [10, 20], \"x.y\": true}, \"list\": [\"zero\", {\"0\": 5}]}");
+            assertEqual(ex["/a/b"_jp].isNull(), true, " %i != %i \n");
+            assertEqual(ex["['a/b']['m~n']"_jp].extract().asInt(), 1, " %i != %i \n");
+            assertEqual(ex["[\"a/b\"][\"3\"][1]"_jp].extract().asInt(), 20, " %i != %i \n");
+            assertEqual(ex["/list/1/0"_jp].extract().asInt(), 5, " %i != %i \n");
+            assertThrow<invalid_type>([&]()
+                                      { ex["list.a"_jp]; });
+
+            // escapes need `path`, malformed literals evaluated at run time throw
+            const char *invalid[] = {"a..b", "a.", ".a", "a[", "a[x]", "a[01]", "a[1]b", "a[\"b]", "a[\"\\\"\"]", "/a~1b", "a.b.c.d.e.f.g.h.i"};
+            for (const char *source : invalid)
+            {
+                assertThrow<invalid_path>([&]()
+                                          { static_path p(source, strlen(source)); });
+            }
+
+            // the memo is keyed by the same hashes as `filter(std::string)`
+            extractor memo(WEATHER_API_DATA);
+            assertEqual(memo["main"]["humidity"].extract().asInt(), 77, " %i != %i \n");
+            size_t hits = memo.memoStats().hits;
+            assertEqual(memo["main.humidity"_jp].extract().asInt(), 77, " %i != %i \n");
+            assertEqual(memo.memoStats().hits, hits + 2, " %lu != %lu \n");
+
+            // running a literal doesn't allocate
+            size_t before = allocationCount();
+            for (int i = 0; i < 10; i++)
+            {
+                static_cast<void>(memo["wind.speed"_jp].extract().asFloat());
+                static_cast<void>(memo["weather[0].id"_jp].extract().asInt());
+            }
+            assertEqual(allocationCount() - before, size_t(0), " %lu != %lu \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+    class ValidatorTest : public JsonTestCase
+    {
+    public:
+        ValidatorTest() : JsonTestCase("ValidatorTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            const char *valid[] = {
+                FORECAST_API_DATA, WEATHER_API_DATA, "0", " -0.5e+10 ", "\"\"", "true", "null", "[]", " {} ",
+                "[[[]], {\"a\": [1, -2, 3.25, 4E5, 0e-1]}, \"x\", false]",
+                "{\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\uD83D\\uDE00\": \"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\"}"};
+            for (const char *json : valid)
+            {
+                validation result = validate(json, strlen(json));
+                assertTrue(result.valid);
+            }
+
+            // the position of the error is reported
+            struct
+            {
+                const char *json;
+                size_t position;
+            } invalid[] = {
+                {"", 0}, {"   ", 3}, {"tru", 3}, {"[nul]", 4}, {"[truex]", 5}, {"{\"a\": True}", 6},
+                {"[1,]", 3}, {"[,1]", 1}, {"[1 2]", 3}, {"{\"a\" 1}", 5}, {"{\"a\": 1,}", 8}, {"{1: 2}", 1},
+                {"{\"a\": 1]", 7}, {"[1}", 2}, {"[1", 2}, {"{\"a\": {}", 8}, {"1 2", 2}, {"{} x", 3},
+                {"01", 1}, {"[-]", 2}, {"[1.]", 3}, {"[.5]", 1}, {"[1e]", 3}, {"[+1]", 1}, {"[0x10]", 2},
+                {"[\"abc]", 6}, {"\"abc", 4}, {"[\"a\\x\"]", 3}, {"[\"\\u12G4\"]", 2}, {"[\"a\tb\"]", 3}, {"\"a\nb\"", 2},
+                {"[\"\xc0\xaf\"]", 2}, {"[\"\xed\xa0\x80\"]", 3}, {"[\"\xe2\x82\"]", 4}, {"[\"\xf5\x80\x80\x80\"]", 2},
+                {"[\"\x80\"]", 2}, {"[\xc3\xa9]", 1}};
+            for (auto &item : invalid)
+            {
+                validation result = validate(item.json, strlen(item.json));
+                assertTrue(!result.valid && result.reason);
+                assertEqual(result.position, item.position, " %lu != %lu \n");
+            }
+
+            // strings, escapes and UTF-8 sequences across the 64 byte blocks
+            for (size_t pad = 50; pad < 70; pad++)
+            {
+                std::string json = "[\"" + std::string(pad, 'a') + "\\\"\\\\\xe2\x82\xac\\u00e9\", " + std::string(pad, ' ') + "12345.5e3]";
+                assertTrue(validate(json.data(), json.size()).valid);
+                std::string broken = json;
+                broken[pad + 7] = 'A'; // inside the euro sign
+                assertEqual(validate(broken.data(), broken.size()).position, pad + 7, " %lu != %lu \n");
+            }
+
+            // every strict prefix of an object is invalid
+            std::string weather(WEATHER_API_DATA);
+            for (size_t length = 0; length + 1 < weather.size(); length += 7)
+            {
+                assertTrue(!validate(weather.data(), length).valid);
+            }
+
+            // nesting
+            std::string deep = std::string(LAZY_JSON_MAX_DEPTH, '[') + std::string(LAZY_JSON_MAX_DEPTH, ']');
+            assertTrue(validate(deep.data(), deep.size()).valid);
+            deep = "[" + deep + "]";
+            assertTrue(strcmp(validate(deep.data(), deep.size()).reason, "nested too deep") == 0);
+
+            // a single value, or its part before `stop`
+            const char *partial = "{\"a\": [1, 2], \"b\": tru, \"c\": 3} trailing";
+            validation value = validate_value(partial, strlen(partial), 6);
+            assertTrue(value.valid);
+            assertEqual(value.end, size_t(12), " %lu != %lu \n");
+            assertTrue(validate_value(partial, strlen(partial), 0, 19).valid);
+            assertTrue(!validate_value(partial, strlen(partial), 0, 20).valid);
+
+            // a check stopped inside a container continues from where it stopped
+            const char *rest = "[1, \"x\", [2, {\"y\": 3}], {\"z\": [4]}, tru]";
+            validation_frontier frontier;
+            assertTrue(validate_value(rest, strlen(rest), 0, 4, &frontier).valid);
+            assertEqual(frontier.pos, size_t(4), " %lu != %lu \n");
+            assertTrue(validate_rest(rest, strlen(rest), frontier, 24, &frontier).valid);
+            assertEqual(frontier.pos, size_t(24), " %lu != %lu \n");
+            value = validate_rest(rest, strlen(rest), frontier, size_t(-1), &frontier);
+            assertTrue(!value.valid);
+            assertEqual(value.position, validate_value(rest, strlen(rest), 0).position, " %lu != %lu \n");
+            assertEqual(frontier.pos, size_t(0), " %lu != %lu \n");
+            // stopped in a nested value, it can't be continued
+            assertTrue(validate_value(rest, strlen(rest), 0, 15, &frontier).valid);
+            assertEqual(frontier.pos, size_t(0), " %lu != %lu \n");
+
+            // touched: only what the extraction reads is checked
+            extractor ex(partial, strlen(partial) - 9);
+            assertThrow<invalid_json>([&]()
+                                      { ex.validate(); });
+            ex.validate(validation_mode::touched);
+            assertEqual(ex["a"][1].extract().asInt(), 2, " %i != %i \n");
+            assertThrow<invalid_json>([&]()
+                                      { ex["c"]; });
+            assertThrow<invalid_json>([&]()
+                                      { ex["b"].extract(); });
+            // the extractor is back at the root
+            assertEqual(ex["a"][0].extract().asInt(), 1, " %i != %i \n");
+            ex.validate(validation_mode::none);
+            assertEqual(ex["c"].extract().asInt(), 3, " %i != %i \n");
+
+            // a missing key is checked up to the end of the object, iteration checks the whole container
+            extractor lists("{\"x\": [1, [2,, 3]], \"y\": {\"z\": nul}}");
+            lists.validate(validation_mode::touched);
+            assertEqual(lists["x"][0].extract().asInt(), 1, " %i != %i \n");
+            assertThrow<invalid_json>([&]()
+                                      { lists["x"][2]; });
+            assertThrow<invalid_json>([&]()
+                                      { for (auto element : lists["x"].elements()) static_cast<void>(element); });
+            // the skipped values before the key are checked too
+            assertThrow<invalid_json>([&]()
+                                      { lists["y"]; });
+            extractor objects("{\"y\": {\"z\": nul}}");
+            objects.validate(validation_mode::touched);
+            assertThrow<invalid_json>([&]()
+                                      { objects["y"]["missing"]; });
+            assertThrow<invalid_json>([&]()
+                                      { objects["y"].extract(path_set({path("z")})); });
+
+            // the type is checked too, and so are the strings the scan can't get past
+            extractor literal("[null, nu]");
+            literal.validate(validation_mode::touched);
+            assertTrue(literal[0].isNull());
+            assertThrow<invalid_json>([&]()
+                                      { literal[1].isNull(); });
+            extractor unterminated("{\"a\": 1, \"b: 2}");
+            unterminated.validate(validation_mode::touched);
+            assertThrow<invalid_json>([&]()
+                                      { unterminated["c"]; });
+            extractor skipped("[[1, 2], [3, 4}, 5]");
+            skipped.validate(validation_mode::touched);
+            assertEqual(skipped[0][1].extract().asInt(), 2, " %i != %i \n");
+            assertThrow<invalid_json>([&]()
+                                      { skipped[2]; });
+
+            extractor docs("{\"id\": 1} {\"id\": 2} {\"id\": 3");
+            docs.validate(validation_mode::touched);
+            int ids = 0;
+            assertThrow<invalid_json>([&]()
+                                      { for (auto doc : docs.documents()) ids += doc["id"].extract().asInt(); });
+            assertEqual(ids, 3, " %i != %i \n");
+
+            // each lookup continues the check of the list from the previous one,
+            // the part already checked is not read again
+            std::string list = "[1, [2], {\"a\": 3}, 4, 5, tru]";
+            extractor walked(list.data(), list.size());
+            walked.memoize(0);
+            walked.validate(validation_mode::touched);
+            for (int i = 0; i < 4; i++)
+            {
+                assertTrue(!walked[i].isNull());
+            }
+            if (LAZY_JSON_CHECKED_VALUES > 1)
+            {
+                // the list is remembered next to its element
+                list[1] = 'x';
+            }
+            assertEqual(walked[4].extract().asInt(), 5, " %i != %i \n");
+            assertThrow<invalid_json>([&]()
+                                      { walked[5].isNull(); });
+
+            extractor forecast(FORECAST_API_DATA);
+            forecast.validate();
+            forecast.validate(validation_mode::touched);
+            assertEqual(forecast["cnt"].extract().asInt(), 40, " %i != %i \n");
+            // the checked parts are kept in the extractor, more values than it remembers are touched
+            size_t before = allocationCount();
+            for (int i = 0; i < 40; i++)
+            {
+                assertTrue(!forecast["list"][i]["main"]["temp"].isNull());
+            }
+            assertEqual(allocationCount() - before, size_t(0), " %lu != %lu \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+    class TrustedPolicyTest : public JsonTestCase
+    {
+    public:
+        TrustedPolicyTest() : JsonTestCase("TrustedPolicyTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            static_assert(std::is_base_of<extractor, basic_extractor<>>::value, "the default policy is the extractor");
+
+            // same values as the checked extractor
+            extractor safe(FORECAST_API_DATA);
+            basic_extractor<trusted_minified> minified(FORECAST_API_DATA);
+            for (int i = 0; i < 40; i += 3)
+            {
+                assertEqual(minified["list"][i]["main"]["temp"].extract().asFloat(), safe["list"][i]["main"]["temp"].extract().asFloat(), " %f != %f \n");
+                assertEqual(minified["list"][i]["weather"][0]["description"].extract().asString(), safe["list"][i]["weather"][0]["description"].extract().asString());
+            }
+            assertEqual(minified["city"]["name"].extract().asString(), String("Oława"));
+            assertEqual(minified[path("/list/39/dt_txt")].extract().asString(), safe[path("/list/39/dt_txt")].extract().asString());
+            assertEqual(minified["city.coord.lat"_jp].extract().asFloat(), safe["city.coord.lat"_jp].extract().asFloat(), " %f != %f \n");
+            assertEqual(minified["list"].extract().list().size(), size_t(40), " %lu != %lu \n");
+
+            // not found, null propagation, wrong types
+            assertTrue(minified["missing"].isNull());
+            assertTrue(minified["list"][40].isNull());
+            assertTrue(minified["list"][-1]["main"].extract().isNull());
+            assertTrue(!minified["city"].isNull());
+            assertThrow<invalid_type>([&]()
+                                      { minified["list"]["main"]; });
+            assertEqual(minified["cnt"].extract().asInt(), 40, " %i != %i \n");
+
+            // whitespace between the tokens, escaped keys, numeric pointer segments
+            const char *pretty = " {\n  \"a\" : [ 1 , { \"b\\\"c\" : null , \"3\" : \"x\" } , [ ] ],\n  \"d\\u0065\" : true , \"e\" : { }\n} ";
+            basic_extractor<trusted_input> spaced(pretty);
+            assertEqual(spaced["a"][0].extract().asInt(), 1, " %i != %i \n");
+            assertTrue(spaced["a"][1]["b\"c"].isNull());
+            assertTrue(spaced["a"][1]["b\"c"]["deeper"][0].extract().isNull());
+            assertEqual(spaced["/a/1/3"_jp].extract().asString(), String("x"));
+            assertEqual(spaced["a"][2].extract().list().size(), size_t(0), " %lu != %lu \n");
+            assertEqual(spaced["de"].extract().asBool(), true, " %i != %i \n");
+            assertTrue(spaced["e"]["f"].isNull());
+
+            // cached values
+            spaced["a"][1].cache();
+            assertEqual(spaced["3"].extract().asString(), String("x"));
+            assertTrue(spaced["a"].isNull());
+            spaced.reset();
+            assertEqual(spaced["a"][0].extract().asInt(), 1, " %i != %i \n");
+            setMemoryWatchpoint();
+        }
+    };
+
+#if LAZY_JSON_THREADS
+    class ParallelParseTest : public JsonTestCase
+    {
+    public:
+        ParallelParseTest() : JsonTestCase("ParallelParseTest") {}
+
+        /// @brief Both values are the same json (types, numbers, strings, keys in order)
+        static bool sameValue(const LazyTypedValues &a, const LazyTypedValues &b)
+        {
+            if (a.type != b.type || a.flags != b.flags || a.length != b.length)
+            {
+                return false;
+            }
+            switch (a.type)
+            {
+            case LazyType::OBJECT:
+            {
+                auto &left = a.values.object->_list, &right = b.values.object->_list;
+                if (left.size() != right.size())
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < left.size(); i++)
+                {
+                    if (left[i].key != right[i].key || left[i].hash != right[i].hash || !sameValue(left[i].value, right[i].value))
+                    {
+                        return false;
+                    }
+                }
+                return a.values.object->json() == b.values.object->json();
+            }
+            case LazyType::LIST:
+            {
+                auto &left = a.values.list->_list, &right = b.values.list->_list;
+                if (left.size() != right.size())
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < left.size(); i++)
+                {
+                    if (!sameValue(left[i], right[i]))
+                    {
+                        return false;
+                    }
+                }
+                return a.values.list->json() == b.values.list->json();
+            }
+            case LazyType::STRING:
+                return memcmp(a.values.string, b.values.string, a.length) == 0;
+            case LazyType::NUMBER:
+                return a.values.integer == b.values.integer;
+            case LazyType::BOOL:
+                return a.values.boolean == b.values.boolean;
+            default:
+                return true;
+            }
+        }
+
+        /// @brief Parallel parse on 1 to 8 threads gives the same tree as the serial deep parse,
+        /// or throws if the serial one does
+        void assertSameAsSerial(const std::string &json)
+        {
+            Tokenizer tokenizer(json.data(), json.size());
+            std::shared_ptr<arena> memory = std::make_shared<arena>();
+            wrapper serial;
+            bool serial_thrown = false;
+            try
+            {
+                serial = wrapper(lazy_parse(0, true, &tokenizer, memory.get()), memory);
+            }
+            catch (const std::runtime_error &e)
+            {
+                serial_thrown = true;
+            }
+            for (unsigned threads = 1; threads <= 8; threads++)
+            {
+                wrapper parallel;
+                bool parallel_thrown = false;
+                try
+                {
+                    parallel = parallel_parse(document(json.data(), json.size()), threads);
+                }
+                catch (const std::runtime_error &e)
+                {
+                    parallel_thrown = true;
+                }
+                assertEqual(parallel_thrown, serial_thrown);
+                assertTrue(parallel_thrown || sameValue(parallel.raw(), serial.raw()));
+            }
+        }
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            assertSameAsSerial(FORECAST_API_DATA);
+            assertSameAsSerial(WEATHER_API_DATA);
+
+            // escaped quotes and backslashes, brackets and commas inside strings,
+            // spread over many chunk boundaries
+            std::string records = "[";
+            std::string members = "{";
+            for (int i = 0; i < 300; i++)
+            {
+                std::string n = std::to_string(i);
+                std::string record = "{\"id\": " + n + ", \"s\": \"a\\\"b,]}" + n + "\", \"t\": \"" +
+                                     std::string(i % 7, '\\') + std::string(i % 7, '\\') + "\", \"n\": [1.5, {\"x\": \"}\"}, [], {}]," +
+                                     " \"e\": \"\\u00e9\\\\\", \"b\": " + (i % 2 ? "true" : "null") + "}";
+                records += (i ? ",\n  " : "") + record;
+                members += (i ? ", \"k" : "\"k") + n + (i % 5 ? "\"" : "\\n\"") + ": " + record;
+            }
+            records += "]";
+            members += "}";
+            assertSameAsSerial(records);
+            assertSameAsSerial(members);
+
+            // the structural index finds only the root's own commas
+            structural_index index = index_structure(records.data(), records.size(), 5);
+            assertTrue(index.complete);
+            assertEqual(index.separators.size(), size_t(299), " %lu != %lu \n");
+            assertEqual(index.end, records.size(), " %lu != %lu \n");
+            wrapper parsed = parallel_parse(document(records.data(), records.size()), 4);
+            assertEqual(parsed.list().size(), size_t(300), " %lu != %lu \n");
+            assertEqual(int(parsed.list()._list[299].values.object->get("id").values.integer), 299, " %i != %i \n");
+
+            // empty, not a container, malformed: same as the serial parse
+            assertSameAsSerial("[ ]");
+            assertSameAsSerial(" {} ");
+            assertSameAsSerial("\"text\"");
+            assertSameAsSerial("[1, , 2, 3]");
+            assertSameAsSerial("[[1, 2], [3, 4]");
+            assertSameAsSerial("{\"a\": 1, 2: 3}");
+
+            // the parsed nodes and an owned json live as long as the wrapper
+            {
+                const document doc{std::string(records)};
+                parsed = parallel_parse(doc, 3);
+            }
+            assertEqual(decodeLazyString(parsed.list()._list[10].values.object->get("s")), std::string("a\"b,]}10"));
+            parsed = wrapper();
+            setMemoryWatchpoint();
+        }
+    };
+#endif
+
+#if LAZY_JSON_THREADS
+    class NdjsonPipelineTest : public JsonTestCase
+    {
+    public:
+        NdjsonPipelineTest() : JsonTestCase("NdjsonPipelineTest") {}
+
+        void test()
+        {
+            // 3000 lines: records, a blank line, a CRLF line break and a malformed record
+            constexpr int LINES = 3000;
+            std::string json;
+            int blank = 17, malformed = 1234;
+            for (int i = 0; i < LINES; i++)
+            {
+                std::string n = std::to_string(i);
+                if (i == blank)
+                {
+                    json += "   \n";
+                    continue;
+                }
+                if (i == malformed)
+                {
+                    json += "{\"id\": " + n + ", \"user\": {\"name\": \n";
+                    continue;
+                }
+                json += "{\"id\": " + n + ", \"user\": {\"name\": \"u" + n + "\"}, \"tags\": [" + n + ", 1], \"latency\": " +
+                        std::to_string(i % 100) + ".5}" + (i == 100 ? "\r\n" : "\n");
+            }
+            const document doc(json.data(), json.size());
+            const path_set fields({path("id"), path("user.name"), path("tags"), path("latency")});
+
+            // a record selected from the whole json, like the pipeline does
+            extractor ex(doc);
+            size_t second = json.find('\n') + 1;
+            assertEqual(ex.select(second, json.find('\n', second))["id"].extract().asInt(), 1, " %i != %i \n");
+            ex.reset();
+            assertEqual(ex["id"].extract().asInt(), 0, " %i != %i \n");
+
+            for (unsigned threads = 1; threads <= 4; threads++)
+            {
+                std::vector<size_t> ids;
+                double latency = 0;
+                bool values = true;
+                ndjson_pipeline pipeline(fields, threads);
+                ndjson_stats stats = pipeline.run(doc, [&](ndjson_record &record)
+                                                  {
+                    ids.push_back(record.id);
+                    if (record.error)
+                    {
+                        return;
+                    }
+                    std::string n = std::to_string(record.id);
+                    values = values && record.values[0].asInt() == int(record.id) &&
+                             record.values[1].as<std::string>() == "u" + n &&
+                             record.values[2].list().size() == 2 &&
+                             record.values[2].list()._list[0].values.integer == int64_t(record.id);
+                    latency += record.values[3].as<double>(); });
+
+                assertEqual(stats.records, size_t(LINES - 1), " %lu != %lu \n");
+                assertEqual(stats.errors, size_t(1), " %lu != %lu \n");
+                assertEqual(stats.bytes, json.size(), " %lu != %lu \n");
+                assertTrue(values);
+                // in the input order, the line numbers skip only the blank line
+                assertEqual(ids.size(), size_t(LINES - 1), " %lu != %lu \n");
+                assertEqual(ids[blank], size_t(blank + 1), " %lu != %lu \n");
+                assertEqual(ids.back(), size_t(LINES - 1), " %lu != %lu \n");
+                for (size_t i = 1; i < ids.size(); i++)
+                {
+                    assertTrue(ids[i] > ids[i - 1]);
+                }
+
+                // any order, every record exactly once
+                std::vector<char> seen(LINES, 0);
+                double unordered = 0;
+                ndjson_pipeline any(fields, threads, record_order::unordered);
+                stats = any.run(doc, [&](ndjson_record &record)
+                                {
+                    seen[record.id]++;
+                    if (!record.error)
+                    {
+                        unordered += record.values[3].as<double>();
+                    } });
+                assertEqual(stats.records, size_t(LINES - 1), " %lu != %lu \n");
+                assertEqual(unordered, latency, " %f != %f \n");
+                for (int i = 0; i < LINES; i++)
+                {
+                    assertEqual(int(seen[i]), i == blank ? 0 : 1, " %i != %i \n");
+                }
+            }
+
+            // the sink's exception stops the pipeline
+            bool thrown = false;
+            try
+            {
+                ndjson_pipeline(fields, 3).run(doc, [](ndjson_record &record)
+                                               {
+                    if (record.id == 2000)
+                    {
+                        throw std::runtime_error("stop");
+                    } });
+            }
+            catch (const std::runtime_error &e)
+            {
+                thrown = true;
+            }
+            assertTrue(thrown);
+        }
+    };
+#endif
+
+#if LAZY_JSON_MMAP
+    class MappedFileTest : public JsonTestCase
+    {
+    public:
+        MappedFileTest() : JsonTestCase("MappedFileTest") {}
+
+        void test()
+        {
+            setMemoryWatchpoint();
+            const char *path = "/tmp/lazyjson_mapped_file_test.json";
+            FILE *file = fopen(path, "wb");
+            assertTrue(file != nullptr);
+            fwrite(WEATHER_API_DATA, 1, strlen(WEATHER_API_DATA), file);
+            fclose(file);
+
+            {
+                extractor ex = extractor::from_file(path);
+                assertEqual(ex["main"]["humidity"].extract().asInt(), 77, " %i != %i \n");
+                assertEqual(ex["name"].extract().as<std::string>(), std::string("Oława"));
+
+                // copies share the mapping
+                extractor copy = ex;
+                copy.reset();
+                assertEqual(copy["cod"].extract().asInt(), 200, " %i != %i \n");
+
+                // cursors share the mapping of the document
+                cursor cur(document::from_file(path));
+                assertEqual(cur["cod"].extract().asInt(), 200, " %i != %i \n");
+            }
+
+            // the mapping is kept by the wrapper, the temporary extractor is gone before it's read
+            wrapper name = extractor::from_file(path)["name"].extract();
+            assertEqual(name.as<std::string>(), std::string("Oława"));
+            wrapper weather = extractor::from_file(path).extract(path_set({lazyjson::path("weather[0]")}), true)[0];
+            assertEqual(wrapper(weather.object()["main"]).as<std::string>(), std::string("Clouds"));
+            name = wrapper();
+            weather = wrapper();
+
+            file = fopen(path, "wb");
+            fclose(file);
+            // empty file is mapped as an empty json string
+            extractor empty = extractor::from_file(path, access_pattern::random);
+            assertThrow<std::runtime_error>([&]()
+                                            { empty.extract(); });
+            remove(path);
+
+            assertThrow<std::runtime_error>([&]()
+                                            { extractor::from_file(path); });
+            setMemoryWatchpoint();
+        }
+    };
+#endif
+
+#if LAZY_JSON_MMAP
+    class LargeOffsetTest : public JsonTestCase
+    {
+    public:
+        LargeOffsetTest() : JsonTestCase("LargeOffsetTest") {}
+
+        void test()
+        {
+            // positions past 2^31 don't fit in an int, only 64-bit hosts can address them
+            if (sizeof(size_t) < 8)
+            {
+                return;
+            }
+            setMemoryWatchpoint();
+            const char json[] = "{\"a\":1,\"b\":[2,{\"c\":\"d\"}],\"e\":3}";
+            const size_t start = (size_t(1) << 31) + 100;
+            const size_t end = start + sizeof(json) - 1;
+            // the address range is only reserved, only the pages holding the json are backed
+            char *base = static_cast<char *>(mmap(nullptr, end, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+            assertTrue(base != MAP_FAILED);
+            size_t page = size_t(sysconf(_SC_PAGESIZE));
+            size_t first = start / page * page;
+            assertEqual(mprotect(base + first, end - first, PROT_READ | PROT_WRITE), 0, " %i != %i \n");
+            memcpy(base + start, json, sizeof(json) - 1);
+
+            {
+                extractor ex(base, end);
+                ex.select(start, end);
+                assertEqual(ex["a"].extract().asInt(), 1, " %i != %i \n");
+                assertEqual(ex["b"][1]["c"].extract().as<std::string>(), std::string("d"));
+                // memoized offsets
+                assertEqual(ex["b"][1]["c"].extract().as<std::string>(), std::string("d"));
+                assertEqual(ex["e"].extract().asInt(), 3, " %i != %i \n");
+
+                ex["b"].cache();
+                assertEqual(ex.json(), std::string("[2,{\"c\":\"d\"}]"));
+                assertEqual(ex[0].extract().asInt(), 2, " %i != %i \n");
+                // the elements are parsed lazily from their positions
+                wrapper list = ex.extract();
+                assertEqual(wrapper(list.list()[0]).asInt(), 2, " %i != %i \n");
+                wrapper object = wrapper(list.list()[1]);
+                assertEqual(wrapper(object.object()["c"]).as<std::string>(), std::string("d"));
+                ex.pop();
+
+                std::vector<wrapper> values = ex.extract(path_set({path("e"), path("b[1].c")}));
+                assertEqual(values[0].asInt(), 3, " %i != %i \n");
+                assertEqual(values[1].as<std::string>(), std::string("d"));
+            }
+            munmap(base, end);
+            setMemoryWatchpoint();
+        }
+    };
+#endif
+
 /*  
 
 
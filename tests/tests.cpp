@@ -75,6 +75,54 @@ namespace tests
                 testBase(new TestNullPropagation()),
                 testBase(new TestThrowExeptionOnWrongType()),
                 testBase(new TestThrowExeptionOnValueTypeMismatch()),
+                testBase(new ScannerClassifyTest()),
+                testBase(new TokenAllocationTest()),
+                testBase(new SkipContainerTest()),
+                testBase(new EscapedStringTest()),
+                testBase(new NonNullTerminatedInputTest()),
+                testBase(new StreamingReaderTest()),
+                testBase(new NumberParsingTest()),
+                testBase(new PathQueryTest()),
+                testBase(new MultiPathTest()),
+                testBase(new CacheScopeTest()),
+                testBase(new MemoTest()),
+                testBase(new IterationTest()),
+                testBase(new LazyContainerIndexTest()),
+                testBase(new ArenaTest()),
+                testBase(new WrapperOwnershipTest()),
+                testBase(new CompactValueTest()),
+                testBase(new DocumentCursorTest()),
+                testBase(new MultiDocumentTest()),
+                testBase(new StructBindingTest()),
+                testBase(new PathLiteralTest()),
+                testBase(new ValidatorTest()),
+                testBase(new TrustedPolicyTest()),
+#if LAZY_JSON_THREADS
+                testBase(new ParallelParseTest()),
+                testBase(new NdjsonPipelineTest()),
+#endif
+#if LAZY_JSON_MMAP
+                testBase(new MappedFileTest()),
+                testBase(new LargeOffsetTest()),
+#endif
+
+                // benchmarks
+                testBase(new BenchmarkScannerThroughput()),
+                testBase(new BenchmarkCompiledPath()),
+                testBase(new BenchmarkMultiPath()),
+                testBase(new BenchmarkMemo()),
+                testBase(new BenchmarkIteration()),
+                testBase(new BenchmarkWrapperCopy()),
+                testBase(new BenchmarkStructBinding()),
+                testBase(new BenchmarkValidator()),
+                testBase(new BenchmarkTrustedPolicy()),
+#if LAZY_JSON_THREADS
+                testBase(new BenchmarkParallelParse()),
+                testBase(new BenchmarkNdjson()),
+#endif
+#if LAZY_JSON_MMAP
+                testBase(new BenchmarkMappedFile()),
+#endif
             };
 
             int failed = 0;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "testCases.h"
+#include "benchmarks.h"
 #include <memory>
 
 namespace tests